@@ -36,6 +36,7 @@
 #include "cpu/mmx.h"
 #include "cpu/paging.h"
 #include "cpu/registers.h"
+#include "cpu/string_bulk.h"
 #include "debugger/debugger.h"
 #include "hardware/memory.h"
 #include "hardware/pic.h"
@@ -14,6 +14,90 @@ extern uint32_t* lookupRMEAregd[256];
 #define SaveMd(off, val) mem_writed_inline(off, val)
 #define SaveMq(off, val) mem_writeq_inline(off, val)
 
+#if defined(DRC_USE_NEON_MMX)
+// The backend can generate NEON code for the common MMX instructions. The
+// MMX registers stay in memory, but instead of calling a helper (and going
+// through the lookup tables and the simde emulation) the destination is
+// loaded into vtemp1, the source operand into vtemp2, and the result is
+// stored back. Memory operands are still read by a helper so that page
+// faults are raised exactly like before.
+
+static uint64_t mmx_load_q(const PhysPt eaa)
+{
+	return LoadMq(eaa);
+}
+
+// Runs one or two NEON instructions on the operands of the current
+// Pq,Qq instruction
+static void dyn_mmx_neon(const uint32_t op1, const uint32_t op2 = 0)
+{
+	if (decode.modrm.mod < 3) {
+		dyn_fill_ea(FC_ADDR);
+		gen_call_function_R((void*)mmx_load_q, FC_ADDR);
+		gen_mmx_load_base(reg_mmx[0]);
+		gen_mov_reg_to_vreg(vtemp2, FC_RETOP);
+	} else {
+		gen_mmx_load_base(reg_mmx[0]);
+		gen_mmx_reg_to_vreg(vtemp2, decode.modrm.rm);
+	}
+	gen_mmx_reg_to_vreg(vtemp1, decode.modrm.reg);
+	cache_addd(op1);
+	if (op2) {
+		cache_addd(op2);
+	}
+	gen_mmx_reg_from_vreg(vtemp1, decode.modrm.reg);
+}
+
+// Shifts MMX register rm by an immediate, size is 1 for words, 2 for
+// dwords and 3 for the whole quadword. Counts beyond the element size
+// clear the register, or fill it with the sign for arithmetic shifts.
+static void dyn_mmx_neon_shift_imm(const uint8_t size, const uint8_t shift)
+{
+	const auto bits = 8u << size;
+	const auto rm   = decode.modrm.rm;
+
+	auto type = decode.modrm.reg;
+	if (size == 3) {
+		// like in mmx_psllq_psrlq, only one bit selects the direction
+		type = (type & 4) ? 0x06 : 0x02;
+	}
+
+	uint32_t op = 0;
+	switch (type) {
+	case 0x06: // PSLL
+		if (shift >= bits) {
+			op = MOVI_D_ZERO(vtemp1);
+		} else if (size == 3) {
+			op = SHL_D_IMM(vtemp1, vtemp1, shift);
+		} else {
+			op = SIMD_SHL_IMM(size, vtemp1, vtemp1, shift);
+		}
+		break;
+	case 0x02: // PSRL
+		if (shift >= bits) {
+			op = MOVI_D_ZERO(vtemp1);
+		} else if (size == 3) {
+			op = USHR_D_IMM(vtemp1, vtemp1, shift);
+		} else {
+			op = SIMD_USHR_IMM(size, vtemp1, vtemp1, shift);
+		}
+		break;
+	case 0x04: // PSRA
+		op = SIMD_SSHR_IMM(size, vtemp1, vtemp1, std::min<uint32_t>(shift, bits));
+		break;
+	default: return;
+	}
+	if (shift == 0) {
+		return;
+	}
+
+	gen_mmx_load_base(reg_mmx[0]);
+	gen_mmx_reg_to_vreg(vtemp1, rm);
+	cache_addd(op);
+	gen_mmx_reg_from_vreg(vtemp1, rm);
+}
+#endif
+
 static void mmx_movd_pqed(const Bitu rm, const PhysPt eaa = 0)
 {
 	auto rmrq = lookupRMregMM[rm];
@@ -31,6 +115,15 @@ static void mmx_movd_pqed(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_movd_pqed()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	if (decode.modrm.mod == 3) {
+		// the 32bit load clears the upper half
+		gen_mov_word_to_reg(FC_OP1, lookupRMEAregd[decode.modrm.val], true);
+		gen_mmx_load_base(reg_mmx[0]);
+		gen_mmx_reg_from_reg(FC_OP1, decode.modrm.reg);
+		return;
+	}
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -55,6 +148,14 @@ static void mmx_movd_edpq(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_movd_edpq()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	if (decode.modrm.mod == 3) {
+		gen_mmx_load_base(reg_mmx[0]);
+		gen_mmx_reg_to_reg(FC_OP1, decode.modrm.reg, false);
+		gen_mov_word_from_reg(FC_OP1, lookupRMEAregd[decode.modrm.val], true);
+		return;
+	}
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -79,6 +180,19 @@ static void mmx_movq_pqqq(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_movq_pqqq()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	if (decode.modrm.mod < 3) {
+		dyn_fill_ea(FC_ADDR);
+		gen_call_function_R((void*)mmx_load_q, FC_ADDR);
+		gen_mmx_load_base(reg_mmx[0]);
+		gen_mmx_reg_from_reg(FC_RETOP, decode.modrm.reg);
+	} else {
+		gen_mmx_load_base(reg_mmx[0]);
+		gen_mmx_reg_to_reg(FC_OP1, decode.modrm.rm, true);
+		gen_mmx_reg_from_reg(FC_OP1, decode.modrm.reg);
+	}
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -103,6 +217,14 @@ static void mmx_movq_qqpq(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_movq_qqpq()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	if (decode.modrm.mod == 3) {
+		gen_mmx_load_base(reg_mmx[0]);
+		gen_mmx_reg_to_reg(FC_OP1, decode.modrm.reg, true);
+		gen_mmx_reg_from_reg(FC_OP1, decode.modrm.rm);
+		return;
+	}
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -131,6 +253,10 @@ static void mmx_paddb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_paddb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ADD(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -159,6 +285,10 @@ static void mmx_paddw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_paddw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ADD(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -187,6 +317,10 @@ static void mmx_paddd(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_paddd()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ADD(2, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -215,6 +349,10 @@ static void mmx_paddsb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_paddsb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SQADD(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -243,6 +381,10 @@ static void mmx_paddsw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_paddsw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SQADD(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -271,6 +413,10 @@ static void mmx_paddusb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_paddusb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_UQADD(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -299,6 +445,10 @@ static void mmx_paddusw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_paddusw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_UQADD(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -327,6 +477,10 @@ static void mmx_psubb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_psubb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SUB(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -355,6 +509,10 @@ static void mmx_psubw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_psubw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SUB(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -383,6 +541,10 @@ static void mmx_psubsb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_psubsb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SQSUB(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -411,6 +573,10 @@ static void mmx_psubsw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_psubsw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SQSUB(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -439,6 +605,10 @@ static void mmx_psubusb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_psubusb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_UQSUB(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -467,6 +637,10 @@ static void mmx_psubusw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_psubusw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_UQSUB(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -495,6 +669,10 @@ static void mmx_psubd(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_psubd()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SUB(2, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -523,6 +701,11 @@ static void mmx_pmaddwd(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pmaddwd()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SMULL_4S(vtemp1, vtemp1, vtemp2),
+	             SIMD_ADDP_4S(vtemp1, vtemp1, vtemp1));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -551,6 +734,11 @@ static void mmx_pmulhw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pmulhw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_SMULL_4S(vtemp1, vtemp1, vtemp2),
+	             SIMD_SHRN_4H_16(vtemp1, vtemp1));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -579,6 +767,10 @@ static void mmx_pmullw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pmullw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_MUL(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -607,6 +799,11 @@ static void mmx_packuswb(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_packuswb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_INS_D1(vtemp1, vtemp2),
+	             SIMD_SQXTUN(0, vtemp1, vtemp1));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -647,6 +844,10 @@ static void dyn_mmx_psllw_psrlw_psraw()
 {
 	dyn_get_modrm();
 	const auto shift = decode_fetchb();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon_shift_imm(1, shift);
+	return;
+#endif
 
 	gen_call_function_II((void*)mmx_psllw_psrlw_psraw, decode.modrm.val, shift);
 }
@@ -682,6 +883,10 @@ static void dyn_mmx_pslld_psrld_psrad()
 {
 	dyn_get_modrm();
 	const auto shift = decode_fetchb();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon_shift_imm(2, shift);
+	return;
+#endif
 
 	gen_call_function_II((void*)mmx_pslld_psrld_psrad, decode.modrm.val, shift);
 }
@@ -793,6 +998,10 @@ static void mmx_pcmpeqb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pcmpeqb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_CMEQ(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -822,6 +1031,10 @@ static void mmx_pcmpeqw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pcmpeqw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_CMEQ(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -851,6 +1064,10 @@ static void mmx_pcmpeqd(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pcmpeqd()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_CMEQ(2, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -880,6 +1097,10 @@ static void mmx_pcmpgtb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pcmpgtb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_CMGT(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -909,6 +1130,10 @@ static void mmx_pcmpgtw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pcmpgtw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_CMGT(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -938,6 +1163,10 @@ static void mmx_pcmpgtd(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_pcmpgtd()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_CMGT(2, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -967,6 +1196,11 @@ static void mmx_packsswb(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_packsswb()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_INS_D1(vtemp1, vtemp2),
+	             SIMD_SQXTN(0, vtemp1, vtemp1));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -996,6 +1230,11 @@ static void mmx_packssdw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_packssdw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_INS_D1(vtemp1, vtemp2),
+	             SIMD_SQXTN(1, vtemp1, vtemp1));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -1025,6 +1264,10 @@ static void mmx_punpckhbw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_punpckhbw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ZIP2(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -1054,6 +1297,10 @@ static void mmx_punpcklbw(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_punpcklbw()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ZIP1(0, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -1083,6 +1330,10 @@ static void mmx_punpckhwd(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_punpckhwd()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ZIP2(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -1112,6 +1363,10 @@ static void mmx_punpcklwd(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_punpcklwd()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ZIP1(1, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -1141,6 +1396,10 @@ static void mmx_punpckldq(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_punpckldq()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ZIP1(2, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -1170,6 +1429,10 @@ static void mmx_punpckhdq(const Bitu rm, const PhysPt eaa)
 static void dyn_mmx_punpckhdq()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ZIP2(2, vtemp1, vtemp1, vtemp2));
+	return;
+#endif
 
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
@@ -1286,6 +1549,10 @@ static void dyn_mmx_psllq_psrlq()
 {
 	dyn_get_modrm();
 	const uint8_t shift = decode_fetchb();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon_shift_imm(3, shift);
+	return;
+#endif
 
 	gen_call_function_II((void*)mmx_psllq_psrlq, decode.modrm.val, shift);
 }
@@ -1368,6 +1635,11 @@ static void mmx_por(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_por()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_ORR(vtemp1, vtemp1, vtemp2));
+	return;
+#endif
+
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_por, decode.modrm.val, FC_ADDR);
@@ -1396,6 +1668,11 @@ static void mmx_pxor(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_pxor()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_EOR(vtemp1, vtemp1, vtemp2));
+	return;
+#endif
+
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_pxor, decode.modrm.val, FC_ADDR);
@@ -1424,6 +1701,11 @@ static void mmx_pand(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_pand()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_AND(vtemp1, vtemp1, vtemp2));
+	return;
+#endif
+
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_pand, decode.modrm.val, FC_ADDR);
@@ -1452,6 +1734,11 @@ static void mmx_pandn(const Bitu rm, const PhysPt eaa = 0)
 static void dyn_mmx_pandn()
 {
 	dyn_get_modrm();
+#if defined(DRC_USE_NEON_MMX)
+	dyn_mmx_neon(SIMD_BIC(vtemp1, vtemp2, vtemp1));
+	return;
+#endif
+
 	if (decode.modrm.mod < 3) {
 		dyn_fill_ea(FC_ADDR);
 		gen_call_function_IR((void*)mmx_pandn, decode.modrm.val, FC_ADDR);
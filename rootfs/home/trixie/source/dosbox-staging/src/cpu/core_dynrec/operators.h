@@ -1643,6 +1643,14 @@ static uint16_t DRC_CALL_CONV dynrec_movsb_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t si_index = reg_si;
+		uint32_t di_index = reg_di;
+		string_movs_forward<uint8_t>(si_base, si_index, di_base, di_index, 0xffff, count);
+		reg_si = static_cast<uint16_t>(si_index);
+		reg_di = static_cast<uint16_t>(di_index);
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_di,mem_readb(si_base+reg_si));
 		reg_si+=add_index;
@@ -1661,6 +1669,10 @@ static uint32_t DRC_CALL_CONV dynrec_movsb_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_movs_forward<uint8_t>(si_base, reg_esi, di_base, reg_edi, 0xffffffff, count);
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_edi,mem_readb(si_base+reg_esi));
 		reg_esi+=add_index;
@@ -1679,6 +1691,14 @@ static uint16_t DRC_CALL_CONV dynrec_movsw_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t si_index = reg_si;
+		uint32_t di_index = reg_di;
+		string_movs_forward<uint16_t>(si_base, si_index, di_base, di_index, 0xffff, count);
+		reg_si = static_cast<uint16_t>(si_index);
+		reg_di = static_cast<uint16_t>(di_index);
+		return count_left;
+	}
 	add_index<<=1;
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_di,mem_readw(si_base+reg_si));
@@ -1698,6 +1718,10 @@ static uint32_t DRC_CALL_CONV dynrec_movsw_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_movs_forward<uint16_t>(si_base, reg_esi, di_base, reg_edi, 0xffffffff, count);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 1);
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_edi,mem_readw(si_base+reg_esi));
@@ -1717,6 +1741,14 @@ static uint16_t DRC_CALL_CONV dynrec_movsd_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t si_index = reg_si;
+		uint32_t di_index = reg_di;
+		string_movs_forward<uint32_t>(si_base, si_index, di_base, di_index, 0xffff, count);
+		reg_si = static_cast<uint16_t>(si_index);
+		reg_di = static_cast<uint16_t>(di_index);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 2);
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_di,mem_readd(si_base+reg_si));
@@ -1736,6 +1768,10 @@ static uint32_t DRC_CALL_CONV dynrec_movsd_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_movs_forward<uint32_t>(si_base, reg_esi, di_base, reg_edi, 0xffffffff, count);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 2);
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_edi,mem_readd(si_base+reg_esi));
@@ -1756,6 +1792,12 @@ static uint16_t DRC_CALL_CONV dynrec_lodsb_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t si_index = reg_si;
+		string_lods_forward<uint8_t>(si_base, si_index, 0xffff, count, reg_al);
+		reg_si = static_cast<uint16_t>(si_index);
+		return count_left;
+	}
 	for (;count>0;count--) {
 		reg_al=mem_readb(si_base+reg_si);
 		reg_si+=add_index;
@@ -1773,6 +1815,10 @@ static uint32_t DRC_CALL_CONV dynrec_lodsb_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_lods_forward<uint8_t>(si_base, reg_esi, 0xffffffff, count, reg_al);
+		return count_left;
+	}
 	for (;count>0;count--) {
 		reg_al=mem_readb(si_base+reg_esi);
 		reg_esi+=add_index;
@@ -1790,6 +1836,12 @@ static uint16_t DRC_CALL_CONV dynrec_lodsw_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t si_index = reg_si;
+		string_lods_forward<uint16_t>(si_base, si_index, 0xffff, count, reg_ax);
+		reg_si = static_cast<uint16_t>(si_index);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 1);
 	for (;count>0;count--) {
 		reg_ax=mem_readw(si_base+reg_si);
@@ -1808,6 +1860,10 @@ static uint32_t DRC_CALL_CONV dynrec_lodsw_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_lods_forward<uint16_t>(si_base, reg_esi, 0xffffffff, count, reg_ax);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 1);
 	for (;count>0;count--) {
 		reg_ax=mem_readw(si_base+reg_esi);
@@ -1826,6 +1882,12 @@ static uint16_t DRC_CALL_CONV dynrec_lodsd_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t si_index = reg_si;
+		string_lods_forward<uint32_t>(si_base, si_index, 0xffff, count, reg_eax);
+		reg_si = static_cast<uint16_t>(si_index);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 2);
 	for (;count>0;count--) {
 		reg_eax=mem_readd(si_base+reg_si);
@@ -1844,6 +1906,10 @@ static uint32_t DRC_CALL_CONV dynrec_lodsd_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_lods_forward<uint32_t>(si_base, reg_esi, 0xffffffff, count, reg_eax);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 2);
 	for (;count>0;count--) {
 		reg_eax=mem_readd(si_base+reg_esi);
@@ -1863,6 +1929,12 @@ static uint16_t DRC_CALL_CONV dynrec_stosb_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t di_index = reg_di;
+		string_stos_forward<uint8_t>(di_base, di_index, 0xffff, count, reg_al);
+		reg_di = static_cast<uint16_t>(di_index);
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_di,reg_al);
 		reg_di+=add_index;
@@ -1880,6 +1952,10 @@ static uint32_t DRC_CALL_CONV dynrec_stosb_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_stos_forward<uint8_t>(di_base, reg_edi, 0xffffffff, count, reg_al);
+		return count_left;
+	}
 	for (;count>0;count--) {
 		mem_writeb(di_base+reg_edi,reg_al);
 		reg_edi+=add_index;
@@ -1897,6 +1973,12 @@ static uint16_t DRC_CALL_CONV dynrec_stosw_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t di_index = reg_di;
+		string_stos_forward<uint16_t>(di_base, di_index, 0xffff, count, reg_ax);
+		reg_di = static_cast<uint16_t>(di_index);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 1);
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_di,reg_ax);
@@ -1915,6 +1997,10 @@ static uint32_t DRC_CALL_CONV dynrec_stosw_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_stos_forward<uint16_t>(di_base, reg_edi, 0xffffffff, count, reg_ax);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 1);
 	for (;count>0;count--) {
 		mem_writew(di_base+reg_edi,reg_ax);
@@ -1933,6 +2019,12 @@ static uint16_t DRC_CALL_CONV dynrec_stosd_word(uint16_t count,int16_t add_index
 		count=(uint16_t)CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		uint32_t di_index = reg_di;
+		string_stos_forward<uint32_t>(di_base, di_index, 0xffff, count, reg_eax);
+		reg_di = static_cast<uint16_t>(di_index);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 2);
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_di,reg_eax);
@@ -1951,6 +2043,10 @@ static uint32_t DRC_CALL_CONV dynrec_stosd_dword(uint32_t count,int32_t add_inde
 		count=CPU_Cycles;
 		CPU_Cycles=0;
 	}
+	if (add_index > 0 && count > 1) {
+		string_stos_forward<uint32_t>(di_base, reg_edi, 0xffffffff, count, reg_eax);
+		return count_left;
+	}
 	add_index = left_shift_signed(add_index, 2);
 	for (;count>0;count--) {
 		mem_writed(di_base+reg_edi,reg_eax);
@@ -23,6 +23,9 @@
 // use FC_SEGS_ADDR to hold the address of "Segs" and to access it using FC_SEGS_ADDR
 #define DRC_USE_SEGS_ADDR
 
+// generate NEON code for the common MMX instructions instead of calling helpers
+#define DRC_USE_NEON_MMX
+
 // register mapping
 typedef uint8_t HostReg;
 
@@ -174,6 +177,10 @@ typedef uint8_t HostReg;
 // used to hold the address of "core_dynrec.readdata" - filled in function gen_run_code
 #define readdata_addr HOST_r22
 
+// vector registers used for MMX instructions (not preserved across calls)
+#define vtemp1 0
+#define vtemp2 1
+
 
 // instruction encodings
 
@@ -319,6 +326,71 @@ typedef uint8_t HostReg;
 // ubfm dst, src, #rimm, #simm		@	0 <= rimm < 64, 0 <= simm < 64
 #define UBFM64(dst, src, rimm, simm) (0xd3400000 + (dst) + ((src) << 5) + ((rimm) << 16) + ((simm) << 10) )
 
+// advanced simd (64bit vectors)
+// size: 0 = 8bit elements, 1 = 16bit elements, 2 = 32bit elements
+// ldr dreg, [addr, #imm]		@	0 <= imm < 32768	imm % 8 = 0
+#define LDR_D_IMM(reg, addr, imm) (0xfd400000 + (reg) + ((addr) << 5) + ((imm) << 7) )
+// str dreg, [addr, #imm]		@	0 <= imm < 32768	imm % 8 = 0
+#define STR_D_IMM(reg, addr, imm) (0xfd000000 + (reg) + ((addr) << 5) + ((imm) << 7) )
+// fmov dst, xsrc
+#define FMOV_D_X(dst, src) (0x9e670000 + (dst) + ((src) << 5) )
+// movi dst, #0
+#define MOVI_D_ZERO(dst) (0x2f00e400 + (dst) )
+// three registers of the same element size
+#define SIMD_3SAME(u, size, opcode, dst, src1, src2) (0x0e200400 + ((u) << 29) + ((size) << 22) + ((src2) << 16) + ((opcode) << 11) + ((src1) << 5) + (dst) )
+// add dst, src1, src2
+#define SIMD_ADD(size, dst, src1, src2) SIMD_3SAME(0, size, 0x10, dst, src1, src2)
+// sub dst, src1, src2
+#define SIMD_SUB(size, dst, src1, src2) SIMD_3SAME(1, size, 0x10, dst, src1, src2)
+// sqadd dst, src1, src2
+#define SIMD_SQADD(size, dst, src1, src2) SIMD_3SAME(0, size, 0x01, dst, src1, src2)
+// uqadd dst, src1, src2
+#define SIMD_UQADD(size, dst, src1, src2) SIMD_3SAME(1, size, 0x01, dst, src1, src2)
+// sqsub dst, src1, src2
+#define SIMD_SQSUB(size, dst, src1, src2) SIMD_3SAME(0, size, 0x05, dst, src1, src2)
+// uqsub dst, src1, src2
+#define SIMD_UQSUB(size, dst, src1, src2) SIMD_3SAME(1, size, 0x05, dst, src1, src2)
+// cmgt dst, src1, src2
+#define SIMD_CMGT(size, dst, src1, src2) SIMD_3SAME(0, size, 0x06, dst, src1, src2)
+// cmeq dst, src1, src2
+#define SIMD_CMEQ(size, dst, src1, src2) SIMD_3SAME(1, size, 0x11, dst, src1, src2)
+// mul dst, src1, src2
+#define SIMD_MUL(size, dst, src1, src2) SIMD_3SAME(0, size, 0x13, dst, src1, src2)
+// and dst, src1, src2
+#define SIMD_AND(dst, src1, src2) SIMD_3SAME(0, 0, 0x03, dst, src1, src2)
+// bic dst, src1, src2
+#define SIMD_BIC(dst, src1, src2) SIMD_3SAME(0, 1, 0x03, dst, src1, src2)
+// orr dst, src1, src2
+#define SIMD_ORR(dst, src1, src2) SIMD_3SAME(0, 2, 0x03, dst, src1, src2)
+// eor dst, src1, src2
+#define SIMD_EOR(dst, src1, src2) SIMD_3SAME(1, 0, 0x03, dst, src1, src2)
+// smull dst.4s, src1.4h, src2.4h
+#define SIMD_SMULL_4S(dst, src1, src2) (0x0e60c000 + (dst) + ((src1) << 5) + ((src2) << 16) )
+// addp dst.4s, src1.4s, src2.4s
+#define SIMD_ADDP_4S(dst, src1, src2) (0x4ea0bc00 + (dst) + ((src1) << 5) + ((src2) << 16) )
+// shrn dst.4h, src.4s, #16
+#define SIMD_SHRN_4H_16(dst, src) (0x0f108400 + (dst) + ((src) << 5) )
+// mov dst.d[1], src.d[0]
+#define SIMD_INS_D1(dst, src) (0x6e180400 + (dst) + ((src) << 5) )
+// sqxtn dst, src		@	size of the destination elements
+#define SIMD_SQXTN(size, dst, src) (0x0e214800 + ((size) << 22) + (dst) + ((src) << 5) )
+// sqxtun dst, src		@	size of the destination elements
+#define SIMD_SQXTUN(size, dst, src) (0x2e212800 + ((size) << 22) + (dst) + ((src) << 5) )
+// zip1 dst, src1, src2
+#define SIMD_ZIP1(size, dst, src1, src2) (0x0e003800 + ((size) << 22) + (dst) + ((src1) << 5) + ((src2) << 16) )
+// zip2 dst, src1, src2
+#define SIMD_ZIP2(size, dst, src1, src2) (0x0e007800 + ((size) << 22) + (dst) + ((src1) << 5) + ((src2) << 16) )
+// shl dst, src, #imm		@	0 <= imm < element size
+#define SIMD_SHL_IMM(size, dst, src, imm) (0x0f005400 + (((8 << (size)) + (imm)) << 16) + (dst) + ((src) << 5) )
+// ushr dst, src, #imm		@	1 <= imm <= element size
+#define SIMD_USHR_IMM(size, dst, src, imm) (0x2f000400 + (((16 << (size)) - (imm)) << 16) + (dst) + ((src) << 5) )
+// sshr dst, src, #imm		@	1 <= imm <= element size
+#define SIMD_SSHR_IMM(size, dst, src, imm) (0x0f000400 + (((16 << (size)) - (imm)) << 16) + (dst) + ((src) << 5) )
+// shl ddst, dsrc, #imm		@	0 <= imm < 64
+#define SHL_D_IMM(dst, src, imm) (0x5f405400 + ((imm) << 16) + (dst) + ((src) << 5) )
+// ushr ddst, dsrc, #imm		@	1 <= imm <= 64
+#define USHR_D_IMM(dst, src, imm) (0x7f000400 + ((128 - (imm)) << 16) + (dst) + ((src) << 5) )
+
 
 // move a full register from reg_src to reg_dst
 static void gen_mov_regs(HostReg reg_dst,HostReg reg_src) {
@@ -1218,3 +1290,41 @@ static void gen_mov_regbyte_from_reg_low(HostReg src_reg,Bitu index) {
 }
 
 #endif
+
+#ifdef DRC_USE_NEON_MMX
+// the MMX registers are an array of 64bit values, temp1 holds its address
+
+// load the address of the MMX register array into temp1
+static void gen_mmx_load_base(void* base) {
+	gen_mov_qword_to_reg_imm(temp1, (uint64_t)base);
+}
+
+// move MMX register index into vector register vreg
+static void gen_mmx_reg_to_vreg(HostReg vreg,Bitu index) {
+	cache_addd( LDR_D_IMM(vreg, temp1, index * 8) );        // ldr vreg, [temp1, #(index * 8)]
+}
+
+// move vector register vreg into MMX register index
+static void gen_mmx_reg_from_vreg(HostReg vreg,Bitu index) {
+	cache_addd( STR_D_IMM(vreg, temp1, index * 8) );        // str vreg, [temp1, #(index * 8)]
+}
+
+// move the lower 32bit (zero-extended) or all 64bit (qword==true) of MMX register index into dest_reg
+static void gen_mmx_reg_to_reg(HostReg dest_reg,Bitu index,bool qword) {
+	if (qword) {
+		cache_addd( LDR64_IMM(dest_reg, temp1, index * 8) );    // ldr dest_reg, [temp1, #(index * 8)]
+	} else {
+		cache_addd( LDR_IMM(dest_reg, temp1, index * 8) );      // ldr dest_reg, [temp1, #(index * 8)]
+	}
+}
+
+// move all 64bit of src_reg into MMX register index
+static void gen_mmx_reg_from_reg(HostReg src_reg,Bitu index) {
+	cache_addd( STR64_IMM(src_reg, temp1, index * 8) );     // str src_reg, [temp1, #(index * 8)]
+}
+
+// move all 64bit of src_reg into vector register vreg
+static void gen_mov_reg_to_vreg(HostReg vreg,HostReg src_reg) {
+	cache_addd( FMOV_D_X(vreg, src_reg) );      // fmov vreg, src_reg
+}
+#endif
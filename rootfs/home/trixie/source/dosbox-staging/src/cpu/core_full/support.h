@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "cpu/string_bulk.h"
 #include "cpu/string_ops.h"
 
 enum {
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText:  2002-2021 The DOSBox Team
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "cpu/string_bulk.h"
 #include "cpu/string_ops.h"
 
 #define LoadD(_BLAH) _BLAH
@@ -77,12 +78,22 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_STOSB:
+		if (add_index > 0 && count > 1) {
+			string_stos_forward<uint8_t>(di_base, di_index, add_mask, count, reg_al);
+			count = 0;
+			break;
+		}
 		for (;count>0;count--) {
 			SaveMb(di_base+di_index,reg_al);
 			di_index=(di_index+add_index) & add_mask;
 		}
 		break;
 	case R_STOSW:
+		if (add_index > 0 && count > 1) {
+			string_stos_forward<uint16_t>(di_base, di_index, add_mask, count, reg_ax);
+			count = 0;
+			break;
+		}
 		add_index *= 2;
 		for (;count>0;count--) {
 			SaveMw(di_base+di_index,reg_ax);
@@ -90,6 +101,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_STOSD:
+		if (add_index > 0 && count > 1) {
+			string_stos_forward<uint32_t>(di_base, di_index, add_mask, count, reg_eax);
+			count = 0;
+			break;
+		}
 		add_index *= 4;
 		for (;count>0;count--) {
 			SaveMd(di_base+di_index,reg_eax);
@@ -97,6 +113,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_MOVSB:
+		if (add_index > 0 && count > 1) {
+			string_movs_forward<uint8_t>(si_base, si_index, di_base, di_index, add_mask, count);
+			count = 0;
+			break;
+		}
 		for (;count>0;count--) {
 			SaveMb(di_base+di_index,LoadMb(si_base+si_index));
 			di_index=(di_index+add_index) & add_mask;
@@ -104,6 +125,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_MOVSW:
+		if (add_index > 0 && count > 1) {
+			string_movs_forward<uint16_t>(si_base, si_index, di_base, di_index, add_mask, count);
+			count = 0;
+			break;
+		}
 		add_index *= 2;
 		for (;count>0;count--) {
 			SaveMw(di_base+di_index,LoadMw(si_base+si_index));
@@ -112,6 +138,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_MOVSD:
+		if (add_index > 0 && count > 1) {
+			string_movs_forward<uint32_t>(si_base, si_index, di_base, di_index, add_mask, count);
+			count = 0;
+			break;
+		}
 		add_index *= 4;
 		for (;count>0;count--) {
 			SaveMd(di_base+di_index,LoadMd(si_base+si_index));
@@ -120,12 +151,22 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_LODSB:
+		if (add_index > 0 && count > 1) {
+			string_lods_forward<uint8_t>(si_base, si_index, add_mask, count, reg_al);
+			count = 0;
+			break;
+		}
 		for (;count>0;count--) {
 			reg_al=LoadMb(si_base+si_index);
 			si_index=(si_index+add_index) & add_mask;
 		}
 		break;
 	case R_LODSW:
+		if (add_index > 0 && count > 1) {
+			string_lods_forward<uint16_t>(si_base, si_index, add_mask, count, reg_ax);
+			count = 0;
+			break;
+		}
 		add_index *= 2;
 		for (;count>0;count--) {
 			reg_ax=LoadMw(si_base+si_index);
@@ -133,6 +174,11 @@ static void DoString(STRING_OP type) {
 		}
 		break;
 	case R_LODSD:
+		if (add_index > 0 && count > 1) {
+			string_lods_forward<uint32_t>(si_base, si_index, add_mask, count, reg_eax);
+			count = 0;
+			break;
+		}
 		add_index *= 4;
 		for (;count>0;count--) {
 			reg_eax=LoadMd(si_base+si_index);
@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_STRING_BULK_H
+#define DOSBOX_STRING_BULK_H
+
+// Bulk paths for REP MOVS, STOS and LODS in the forward direction (DF=0),
+// shared by the interpreter and dynrec cores.
+//
+// The callers handle the REP count and cycle accounting as before, these
+// helpers only do the transfer. As long as the source and destination lie in
+// pages the TLB maps directly to host memory, the elements up to the next page
+// boundary (or index wrap) are moved with a single memmove/fill. Anything else
+// (page handlers such as VGA memory or pages holding dynamically compiled
+// code, elements straddling a page boundary) goes through the regular memory
+// functions one element at a time until the next page boundary, where the
+// bulk path is attempted again.
+
+#include "dosbox.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "cpu/paging.h"
+#include "hardware/memory.h"
+
+#if C_DEBUGGER && C_HEAVY_DEBUGGER
+// Memory breakpoints need to see every access
+constexpr bool StringBulkEnabled = false;
+#else
+constexpr bool StringBulkEnabled = true;
+#endif
+
+template <typename T>
+static inline T string_load(const PhysPt address)
+{
+	if constexpr (sizeof(T) == 1) {
+		return mem_readb(address);
+	} else if constexpr (sizeof(T) == 2) {
+		return mem_readw(address);
+	} else {
+		return mem_readd(address);
+	}
+}
+
+template <typename T>
+static inline void string_store(const PhysPt address, const T val)
+{
+	if constexpr (sizeof(T) == 1) {
+		mem_writeb(address, val);
+	} else if constexpr (sizeof(T) == 2) {
+		mem_writew(address, val);
+	} else {
+		mem_writed(address, val);
+	}
+}
+
+// Elements that fit between the index and both the end of its page and the
+// point where the index wraps around
+template <typename T>
+static inline uint32_t string_span(const PhysPt base, const uint32_t index,
+                                   const uint32_t add_mask)
+{
+	const auto to_page_end = DosPageSize - ((base + index) & (DosPageSize - 1));
+	const auto to_wrap = static_cast<uint64_t>(add_mask) - index + 1;
+	return static_cast<uint32_t>(
+	        std::min<uint64_t>(to_page_end, to_wrap) / sizeof(T));
+}
+
+// Elements to do one at a time before retrying the bulk path, at least one
+// so an element straddling a page boundary gets done
+static inline uint32_t string_slow_span(const uint32_t span, const uint32_t count)
+{
+	return std::clamp<uint32_t>(span, 1, count);
+}
+
+template <typename T>
+static inline void string_advance(uint32_t& index, const uint32_t num,
+                                  const uint32_t add_mask)
+{
+	index = (index + num * static_cast<uint32_t>(sizeof(T))) & add_mask;
+}
+
+template <typename T>
+static inline void string_movs_forward(const PhysPt si_base, uint32_t& si_index,
+                                       const PhysPt di_base, uint32_t& di_index,
+                                       const uint32_t add_mask, uint32_t count)
+{
+	while (count > 0) {
+		auto num = std::min({count,
+		                     string_span<T>(si_base, si_index, add_mask),
+		                     string_span<T>(di_base, di_index, add_mask)});
+
+		const auto src_tlb = get_tlb_read(si_base + si_index);
+		const auto dst_tlb = get_tlb_write(di_base + di_index);
+		if (StringBulkEnabled && num > 0 && src_tlb && dst_tlb) {
+			const auto src = src_tlb + (si_base + si_index);
+			const auto dst = dst_tlb + (di_base + di_index);
+
+			// Copying forward element by element into a destination
+			// that starts inside the source repeats the bytes in
+			// between, so copy at most that distance at a time.
+			const auto distance = reinterpret_cast<uintptr_t>(dst) -
+			                      reinterpret_cast<uintptr_t>(src);
+			if (dst > src && distance < num * sizeof(T)) {
+				num = static_cast<uint32_t>(distance / sizeof(T));
+			}
+			if (num > 0) {
+				std::memmove(dst, src, num * sizeof(T));
+				string_advance<T>(si_index, num, add_mask);
+				string_advance<T>(di_index, num, add_mask);
+				count -= num;
+				continue;
+			}
+		}
+
+		for (num = string_slow_span(num, count); num > 0; --num, --count) {
+			string_store<T>(di_base + di_index,
+			                string_load<T>(si_base + si_index));
+			string_advance<T>(si_index, 1, add_mask);
+			string_advance<T>(di_index, 1, add_mask);
+		}
+	}
+}
+
+template <typename T>
+static inline void string_stos_forward(const PhysPt di_base, uint32_t& di_index,
+                                       const uint32_t add_mask, uint32_t count,
+                                       const T val)
+{
+	while (count > 0) {
+		auto num = std::min(count, string_span<T>(di_base, di_index, add_mask));
+
+		const auto dst_tlb = get_tlb_write(di_base + di_index);
+		if (StringBulkEnabled && num > 0 && dst_tlb) {
+			const auto dst = dst_tlb + (di_base + di_index);
+			if constexpr (sizeof(T) == 1) {
+				std::memset(dst, val, num);
+			} else {
+				for (uint32_t i = 0; i < num; ++i) {
+					if constexpr (sizeof(T) == 2) {
+						host_writew(dst + i * sizeof(T), val);
+					} else {
+						host_writed(dst + i * sizeof(T), val);
+					}
+				}
+			}
+			string_advance<T>(di_index, num, add_mask);
+			count -= num;
+			continue;
+		}
+
+		for (num = string_slow_span(num, count); num > 0; --num, --count) {
+			string_store<T>(di_base + di_index, val);
+			string_advance<T>(di_index, 1, add_mask);
+		}
+	}
+}
+
+// Only the last element loaded is visible, so whole page chunks are skipped
+template <typename T>
+static inline void string_lods_forward(const PhysPt si_base, uint32_t& si_index,
+                                       const uint32_t add_mask, uint32_t count,
+                                       T& val)
+{
+	while (count > 0) {
+		auto num = std::min(count, string_span<T>(si_base, si_index, add_mask));
+
+		const auto src_tlb = get_tlb_read(si_base + si_index);
+		if (StringBulkEnabled && num > 0 && src_tlb) {
+			const auto last = src_tlb + (si_base + si_index) +
+			                  (num - 1) * sizeof(T);
+			if constexpr (sizeof(T) == 1) {
+				val = host_readb(last);
+			} else if constexpr (sizeof(T) == 2) {
+				val = host_readw(last);
+			} else {
+				val = host_readd(last);
+			}
+			string_advance<T>(si_index, num, add_mask);
+			count -= num;
+			continue;
+		}
+
+		for (num = string_slow_span(num, count); num > 0; --num, --count) {
+			val = string_load<T>(si_base + si_index);
+			string_advance<T>(si_index, 1, add_mask);
+		}
+	}
+}
+
+#endif // DOSBOX_STRING_BULK_H
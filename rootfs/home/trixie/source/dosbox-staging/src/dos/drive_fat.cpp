@@ -3,6 +3,8 @@
 
 #include "dos/drives.h"
 
+#include <algorithm>
+#include <bit>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -35,6 +37,16 @@ public:
 	void Close() override;
 	uint16_t GetInformation(void) override;
 	bool IsOnReadOnlyMedium() const override;
+
+private:
+	uint32_t getSectorAt(uint32_t bytePos, uint32_t* contiguousSectors);
+	uint32_t allocateAt(uint32_t bytePos, uint32_t* contiguousSectors);
+
+	// Sector runs of the cluster chain, built lazily from the drive's FAT
+	std::vector<FatExtent> extents = {};
+	uint32_t extents_cluster    = 0;
+	uint32_t extents_generation = 0;
+
 public:
 	std::shared_ptr<fatDrive> myDrive   = nullptr;
 	uint32_t firstCluster               = 0;
@@ -89,51 +101,53 @@ bool fatFile::Read(uint8_t * data, uint16_t *size) {
 		DOS_SetError(DOSERR_ACCESS_DENIED);
 		return false;
 	}
-	uint16_t sizedec, sizecount;
 	if(seekpos >= filelength) {
 		*size = 0;
 		return true;
 	}
 
-	if (!loadedSector) {
-		currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
-		if(currentSector == 0) {
-			/* EOC reached before EOF */
-			*size = 0;
-			loadedSector = false;
-			return true;
-		}
-		curSectOff = seekpos % myDrive->getSectorSize();
-		myDrive->readSector(currentSector, sectorBuffer);
-		loadedSector = true;
-	}
+	const uint32_t sector_size = myDrive->getSectorSize();
+	uint32_t remaining = std::min<uint32_t>(*size, filelength - seekpos);
+	uint32_t sizecount = 0;
 
-	sizedec = *size;
-	sizecount = 0;
-	while(sizedec != 0) {
-		if(seekpos >= filelength) {
-			*size = sizecount;
-			return true; 
-		}
-		data[sizecount++] = sectorBuffer[curSectOff++];
-		seekpos++;
-		if(curSectOff >= myDrive->getSectorSize()) {
-			currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
-			if(currentSector == 0) {
+	while (remaining != 0) {
+		if (!loadedSector) {
+			uint32_t contiguous = 0;
+			currentSector = getSectorAt(seekpos, &contiguous);
+			if (currentSector == 0) {
 				/* EOC reached before EOF */
 				//LOG_MSG("EOC reached before EOF, seekpos %d, filelen %d", seekpos, filelength);
-				*size = sizecount;
-				loadedSector = false;
-				return true;
+				break;
+			}
+			curSectOff = seekpos % sector_size;
+
+			/* Whole sectors go straight into the caller's buffer, as
+			 * many per disk access as the cluster chain allows */
+			const uint32_t whole_sectors = std::min(remaining / sector_size, contiguous);
+			if (curSectOff == 0 && whole_sectors != 0) {
+				const uint32_t bytes = whole_sectors * sector_size;
+				myDrive->readSectors(currentSector, whole_sectors, data + sizecount);
+				sizecount += bytes;
+				seekpos += bytes;
+				remaining -= bytes;
+				continue;
 			}
-			curSectOff = 0;
 			myDrive->readSector(currentSector, sectorBuffer);
 			loadedSector = true;
-			//LOG_MSG("Reading absolute sector at %d for seekpos %d", currentSector, seekpos);
 		}
-		--sizedec;
+
+		const uint32_t span = std::min(remaining, sector_size - curSectOff);
+		memcpy(data + sizecount, sectorBuffer + curSectOff, span);
+		sizecount += span;
+		seekpos += span;
+		curSectOff += span;
+		remaining -= span;
+		if (curSectOff >= sector_size) {
+			/* The next sector is fetched when it's needed */
+			loadedSector = false;
+		}
 	}
-	*size =sizecount;
+	*size = static_cast<uint16_t>(sizecount);
 	return true;
 }
 
@@ -149,9 +163,10 @@ bool fatFile::Write(uint8_t * data, uint16_t *size) {
 	assert(!IsOnReadOnlyMedium());
 
 	direntry tmpentry;
-	uint16_t sizedec, sizecount;
-	sizedec = *size;
-	sizecount = 0;
+	const uint32_t sector_size = myDrive->getSectorSize();
+	uint32_t remaining = *size;
+	uint32_t sizecount = 0;
+	bool dirty = false;
 
 	set_archive_on_close = true;
 
@@ -183,51 +198,59 @@ bool fatFile::Write(uint8_t * data, uint16_t *size) {
 		if(*size == 0) goto finalizeWrite;
 	}
 
-	while(sizedec != 0) {
-		/* Increase filesize if necessary */
-		if(seekpos >= filelength) {
-			if(filelength == 0) {
-				firstCluster = myDrive->getFirstFreeClust();
-				if(firstCluster == 0) goto finalizeWrite; // out of space
-				myDrive->allocateCluster(firstCluster, 0);
-				currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
-				myDrive->readSector(currentSector, sectorBuffer);
-				loadedSector = true;
-			}
-			if (!loadedSector) {
-				currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
-				if(currentSector == 0) {
-					/* EOC reached before EOF - try to increase file allocation */
-					myDrive->appendCluster(firstCluster);
-					/* Try getting sector again */
-					currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
-					if(currentSector == 0) {
-						/* No can do. lets give up and go home.  We must be out of room */
-						goto finalizeWrite;
-					}
+	if (filelength == 0 && remaining != 0) {
+		/* Start a new cluster chain for an empty file */
+		firstCluster = myDrive->getFirstFreeClust();
+		if(firstCluster == 0) goto finalizeWrite; // out of space
+		myDrive->allocateCluster(firstCluster, 0);
+		loadedSector = false;
+	}
+
+	while (remaining != 0) {
+		if (!loadedSector) {
+			uint32_t contiguous = 0;
+			currentSector = getSectorAt(seekpos, &contiguous);
+			if (currentSector == 0) {
+				/* EOC reached before EOF - try to increase file allocation */
+				currentSector = allocateAt(seekpos, &contiguous);
+				if (currentSector == 0) {
+					/* No can do. lets give up and go home.  We must be out of room */
+					break;
 				}
-				curSectOff = seekpos % myDrive->getSectorSize();
-				myDrive->readSector(currentSector, sectorBuffer);
-				loadedSector = true;
 			}
-			filelength = seekpos+1;
-		}
-		sectorBuffer[curSectOff++] = data[sizecount++];
-		seekpos++;
-		if(curSectOff >= myDrive->getSectorSize()) {
-			if(loadedSector) myDrive->writeSector(currentSector, sectorBuffer);
-
-			currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
-			if(currentSector == 0) loadedSector = false;
-			else {
-				curSectOff = 0;
-				myDrive->readSector(currentSector, sectorBuffer);
-				loadedSector = true;
+			curSectOff = seekpos % sector_size;
+
+			/* Whole sectors go straight from the caller's buffer to
+			 * disk, as many per disk access as the cluster chain allows */
+			const uint32_t whole_sectors = std::min(remaining / sector_size, contiguous);
+			if (curSectOff == 0 && whole_sectors != 0) {
+				const uint32_t bytes = whole_sectors * sector_size;
+				myDrive->writeSectors(currentSector, whole_sectors, data + sizecount);
+				sizecount += bytes;
+				seekpos += bytes;
+				remaining -= bytes;
+				filelength = std::max(filelength, seekpos);
+				continue;
 			}
+			myDrive->readSector(currentSector, sectorBuffer);
+			loadedSector = true;
+		}
+
+		const uint32_t span = std::min(remaining, sector_size - curSectOff);
+		memcpy(sectorBuffer + curSectOff, data + sizecount, span);
+		dirty = true;
+		sizecount += span;
+		seekpos += span;
+		curSectOff += span;
+		remaining -= span;
+		filelength = std::max(filelength, seekpos);
+		if (curSectOff >= sector_size) {
+			myDrive->writeSector(currentSector, sectorBuffer);
+			dirty = false;
+			loadedSector = false;
 		}
-		--sizedec;
 	}
-	if(curSectOff>0 && loadedSector) myDrive->writeSector(currentSector, sectorBuffer);
+	if (dirty) myDrive->writeSector(currentSector, sectorBuffer);
 
 finalizeWrite:
 	myDrive->directoryBrowse(dirCluster, &tmpentry, dirIndex);
@@ -240,7 +263,7 @@ finalizeWrite:
 	tmpentry.loFirstClust = (uint16_t)firstCluster;
 	myDrive->directoryChange(dirCluster, &tmpentry, dirIndex);
 
-	*size =sizecount;
+	*size = static_cast<uint16_t>(sizecount);
 	return true;
 }
 
@@ -263,19 +286,86 @@ bool fatFile::Seek(uint32_t *pos, uint32_t type) {
 
 	if(seekto<0) seekto = 0;
 	seekpos = (uint32_t)seekto;
-	currentSector = myDrive->getAbsoluteSectFromBytePos(firstCluster, seekpos);
-	if (currentSector == 0) {
-		/* not within file size, thus no sector is available */
-		loadedSector = false;
-	} else {
-		curSectOff = seekpos % myDrive->getSectorSize();
-		myDrive->readSector(currentSector, sectorBuffer);
-		loadedSector = true;
-	}
+
+	/* The sector buffer never holds unwritten data between calls, so
+	 * just drop it; the new position's sector is fetched when needed */
+	loadedSector = false;
+
 	*pos = seekpos;
 	return true;
 }
 
+// Returns the absolute sector holding the given byte of the file, or 0 if
+// it lies beyond the end of the cluster chain. Also reports how many
+// sectors from there on are physically consecutive.
+uint32_t fatFile::getSectorAt(uint32_t bytePos, uint32_t* contiguousSectors)
+{
+	*contiguousSectors = 0;
+	if (firstCluster == 0) {
+		return 0;
+	}
+
+	const auto generation = myDrive->getFatGeneration();
+	if (extents_cluster != firstCluster || extents_generation != generation) {
+		myDrive->getFileExtents(firstCluster, extents);
+		extents_cluster    = firstCluster;
+		extents_generation = generation;
+	}
+
+	// Find the last extent starting at or before the sector
+	const uint32_t logical = bytePos / myDrive->getSectorSize();
+	auto it = std::upper_bound(extents.begin(),
+	                           extents.end(),
+	                           logical,
+	                           [](const uint32_t sector, const FatExtent& extent) {
+		                           return sector < extent.logical_sector;
+	                           });
+	if (it == extents.begin()) {
+		return 0;
+	}
+	--it;
+
+	const uint32_t offset = logical - it->logical_sector;
+	if (offset >= it->num_sectors) {
+		return 0;
+	}
+	*contiguousSectors = it->num_sectors - offset;
+	return it->first_sector + offset;
+}
+
+// Appends a cluster to the chain and returns the sector holding the given
+// byte afterwards, or 0 if the drive is full
+uint32_t fatFile::allocateAt(uint32_t bytePos, uint32_t* contiguousSectors)
+{
+	// If our extents describe the whole chain, the new cluster can be
+	// tacked onto them instead of walking the chain again
+	const bool extents_valid = (extents_cluster == firstCluster &&
+	                            extents_generation == myDrive->getFatGeneration() &&
+	                            !extents.empty());
+
+	const uint32_t newClust = myDrive->appendCluster(firstCluster);
+	if (newClust == 0) {
+		return 0;
+	}
+
+	if (extents_valid) {
+		const uint32_t sectors_cluster = myDrive->getClusterSize() /
+		                                 myDrive->getSectorSize();
+		const uint32_t first_sector = myDrive->getClustFirstSect(newClust);
+
+		auto& last = extents.back();
+		if (last.first_sector + last.num_sectors == first_sector) {
+			last.num_sectors += sectors_cluster;
+		} else {
+			extents.push_back({last.logical_sector + last.num_sectors,
+			                   first_sector,
+			                   sectors_cluster});
+		}
+		extents_generation = myDrive->getFatGeneration();
+	}
+	return getSectorAt(bytePos, contiguousSectors);
+}
+
 void fatFile::Close()
 {
 	if (flush_time_on_close == FlushTimeOnClose::ManuallySet ||
@@ -318,8 +408,6 @@ uint32_t fatDrive::getClustFirstSect(uint32_t clustNum) {
 
 uint32_t fatDrive::getClusterValue(uint32_t clustNum) {
 	uint32_t fatoffset=0;
-	uint32_t fatsectnum;
-	uint32_t fatentoff;
 	uint32_t clustValue=0;
 
 	switch(fattype) {
@@ -333,20 +421,19 @@ uint32_t fatDrive::getClusterValue(uint32_t clustNum) {
 			fatoffset = clustNum * 4;
 			break;
 	}
-	fatsectnum = bootbuffer.reservedsectors + (fatoffset / bootbuffer.bytespersector) + partSectOff;
-	fatentoff = fatoffset % bootbuffer.bytespersector;
 
-	if(curFatSect != fatsectnum) {
-		/* Load two sectors at once for FAT12 */
-		readSector(fatsectnum, &fatSectBuffer[0]);
-		if (fattype==FAT12)
-			readSector(fatsectnum + 1, &fatSectBuffer[BytePerSector]);
-		curFatSect = fatsectnum;
+	/* Clusters beyond the FAT read as end of chain */
+	if (fatoffset + (fattype == FAT32 ? 4 : 2) > fat_cache.size()) {
+		switch (fattype) {
+			case FAT12: return 0xfff;
+			case FAT16: return 0xffff;
+			default: return 0xffffffff;
+		}
 	}
 
 	switch(fattype) {
 		case FAT12:
-			clustValue = var_read((uint16_t *)&fatSectBuffer[fatentoff]);
+			clustValue = var_read((uint16_t *)&fat_cache[fatoffset]);
 			if(clustNum & 0x1) {
 				clustValue >>= 4;
 			} else {
@@ -354,10 +441,10 @@ uint32_t fatDrive::getClusterValue(uint32_t clustNum) {
 			}
 			break;
 		case FAT16:
-			clustValue = var_read((uint16_t *)&fatSectBuffer[fatentoff]);
+			clustValue = var_read((uint16_t *)&fat_cache[fatoffset]);
 			break;
 		case FAT32:
-			clustValue = var_read((uint32_t *)&fatSectBuffer[fatentoff]);
+			clustValue = var_read((uint32_t *)&fat_cache[fatoffset]);
 			break;
 	}
 
@@ -366,8 +453,6 @@ uint32_t fatDrive::getClusterValue(uint32_t clustNum) {
 
 void fatDrive::setClusterValue(uint32_t clustNum, uint32_t clustValue) {
 	uint32_t fatoffset=0;
-	uint32_t fatsectnum;
-	uint32_t fatentoff;
 
 	switch(fattype) {
 		case FAT12:
@@ -380,21 +465,15 @@ void fatDrive::setClusterValue(uint32_t clustNum, uint32_t clustValue) {
 			fatoffset = clustNum * 4;
 			break;
 	}
-	fatsectnum = bootbuffer.reservedsectors + (fatoffset / bootbuffer.bytespersector) + partSectOff;
-	fatentoff = fatoffset % bootbuffer.bytespersector;
-
-	if(curFatSect != fatsectnum) {
-		/* Load two sectors at once for FAT12 */
-		readSector(fatsectnum, &fatSectBuffer[0]);
-		if (fattype==FAT12)
-			        readSector(fatsectnum + 1,
-			                   &fatSectBuffer[BytePerSector]);
-		curFatSect = fatsectnum;
+	const uint32_t entrysize = (fattype == FAT32) ? 4 : 2;
+	if (fatoffset + entrysize > fat_cache.size()) {
+		return;
 	}
+	markClusterFree(clustNum, (fattype == FAT12 ? (clustValue & 0xfff) : clustValue) == 0);
 
 	switch(fattype) {
 		case FAT12: {
-			uint16_t tmpValue = var_read((uint16_t *)&fatSectBuffer[fatentoff]);
+			uint16_t tmpValue = var_read((uint16_t *)&fat_cache[fatoffset]);
 			if(clustNum & 0x1) {
 				clustValue &= 0xfff;
 				clustValue <<= 4;
@@ -406,24 +485,69 @@ void fatDrive::setClusterValue(uint32_t clustNum, uint32_t clustValue) {
 				tmpValue &= 0xf000;
 				tmpValue |= (uint16_t)clustValue;
 			}
-			var_write((uint16_t *)&fatSectBuffer[fatentoff], tmpValue);
+			var_write((uint16_t *)&fat_cache[fatoffset], tmpValue);
 			break;
 			}
 		case FAT16:
-			var_write((uint16_t *)&fatSectBuffer[fatentoff], (uint16_t)clustValue);
+			var_write((uint16_t *)&fat_cache[fatoffset], (uint16_t)clustValue);
 			break;
 		case FAT32:
-			var_write((uint32_t *)&fatSectBuffer[fatentoff], clustValue);
+			var_write((uint32_t *)&fat_cache[fatoffset], clustValue);
 			break;
 	}
+	++fat_generation;
+
+	/* Write the modified sector through to every FAT copy; a FAT12
+	 * entry can straddle two sectors */
+	const uint32_t firstsect = fatoffset / bootbuffer.bytespersector;
+	const uint32_t lastsect = std::min<uint32_t>((fatoffset + entrysize - 1) / bootbuffer.bytespersector,
+	                                             bootbuffer.sectorsperfat - 1);
+	const uint32_t fatsectnum = bootbuffer.reservedsectors + firstsect + partSectOff;
 	for(int fc=0;fc<bootbuffer.fatcopies;fc++) {
-		writeSector(fatsectnum + (fc * bootbuffer.sectorsperfat), &fatSectBuffer[0]);
-		if (fattype==FAT12) {
-			if (fatentoff>=511)
-				writeSector(fatsectnum + 1 +
-				                    (fc * bootbuffer.sectorsperfat),
-				            &fatSectBuffer[BytePerSector]);
+		writeSectors(fatsectnum + (fc * bootbuffer.sectorsperfat),
+		             lastsect - firstsect + 1,
+		             &fat_cache[firstsect * bootbuffer.bytespersector]);
+	}
+}
+
+bool fatDrive::isEndOfChain(uint32_t clustValue) const
+{
+	switch (fattype) {
+		case FAT12: return clustValue >= 0xff8;
+		case FAT16: return clustValue >= 0xfff8;
+		default: return clustValue >= 0xfffffff8;
+	}
+}
+
+// Describes a file's whole cluster chain as runs of consecutive sectors
+void fatDrive::getFileExtents(uint32_t startClustNum, std::vector<FatExtent>& extents)
+{
+	extents.clear();
+
+	const uint32_t sectors_cluster = bootbuffer.sectorspercluster;
+	const uint32_t lastClust = CountOfClusters + 1;
+	uint32_t logical_sector = 0;
+	uint32_t currentClust = startClustNum;
+
+	// Bounded by the cluster count so a looping chain can't hang us
+	for (uint32_t i = 0; i < CountOfClusters; ++i) {
+		if (currentClust < 2 || currentClust > lastClust) {
+			break;
 		}
+		const uint32_t sector = getClustFirstSect(currentClust);
+		if (!extents.empty() &&
+		    extents.back().first_sector + extents.back().num_sectors == sector) {
+			extents.back().num_sectors += sectors_cluster;
+		} else {
+			extents.push_back({logical_sector, sector, sectors_cluster});
+		}
+		logical_sector += sectors_cluster;
+
+		const uint32_t nextClust = getClusterValue(currentClust);
+		if (isEndOfChain(nextClust)) {
+			break;
+		}
+		currentClust = nextClust;
 	}
 }
 
@@ -577,6 +701,9 @@ uint8_t fatDrive::writeSector(uint32_t sectnum, void * data) {
 		return 0;
 	}
 
+	// Keep the cached FAT in step with raw writes, e.g. through INT 26h
+	updateFatCache(sectnum, 1, data);
+
 	if (absolute) {
 		return loadedDisk->Write_AbsoluteSector(sectnum, data);
 	}
@@ -588,6 +715,107 @@ uint8_t fatDrive::writeSector(uint32_t sectnum, void * data) {
 	return loadedDisk->Write_Sector(head, cylinder, sector, data);
 }
 
+uint8_t fatDrive::readSectors(uint32_t sectnum, uint32_t count, void* data)
+{
+	// Guard
+	if (!loadedDisk) {
+		return 0;
+	}
+
+	if (absolute) {
+		return loadedDisk->Read_AbsoluteSectors(sectnum, count, data);
+	}
+	auto bytes = static_cast<uint8_t*>(data);
+	for (uint32_t i = 0; i < count; ++i) {
+		const auto ret = readSector(sectnum + i, bytes + i * bootbuffer.bytespersector);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+	return 0;
+}
+
+uint8_t fatDrive::writeSectors(uint32_t sectnum, uint32_t count, const void* data)
+{
+	// Guard
+	if (!loadedDisk) {
+		return 0;
+	}
+
+	if (absolute) {
+		updateFatCache(sectnum, count, data);
+		return loadedDisk->Write_AbsoluteSectors(sectnum, count, data);
+	}
+	auto bytes = static_cast<const uint8_t*>(data);
+	for (uint32_t i = 0; i < count; ++i) {
+		const auto ret = writeSector(sectnum + i,
+		                             const_cast<uint8_t*>(bytes) +
+		                                     i * bootbuffer.bytespersector);
+		if (ret != 0) {
+			return ret;
+		}
+	}
+	return 0;
+}
+
+// Copies any part of the written sectors that falls within the first FAT
+// into the cached FAT
+void fatDrive::updateFatCache(uint32_t sectnum, uint32_t count, const void* data)
+{
+	if (fat_cache.empty()) {
+		return;
+	}
+	const uint32_t fatstart = bootbuffer.reservedsectors + partSectOff;
+	const uint32_t fatend = fatstart + bootbuffer.sectorsperfat;
+	const uint32_t first = std::max(sectnum, fatstart);
+	const uint32_t last = std::min(sectnum + count, fatend);
+	if (first >= last) {
+		return;
+	}
+
+	const auto src = static_cast<const uint8_t*>(data) +
+	                 (first - sectnum) * bootbuffer.bytespersector;
+	const auto dest = &fat_cache[(first - fatstart) * bootbuffer.bytespersector];
+	// setClusterValue writes straight from the cache
+	if (src != dest) {
+		memcpy(dest, src, (last - first) * bootbuffer.bytespersector);
+		buildFreeClusterMap();
+	}
+	++fat_generation;
+}
+
+void fatDrive::buildFreeClusterMap()
+{
+	free_cluster_map.assign((CountOfClusters + 63) / 64, 0);
+	free_cluster_count = 0;
+	next_free_hint = 0;
+
+	for (uint32_t i = 0; i < CountOfClusters; ++i) {
+		if (!getClusterValue(i + 2)) {
+			free_cluster_map[i / 64] |= uint64_t(1) << (i % 64);
+			++free_cluster_count;
+		}
+	}
+}
+
+void fatDrive::markClusterFree(uint32_t clustNum, bool is_free)
+{
+	if (clustNum < 2 || clustNum - 2 >= CountOfClusters) {
+		return;
+	}
+	const uint32_t index = clustNum - 2;
+	const uint64_t mask = uint64_t(1) << (index % 64);
+	uint64_t& word = free_cluster_map[index / 64];
+
+	if (is_free && !(word & mask)) {
+		word |= mask;
+		++free_cluster_count;
+	} else if (!is_free && (word & mask)) {
+		word &= ~mask;
+		--free_cluster_count;
+	}
+}
+
 uint32_t fatDrive::getSectorCount()
 {
 	if (bootbuffer.totalsectorcount != 0)
@@ -778,9 +1006,7 @@ fatDrive::fatDrive(const char* sysFilename, uint32_t bytesector,
           CountOfClusters(0),
           firstDataSector(0),
           firstRootDirSect(0),
-          cwdDirCluster(0),
-          fatSectBuffer{0},
-          curFatSect(0)
+          cwdDirCluster(0)
 {
 	FILE *diskfile;
 	uint32_t filesize;
@@ -971,8 +1197,12 @@ fatDrive::fatDrive(const char* sysFilename, uint32_t bytesector,
 	/* There is no cluster 0, this means we are in the root directory */
 	cwdDirCluster = 0;
 
-	memset(fatSectBuffer,0,1024);
-	curFatSect = 0xffffffff;
+	/* Keep the first FAT in memory, all cluster lookups are served from it */
+	fat_cache.assign(bootbuffer.sectorsperfat * bootbuffer.bytespersector, 0);
+	readSectors(bootbuffer.reservedsectors + partSectOff,
+	            bootbuffer.sectorsperfat,
+	            fat_cache.data());
+	buildFreeClusterMap();
 
 	type = DosDriveType::Fat;
 	safe_strcpy(info, sysFilename);
@@ -985,8 +1215,7 @@ bool fatDrive::AllocationInfo(uint16_t *_bytes_sector, uint8_t *_sectors_cluster
 	}
 
 	uint32_t hs, cy, sect,sectsize;
-	uint32_t countFree = 0;
-	uint32_t i;
+	uint32_t countFree = free_cluster_count;
 
 	loadedDisk->Get_Geometry(&hs, &cy, &sect, &sectsize);
 	*_bytes_sector = (uint16_t)sectsize;
@@ -999,12 +1228,6 @@ bool fatDrive::AllocationInfo(uint16_t *_bytes_sector, uint8_t *_sectors_cluster
 		*_total_clusters = 65535;
 	}
 
-	for (i=0; i<CountOfClusters; i++) {
-		if (!getClusterValue(i + 2)) {
-			countFree++;
-		}
-	}
-
 	if (countFree<65536) {
 		*_free_clusters = (uint16_t)countFree;
 	} else {
@@ -1015,9 +1238,25 @@ bool fatDrive::AllocationInfo(uint16_t *_bytes_sector, uint8_t *_sectors_cluster
 }
 
 uint32_t fatDrive::getFirstFreeClust(void) {
-	uint32_t i;
-	for(i=0;i<CountOfClusters;i++) {
-		if(!getClusterValue(i+2)) return (i+2);
+	if (free_cluster_count == 0) {
+		/* No free cluster found */
+		return 0;
+	}
+
+	/* Next-fit: search from the last cluster handed out, wrapping around
+	 * to the start of the map once */
+	const size_t num_words = free_cluster_map.size();
+	size_t word = next_free_hint / 64;
+	uint64_t bits = free_cluster_map[word] & (~uint64_t(0) << (next_free_hint % 64));
+
+	for (size_t n = 0; n <= num_words; ++n) {
+		if (bits) {
+			next_free_hint = static_cast<uint32_t>(word * 64) +
+			                 static_cast<uint32_t>(std::countr_zero(bits));
+			return next_free_hint + 2;
+		}
+		word = (word + 1) % num_words;
+		bits = free_cluster_map[word];
 	}
 
 	/* No free cluster found */
@@ -12,6 +12,7 @@
 #include <cstring>
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "dos.h"
@@ -271,23 +272,6 @@ std::pair<NativeFileHandle, std_fs::path> Overlay_Drive::create_file_in_overlay(
 	return {file_handle, newname};
 }
 
-#ifndef BUFSIZ
-#define BUFSIZ 2048
-#endif
-
-static void copy_file_contents(const NativeFileHandle src, const NativeFileHandle dst)
-{
-	uint8_t buffer[BUFSIZ] = {};
-	while (true) {
-		const auto ret = read_native_file(src, buffer, BUFSIZ);
-		if (ret.num_bytes > 0) {
-			write_native_file(dst, buffer, ret.num_bytes);
-		} else {
-			break;
-		}
-	}
-}
-
 bool OverlayFile::create_copy()
 {
 	//test if open/valid/etc
@@ -311,6 +295,7 @@ bool OverlayFile::create_copy()
 	}
 
 	NativeFileHandle newhandle = InvalidNativeFileHandle;
+	std_fs::path newpath = {};
 	uint8_t drive_set = GetDrive();
 	if (drive_set != 0xff && drive_set < DOS_DRIVES && Drives[drive_set]){
 		const auto od = std::dynamic_pointer_cast<Overlay_Drive>(
@@ -318,7 +303,6 @@ bool OverlayFile::create_copy()
 		if (od) {
 			FatAttributeFlags attributes = {};
 			local_drive_get_attributes(GetPath(), attributes);
-			std_fs::path newpath = {};
 			std::tie(newhandle,
 			         newpath) = od->create_file_in_overlay(GetName(),
 			                                               attributes);
@@ -329,7 +313,14 @@ bool OverlayFile::create_copy()
 		return false;
 	}
 
-	copy_file_contents(file_handle, newhandle);
+	// A partial copy would shadow the intact base file, so drop it
+	if (!copy_native_file_contents(file_handle, newhandle)) {
+		LOG_ERR("OVERLAY: Failed copying file '%s' to the overlay",
+		        GetName());
+		close_native_file(newhandle);
+		delete_native_file(newpath);
+		return false;
+	}
 
 	//Set copied file handle to position of the old one
 	if (seek_native_file(newhandle, location_in_old_file, NativeSeek::Set) ==
@@ -368,6 +359,7 @@ Overlay_Drive::Overlay_Drive(const char *startdir,
           overlap_folder(),
           DOSnames_cache{},
           DOSdirs_cache{},
+          DOSdirs_index{},
           special_prefix("DBOVERLAY")
 {
 	//Currently this flag does nothing, as the current behavior is to not reread due to caching everything.
@@ -580,18 +572,12 @@ std::unique_ptr<DOS_File> Overlay_Drive::FileCreate(const char* name,
 
 void Overlay_Drive::add_DOSname_to_cache(const char* name)
 {
-	for (const auto& entry : DOSnames_cache) {
-		if (name == entry) return;
-	}
-	DOSnames_cache.emplace_back(name);
+	DOSnames_cache.emplace(name);
 }
 
 void Overlay_Drive::remove_DOSname_from_cache(const char* name)
 {
-	for (auto it = DOSnames_cache.begin(); it != DOSnames_cache.end(); ++it) {
-		if (name == (*it)) { DOSnames_cache.erase(it); return;}
-	}
-
+	DOSnames_cache.erase(name);
 }
 
 bool Overlay_Drive::Sync_leading_dirs(const char* dos_filename){
@@ -650,6 +636,7 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 		//Clear all lists
 		DOSnames_cache.clear();
 		DOSdirs_cache.clear();
+		DOSdirs_index.clear();
 		deleted_files_in_base.clear();
 		deleted_paths_in_base.clear();
 		//Ensure hiding of the folder that contains the overlay, if it is part of the base folder.
@@ -740,7 +727,8 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 			if (!dir_exists_in_base) add_DOSdir_to_cache(tdir);
 #endif
 
-			std::string backupi(*i);
+			// Adding entries below invalidates the iterator
+			const auto current_index = i - dirnames.begin();
 
 			auto maybe_add_path = [&]() {
 				if ((safe_strlen(dir_name) > prefix_lengh + 5) &&
@@ -767,12 +755,8 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 			close_directory(dirp);
 			dirp = nullptr;
 
-			// find current directory again, for the next round. But
-			// if it's not there, then bail out before the next
-			// round to avoid incrementing beyond the end.
-			i = std::find(dirnames.begin(), dirnames.end(), backupi);
-			if (i == dirnames.end())
-				break;
+			// Find current directory again, for the next round
+			i = dirnames.begin() + current_index;
 		}
 	}
 
@@ -784,7 +768,7 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 			upcase(dosname);  //Should not be really needed, as uppercase in the overlay is a requirement...
 			CROSS_DOSFILENAME(dosname);
 			if (logoverlay) LOG_MSG("update cache add dosname %s",dosname);
-			DOSnames_cache.emplace_back(dosname);
+			DOSnames_cache.emplace(dosname);
 		}
 	}
 
@@ -798,10 +782,10 @@ void Overlay_Drive::update_cache(bool read_directory_contents) {
 	}
 #endif
 
-	for (i = DOSnames_cache.begin(); i != DOSnames_cache.end(); ++i) {
+	for (const auto& dosname : DOSnames_cache) {
 		char fakename[CROSS_LEN];
 		safe_strcpy(fakename, basedir);
-		safe_strcat(fakename, (*i).c_str());
+		safe_strcat(fakename, dosname.c_str());
 		CROSS_FILENAME(fakename);
 		dirCache.AddEntry(fakename,true);
 	}
@@ -1072,8 +1056,7 @@ bool Overlay_Drive::SetFileAttr(const char* name, FatAttributeFlags attr)
 
 void Overlay_Drive::add_deleted_file(const char* name,bool create_on_disk) {
 	if (logoverlay) LOG_MSG("add del file %s",name);
-	if (!is_deleted_file(name)) {
-		deleted_files_in_base.emplace_back(name);
+	if (deleted_files_in_base.emplace(name).second) {
 		if (create_on_disk) add_special_file_to_disk(name, "DEL");
 
 	}
@@ -1121,32 +1104,27 @@ std::string Overlay_Drive::create_filename_of_special_operation(const char* dosn
 
 bool Overlay_Drive::is_dir_only_in_overlay(const char* name) {
 	if (!name || !*name) return false;
-	if (DOSdirs_cache.empty()) return false;
-	for(const auto& entry : DOSdirs_cache) {
-		if (entry == name) return true;
-	}
-	return false;
+	return DOSdirs_index.contains(name);
 }
 
 bool Overlay_Drive::is_deleted_file(const char* name) {
 	if (!name || !*name) return false;
-	if (deleted_files_in_base.empty()) return false;
-	for(const auto& entry : deleted_files_in_base) {
-		if (entry == name) return true;
-	}
-	return false;
+	return deleted_files_in_base.contains(name);
 }
 
 void Overlay_Drive::add_DOSdir_to_cache(const char* name) {
 	if (!name || !*name ) return; //Skip empty file.
 	LOG_MSG("Adding name to overlay_only_dir_cache %s",name);
-	if (!is_dir_only_in_overlay(name)) {
+	if (DOSdirs_index.emplace(name).second) {
 		DOSdirs_cache.emplace_back(name); 
 	}
 }
 
 void Overlay_Drive::remove_DOSdir_from_cache(const char* name)
 {
+	if (!DOSdirs_index.erase(name)) {
+		return;
+	}
 	for(auto it = DOSdirs_cache.begin(); it != DOSdirs_cache.end(); ++it) {
 		if (*it == name) {
 			DOSdirs_cache.erase(it);
@@ -1156,19 +1134,15 @@ void Overlay_Drive::remove_DOSdir_from_cache(const char* name)
 }
 
 void Overlay_Drive::remove_deleted_file(const char* name,bool create_on_disk) {
-	for(auto it = deleted_files_in_base.begin(); it != deleted_files_in_base.end(); ++it) {
-		if (*it == name) {
-			deleted_files_in_base.erase(it);
-			if (create_on_disk) remove_special_file_from_disk(name, "DEL");
-			return;
-		}
+	if (deleted_files_in_base.erase(name)) {
+		if (create_on_disk) remove_special_file_from_disk(name, "DEL");
 	}
 }
 void Overlay_Drive::add_deleted_path(const char* name, bool create_on_disk) {
 	if (!name || !*name ) return; //Skip empty file.
 	if (logoverlay) LOG_MSG("add del path %s",name);
 	if (!is_deleted_path(name)) {
-		deleted_paths_in_base.emplace_back(name);
+		deleted_paths_in_base.emplace(name);
 		//Add it to deleted files as well, so it gets skipped in FindNext. 
 		//Maybe revise that.
 		if (create_on_disk) add_special_file_to_disk(name,"RMD");
@@ -1178,26 +1152,19 @@ void Overlay_Drive::add_deleted_path(const char* name, bool create_on_disk) {
 bool Overlay_Drive::is_deleted_path(const char* name) {
 	if (!name || !*name) return false;
 	if (deleted_paths_in_base.empty()) return false;
-	std::string sname(name);
-	std::string::size_type namelen = sname.length();
-	for(const auto& entry : deleted_paths_in_base) {
-		std::string::size_type blockedlen = entry.length();
-		if (namelen < blockedlen) continue;
-		//See if input starts with name. 
-		std::string::size_type n = sname.find(entry);
-		if (n == 0 && ((namelen == blockedlen) || *(name + blockedlen) == '\\' )) return true;
+	//The name is blocked if it, or any of its leading directories, is deleted.
+	const std::string_view sname(name);
+	for (auto pos = sname.find('\\'); pos != std::string_view::npos;
+	     pos = sname.find('\\', pos + 1)) {
+		if (deleted_paths_in_base.contains(std::string(sname.substr(0, pos)))) return true;
 	}
-	return false;
+	return deleted_paths_in_base.contains(name);
 }
 
 void Overlay_Drive::remove_deleted_path(const char* name, bool create_on_disk) {
-	for(auto it = deleted_paths_in_base.begin(); it != deleted_paths_in_base.end(); ++it) {
-		if (*it == name) {
-			deleted_paths_in_base.erase(it);
-			remove_deleted_file(name,false); //Rethink maybe.
-			if (create_on_disk) remove_special_file_from_disk(name,"RMD");
-			break;
-		}
+	if (deleted_paths_in_base.erase(name)) {
+		remove_deleted_file(name,false); //Rethink maybe.
+		if (create_on_disk) remove_special_file_from_disk(name,"RMD");
 	}
 }
 bool Overlay_Drive::check_if_leading_is_deleted(const char* name){
@@ -1298,9 +1265,17 @@ bool Overlay_Drive::Rename(const char * oldname, const char * newname) {
 			close_native_file(o);
 			return false;
 		}
-		copy_file_contents(o, n);
+		const auto copied = copy_native_file_contents(o, n);
+		if (!copied) {
+			LOG_ERR("OVERLAY: Failed copying file '%s' to the overlay",
+			        oldname);
+		}
 		close_native_file(o);
 		close_native_file(n);
+		if (!copied) {
+			delete_native_file(path);
+			return false;
+		}
 
 		//File copied.
 		//Mark old file as deleted
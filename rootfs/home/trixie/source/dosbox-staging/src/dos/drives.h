@@ -180,6 +180,13 @@ struct partTable {
 //Forward
 class imageDisk;
 
+// A run of physically consecutive sectors in a file's cluster chain
+struct FatExtent {
+	uint32_t logical_sector; // First sector of the run, counted from the file start
+	uint32_t first_sector;   // Absolute sector the run starts at
+	uint32_t num_sectors;
+};
+
 // Must be constructed with a shared_ptr or it will throw an exception on internal call to shared_from_this()
 class fatDrive final : public DOS_Drive, public std::enable_shared_from_this<fatDrive> {
 public:
@@ -214,6 +221,8 @@ public:
 public:
 	uint8_t readSector(uint32_t sectnum, void * data);
 	uint8_t writeSector(uint32_t sectnum, void * data);
+	uint8_t readSectors(uint32_t sectnum, uint32_t count, void* data);
+	uint8_t writeSectors(uint32_t sectnum, uint32_t count, const void* data);
 	uint32_t getAbsoluteSectFromBytePos(uint32_t startClustNum, uint32_t bytePos);
 	uint32_t getSectorCount();
 	uint32_t getSectorSize(void);
@@ -223,6 +232,13 @@ public:
 	uint32_t appendCluster(uint32_t startCluster);
 	void deleteClustChain(uint32_t startCluster, uint32_t bytePos);
 	uint32_t getFirstFreeClust(void);
+	uint32_t getClustFirstSect(uint32_t clustNum);
+	void getFileExtents(uint32_t startClustNum, std::vector<FatExtent>& extents);
+
+	// Bumped whenever the in-memory FAT changes, so callers holding
+	// extents derived from it know when to rebuild them
+	uint32_t getFatGeneration() const { return fat_generation; }
+
 	bool directoryBrowse(uint32_t dirClustNumber, direntry *useEntry, int32_t entNum, int32_t start=0);
 	bool directoryChange(uint32_t dirClustNumber, direntry *useEntry, int32_t entNum);
 	std::shared_ptr<imageDisk> loadedDisk;
@@ -232,7 +248,10 @@ public:
 private:
 	uint32_t getClusterValue(uint32_t clustNum);
 	void setClusterValue(uint32_t clustNum, uint32_t clustValue);
-	uint32_t getClustFirstSect(uint32_t clustNum);
+	bool isEndOfChain(uint32_t clustValue) const;
+	void updateFatCache(uint32_t sectnum, uint32_t count, const void* data);
+	void buildFreeClusterMap();
+	void markClusterFree(uint32_t clustNum, bool is_free);
 	bool FindNextInternal(uint32_t dirClustNumber, DOS_DTA & dta, direntry *foundEntry);
 	bool getDirClustNum(const char * dir, uint32_t * clustNum, bool parDir);
 	bool getFileDirEntry(const char* const filename, direntry* useEntry,
@@ -253,8 +272,16 @@ private:
 
 	uint32_t cwdDirCluster;
 
-	uint8_t fatSectBuffer[1024];
-	uint32_t curFatSect;
+	// The first FAT copy, loaded at mount. Lookups never touch the disk;
+	// modifications are written through to all copies.
+	std::vector<uint8_t> fat_cache = {};
+	uint32_t fat_generation = 0;
+
+	// One bit per data cluster, set while the cluster is free. Allocation
+	// resumes searching where the last free cluster was found.
+	std::vector<uint64_t> free_cluster_map = {};
+	uint32_t free_cluster_count = 0;
+	uint32_t next_free_hint = 0;
 };
 
 class cdromDrive final : public localDrive
@@ -514,8 +541,8 @@ private:
 	void remove_DOSdir_from_cache(const char* name);
 	void update_cache(bool read_directory_contents = false);
 
-	std::vector<std::string> deleted_files_in_base; //Set is probably better, or some other solution (involving the disk).
-	std::vector<std::string> deleted_paths_in_base; //Currently only used to hide the overlay folder.
+	std::unordered_set<std::string> deleted_files_in_base;
+	std::unordered_set<std::string> deleted_paths_in_base; //Currently only used to hide the overlay folder.
 	std::string overlap_folder;
 	void add_deleted_file(const char* name, bool create_on_disk);
 	void remove_deleted_file(const char* name, bool create_on_disk);
@@ -533,8 +560,9 @@ private:
 	std::string create_filename_of_special_operation(const char* dosname, const char* operation);
 	void convert_overlay_to_DOSname_in_base(char* dirname );
 	//For caching the update_cache routine.
-	std::vector<std::string> DOSnames_cache; //Also set is probably better.
+	std::unordered_set<std::string> DOSnames_cache;
 	std::vector<std::string> DOSdirs_cache; //Can not blindly change its type. it is important that subdirs come after the parent directory.
+	std::unordered_set<std::string> DOSdirs_index; //Lookups into DOSdirs_cache
 	const std::string special_prefix;
 };
 
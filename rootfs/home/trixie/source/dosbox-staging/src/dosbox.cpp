@@ -853,6 +853,14 @@ static void add_dosbox_config_section(const ConfigPtr& conf)
 	        "might require a higher value. There is generally no speed advantage when raising\n"
 	        "this value.");
 
+	auto pbool = section->AddBool("release_freed_memory", OnlyAtStart, false);
+	pbool->SetHelp(
+	        "Return the memory of freed XMS and EMS blocks to the host system (disabled by\n"
+	        "default). Only the memory the emulated machine actually touches is taken from\n"
+	        "the host; with this enabled, it's also given back when DOS programs free it.\n"
+	        "Useful on systems with little memory combined with large 'memsize' values.\n"
+	        "Note: freed memory reads back as zeroes, which a few programs might not expect.");
+
 	pstring = section->AddString("mcb_fault_strategy", OnlyAtStart, "repair");
 	pstring->SetHelp(
 	        "How software-corrupted memory chain blocks should be handled ('repair' by\n"
@@ -955,7 +963,7 @@ static void add_dosbox_config_section(const ConfigPtr& conf)
 	        "               modes available in this mode are often required by late '90s\n"
 	        "               demoscene productions.");
 
-	auto pbool = section->AddBool("vga_8dot_font", OnlyAtStart, false);
+	pbool = section->AddBool("vga_8dot_font", OnlyAtStart, false);
 	pbool->SetHelp("Use 8-pixel-wide fonts on VGA adapters ('off' by default).");
 
 	pbool = section->AddBool("vga_render_per_scanline", OnlyAtStart, true);
@@ -128,6 +128,9 @@
 // Defined if function mmap is available
 #cmakedefine HAVE_MMAP
 
+// Defined if function madvise is available
+#cmakedefine HAVE_MADVISE
+
 // Defined if mmap flag MAPJIT is available
 #cmakedefine HAVE_MAP_JIT
 
@@ -26,8 +26,10 @@ constexpr auto AutoArcadeSharp      = "crt-auto-arcade-sharp";
 
 namespace ShaderName {
 
-constexpr auto CrtHyllian = "crt/crt-hyllian";
-constexpr auto Sharp      = "interpolation/sharp";
+constexpr auto CrtHyllian             = "crt/crt-hyllian";
+constexpr auto Sharp                  = "interpolation/sharp";
+constexpr auto Vga1080p               = "crt/vga-1080p";
+constexpr auto Vga1080pFakeDoubleScan = "crt/vga-1080p-fake-double-scan";
 } // namespace ShaderName
 
 enum class ShaderMode {
@@ -242,6 +244,12 @@ public:
 	ShaderDescriptor GetCurrentShaderDescriptor() const;
 	ShaderMode GetCurrentShaderMode() const;
 
+	/*
+	 * Names of all shaders the current adaptive shader mode might switch
+	 * to. Empty if shader auto-switching is disabled.
+	 */
+	std::vector<std::string> GetAdaptiveShaderNames() const;
+
 private:
 	ShaderManager()  = default;
 	~ShaderManager() = default;
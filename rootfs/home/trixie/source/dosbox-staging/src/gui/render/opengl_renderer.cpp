@@ -10,6 +10,8 @@
 
 #include "capture/capture.h"
 #include "dosbox_config.h"
+#include "hardware/timer.h"
+#include "misc/cross.h"
 #include "misc/support.h"
 #include "misc/video.h"
 #include "utils/checks.h"
@@ -23,6 +25,9 @@
 #include <SDL_opengl.h>
 #include <SDL_syswm.h>
 
+#include <cinttypes>
+#include <fstream>
+
 CHECK_NARROWING();
 
 // #define DEBUG_OPENGL
@@ -32,6 +37,50 @@ constexpr auto GlslExtension = ".glsl";
 
 constexpr auto ImageAdjustmentsShaderName = "_internal/image-adjustments-pass";
 
+// Number of presented frames to average the upload & present timings over
+constexpr auto TimingStatsNumFrames = 600;
+
+// Program binaries are core since OpenGL 4.1 and available through the
+// GL_ARB_get_program_binary extension before that. Our Glad loader is
+// generated for OpenGL 3.3, so we load these entry points ourselves.
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+using GetProgramBinaryFunc = void(GLAD_API_PTR*)(GLuint program, GLsizei buf_size,
+                                                 GLsizei* length,
+                                                 GLenum* binary_format,
+                                                 void* binary);
+
+using ProgramBinaryFunc = void(GLAD_API_PTR*)(GLuint program, GLenum binary_format,
+                                              const void* binary, GLsizei length);
+
+using ProgramParameteriFunc = void(GLAD_API_PTR*)(GLuint program,
+                                                  GLenum pname, GLint value);
+
+static GetProgramBinaryFunc get_program_binary   = nullptr;
+static ProgramBinaryFunc program_binary          = nullptr;
+static ProgramParameteriFunc program_parameter_i = nullptr;
+
+constexpr auto ProgramBinaryCacheDir = "shader-cache";
+
+// Bump this if the layout of the program binary cache files changes
+constexpr uint32_t ProgramBinaryMagic   = 0x42505344; // 'DSPB'
+constexpr uint32_t ProgramBinaryVersion = 1;
+
+struct ProgramBinaryHeader {
+	uint32_t magic   = ProgramBinaryMagic;
+	uint32_t version = ProgramBinaryVersion;
+	uint32_t format  = 0;
+	uint32_t length  = 0;
+};
+
 // A safe wrapper around that returns the default result on failure
 static const char* safe_gl_get_string(const GLenum requested_name,
                                       const char* default_result = "")
@@ -146,6 +195,8 @@ bool OpenGlRenderer::InitRenderer()
 	         safe_gl_get_string(GL_SHADING_LANGUAGE_VERSION, "unknown"),
 	         safe_gl_get_string(GL_VENDOR, "unknown"));
 
+	InitProgramBinaryCache();
+
 	// Vertex data of a single oversized triangle encompassing the viewport
 	// Lower left
 	vertex_data[0] = -1.0f;
@@ -203,11 +254,15 @@ bool OpenGlRenderer::InitRenderer()
 
 OpenGlRenderer::~OpenGlRenderer()
 {
+	StopShaderPrecompilation();
+
 	SDL_GL_ResetAttributes();
 
 	glDeleteVertexArrays(1, &vao);
 	glDeleteBuffers(1, &vbo);
 
+	DeleteUploadBuffers();
+
 	if (pass1.in_texture) {
 		glDeleteTextures(1, &pass1.in_texture);
 		pass1.in_texture = 0;
@@ -389,20 +444,55 @@ void OpenGlRenderer::RecreatePass1InputTextureAndRenderBuffer()
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 
-	// Allocate host memory buffers for the texture data. The video card
-	// emulation will write to these buffers, then we'll copy the data to
-	// the texture in GPU memory with `glTexSubImage2D()` before presenting
-	// the frame.
+	// Allocate the host memory buffer for the texture data. The video card
+	// emulation will write to this buffer, then we'll copy each finished
+	// frame into one of the upload buffers and update the texture in GPU
+	// memory from there before presenting the frame.
 	const auto pitch_pixels = pass1.width;
 	const auto num_pixels = static_cast<size_t>(pitch_pixels) * pass1.height;
 
 	curr_framebuf.resize(num_pixels);
-	last_framebuf.resize(num_pixels);
 
 	constexpr auto BytesPerPixel = sizeof(uint32_t);
 	const auto pitch_bytes       = pitch_pixels * BytesPerPixel;
 
 	pass1.in_texture_pitch = check_cast<int>(pitch_bytes);
+
+	upload_buffer_size = num_pixels * BytesPerPixel;
+	RecreateUploadBuffers();
+}
+
+void OpenGlRenderer::RecreateUploadBuffers()
+{
+	DeleteUploadBuffers();
+
+	for (auto& buffer : upload_buffers) {
+		glGenBuffers(1, &buffer.pbo);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER,
+		             check_cast<GLsizeiptr>(upload_buffer_size),
+		             nullptr,
+		             GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	next_upload_buffer  = 0;
+	last_upload_buffer  = 0;
+	last_framebuf_dirty = false;
+}
+
+void OpenGlRenderer::DeleteUploadBuffers()
+{
+	for (auto& buffer : upload_buffers) {
+		if (buffer.fence) {
+			glDeleteSync(buffer.fence);
+			buffer.fence = nullptr;
+		}
+		if (buffer.pbo) {
+			glDeleteBuffers(1, &buffer.pbo);
+			buffer.pbo = 0;
+		}
+	}
 }
 
 void OpenGlRenderer::RecreatePass1OutputTexture()
@@ -465,24 +555,71 @@ void OpenGlRenderer::StartFrame(uint32_t*& pixels_out, int& pitch_out)
 void OpenGlRenderer::EndFrame()
 {
 	assert(!curr_framebuf.empty());
-	assert(!last_framebuf.empty());
 
-	// We need to copy the buffers. We can't just swap them because the VGA
-	// emulation only writes the changed pixels to the framebuffer in each
-	// frame.
+	const auto start_us = GetTicksUs();
+
+	// We need to copy the framebuffer. We can't render directly into the
+	// upload buffers because the VGA emulation only writes the changed
+	// pixels to the framebuffer in each frame.
+
+	auto& buffer = upload_buffers[next_upload_buffer];
+	assert(buffer.pbo);
 
-	last_framebuf       = curr_framebuf;
+	// The buffer was last uploaded from a few frames ago, so this is
+	// normally signalled already.
+	if (buffer.fence) {
+		constexpr GLuint64 TimeoutNs = 1'000'000'000;
+		glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, TimeoutNs);
+		glDeleteSync(buffer.fence);
+		buffer.fence = nullptr;
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+
+	// Invalidating the whole buffer lets the driver orphan the storage
+	// if it's still in use instead of waiting for it.
+	constexpr GLbitfield MapFlags = GL_MAP_WRITE_BIT |
+	                                GL_MAP_INVALIDATE_BUFFER_BIT |
+	                                GL_MAP_UNSYNCHRONIZED_BIT;
+
+	auto dest = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+	                             0,
+	                             check_cast<GLsizeiptr>(upload_buffer_size),
+	                             MapFlags);
+	if (dest) {
+		std::memcpy(dest, curr_framebuf.data(), upload_buffer_size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	} else {
+		glBufferSubData(GL_PIXEL_UNPACK_BUFFER,
+		                0,
+		                check_cast<GLsizeiptr>(upload_buffer_size),
+		                curr_framebuf.data());
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	last_upload_buffer  = next_upload_buffer;
+	next_upload_buffer  = (next_upload_buffer + 1) % NumUploadBuffers;
 	last_framebuf_dirty = true;
+
+	timing_stats.upload_us += GetTicksUsSince(start_us);
 }
 
 void OpenGlRenderer::PrepareFrame()
 {
-	assert(!last_framebuf.empty());
-
 	if (last_framebuf_dirty) {
+		const auto start_us = GetTicksUs();
+
+		auto& buffer = upload_buffers[last_upload_buffer];
+		assert(buffer.pbo);
+
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, pass1.in_texture);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
 
+		// With a pixel unpack buffer bound the data pointer is an
+		// offset into the buffer and the call returns without waiting
+		// for the copy to complete.
 		glTexSubImage2D(GL_TEXTURE_2D,
 		                0,            // mimap level (0 = base image)
 		                0,            // x offset
@@ -491,14 +628,22 @@ void OpenGlRenderer::PrepareFrame()
 		                pass1.height, // height
 		                GL_BGRA,      // pixel data format
 		                GL_UNSIGNED_INT_8_8_8_8_REV, // pixel data type
-		                last_framebuf.data() // pointer to image data
+		                nullptr // offset into the pixel unpack buffer
 		);
 
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 		glBindTexture(GL_TEXTURE_2D, 0);
 
+		if (buffer.fence) {
+			glDeleteSync(buffer.fence);
+		}
+		buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
 		++frame_count;
 
 		last_framebuf_dirty = false;
+
+		timing_stats.upload_us += GetTicksUsSince(start_us);
 	}
 }
 
@@ -564,6 +709,8 @@ void OpenGlRenderer::RenderPass2()
 
 void OpenGlRenderer::PresentFrame()
 {
+	const auto start_us = GetTicksUs();
+
 	RenderPass1();
 	RenderPass2();
 
@@ -579,6 +726,18 @@ void OpenGlRenderer::PresentFrame()
 
 	// Present frame
 	SDL_GL_SwapWindow(window);
+
+	timing_stats.present_us += GetTicksUsSince(start_us);
+
+	if (++timing_stats.num_frames == TimingStatsNumFrames) {
+		LOG_DEBUG("OPENGL: Average frame upload time: %.3f ms, present time: %.3f ms",
+		          0.001 * static_cast<double>(timing_stats.upload_us) /
+		                  TimingStatsNumFrames,
+		          0.001 * static_cast<double>(timing_stats.present_us) /
+		                  TimingStatsNumFrames);
+
+		timing_stats = {};
+	}
 }
 
 std::optional<GLuint> OpenGlRenderer::BuildShader(const GLenum type,
@@ -663,6 +822,11 @@ std::optional<GLuint> OpenGlRenderer::BuildShaderProgram(const std::string& shad
 		return {};
 	}
 
+	if (const auto maybe_program = LoadProgramBinary(shader_source);
+	    maybe_program) {
+		return *maybe_program;
+	}
+
 	const auto maybe_vertex_shader = BuildShader(GL_VERTEX_SHADER, shader_source);
 	if (!maybe_vertex_shader) {
 		LOG_ERR("OPENGL: Error compiling vertex shader");
@@ -691,6 +855,12 @@ std::optional<GLuint> OpenGlRenderer::BuildShaderProgram(const std::string& shad
 	glAttachShader(shader_program, vertex_shader);
 	glAttachShader(shader_program, fragment_shader);
 
+	if (!program_binary_cache_dir.empty()) {
+		program_parameter_i(shader_program,
+		                    GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+		                    GL_TRUE);
+	}
+
 	glLinkProgram(shader_program);
 
 	glDeleteShader(vertex_shader);
@@ -727,9 +897,359 @@ std::optional<GLuint> OpenGlRenderer::BuildShaderProgram(const std::string& shad
 		return {};
 	}
 
+	SaveProgramBinary(shader_source, shader_program);
+
 	return shader_program;
 }
 
+void OpenGlRenderer::InitProgramBinaryCache()
+{
+	program_binary_cache_dir.clear();
+
+	driver_id = format_str("%s\n%s\n%s",
+	                       safe_gl_get_string(GL_VENDOR),
+	                       safe_gl_get_string(GL_RENDERER),
+	                       safe_gl_get_string(GL_VERSION));
+
+	GLint major = 0;
+	GLint minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+	const auto is_core_feature = (major > 4 || (major == 4 && minor >= 1));
+
+	if (!is_core_feature &&
+	    !SDL_GL_ExtensionSupported("GL_ARB_get_program_binary")) {
+		return;
+	}
+
+	get_program_binary = reinterpret_cast<GetProgramBinaryFunc>(
+	        SDL_GL_GetProcAddress("glGetProgramBinary"));
+	program_binary = reinterpret_cast<ProgramBinaryFunc>(
+	        SDL_GL_GetProcAddress("glProgramBinary"));
+	program_parameter_i = reinterpret_cast<ProgramParameteriFunc>(
+	        SDL_GL_GetProcAddress("glProgramParameteri"));
+
+	if (!get_program_binary || !program_binary || !program_parameter_i) {
+		return;
+	}
+
+	// Drivers are allowed to support the extension without offering any
+	// binary formats
+	GLint num_formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+	if (num_formats <= 0) {
+		return;
+	}
+
+	program_binary_cache_dir = get_config_dir() / ProgramBinaryCacheDir;
+}
+
+// The cache key covers the driver identification as well as the shader
+// source, so binaries are never fed to a different driver or GPU. Editing a
+// shader simply results in a new cache entry.
+std_fs::path OpenGlRenderer::GetProgramBinaryPath(const std::string& shader_source) const
+{
+	// 64-bit FNV-1a
+	uint64_t hash = 0xcbf29ce484222325;
+
+	auto add_to_hash = [&](const std::string& str) {
+		for (const auto c : str) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001b3;
+		}
+	};
+	add_to_hash(driver_id);
+	add_to_hash(shader_source);
+
+	return program_binary_cache_dir /
+	       format_str("%016" PRIx64 ".bin", hash);
+}
+
+std::optional<GLuint> OpenGlRenderer::LoadProgramBinary(const std::string& shader_source) const
+{
+	if (program_binary_cache_dir.empty()) {
+		return {};
+	}
+
+	const auto path = GetProgramBinaryPath(shader_source);
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return {};
+	}
+
+	ProgramBinaryHeader header = {};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	// Don't trust the length in the header, a truncated or corrupted file
+	// could make us allocate an arbitrary amount of memory
+	std::error_code size_ec = {};
+	const auto file_size    = std_fs::file_size(path, size_ec);
+
+	const auto is_length_valid = !size_ec && header.length > 0 &&
+	                             file_size >= sizeof(header) &&
+	                             header.length == file_size - sizeof(header);
+
+	std::vector<char> binary = {};
+
+	if (file && header.magic == ProgramBinaryMagic &&
+	    header.version == ProgramBinaryVersion && is_length_valid) {
+		binary.resize(header.length);
+		file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+	}
+
+	const auto is_valid_file = file && !binary.empty();
+	file.close();
+
+	const GLuint shader_program = is_valid_file ? glCreateProgram() : 0;
+
+	if (shader_program) {
+		program_binary(shader_program,
+		               header.format,
+		               binary.data(),
+		               static_cast<GLsizei>(binary.size()));
+
+		// Drivers reject binaries after driver updates and the like; we
+		// then rebuild the program from the source and replace the file
+		GLint is_program_linked = GL_FALSE;
+		glGetProgramiv(shader_program, GL_LINK_STATUS, &is_program_linked);
+
+		if (is_program_linked) {
+#ifdef DEBUG_OPENGL
+			LOG_DEBUG("OPENGL: Loaded shader program binary '%s'",
+			          path.string().c_str());
+#endif
+			return shader_program;
+		}
+		glDeleteProgram(shader_program);
+	}
+
+	std::error_code ec = {};
+	std_fs::remove(path, ec);
+
+	return {};
+}
+
+void OpenGlRenderer::SaveProgramBinary(const std::string& shader_source,
+                                       const GLuint shader_program) const
+{
+	if (program_binary_cache_dir.empty()) {
+		return;
+	}
+
+	GLint length = 0;
+	glGetProgramiv(shader_program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+
+	std::vector<char> binary(static_cast<size_t>(length));
+
+	GLsizei bytes_written = 0;
+	GLenum format         = 0;
+	get_program_binary(shader_program, length, &bytes_written, &format, binary.data());
+
+	if (bytes_written <= 0) {
+		return;
+	}
+
+	std::error_code ec = {};
+	std_fs::create_directories(program_binary_cache_dir, ec);
+	if (ec) {
+		return;
+	}
+
+	ProgramBinaryHeader header = {};
+	header.format = format;
+	header.length = static_cast<uint32_t>(bytes_written);
+
+	// Write to a temporary file first so a crash or a full disk never
+	// leaves a truncated binary behind under the final name
+	const auto path = GetProgramBinaryPath(shader_source);
+
+	auto temp_path = path;
+	temp_path += ".tmp";
+
+	std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(binary.data(), bytes_written);
+	file.close();
+
+	if (!file) {
+		std_fs::remove(temp_path, ec);
+		return;
+	}
+
+	std_fs::rename(temp_path, path, ec);
+	if (ec) {
+		std_fs::remove(temp_path, ec);
+	}
+}
+
+void OpenGlRenderer::MaybeStartShaderPrecompilation()
+{
+#if defined(MACOSX)
+	// NSOpenGLContext calls on secondary threads may need to synchronise
+	// with the main thread, which risks deadlocking on shutdown; the
+	// program binary cache still avoids most of the compile stalls
+	return;
+#else
+	if (precompile_context) {
+		// Already started
+		return;
+	}
+
+	auto& shader_manager = ShaderManager::GetInstance();
+
+	// Loading the sources through the shader manager must happen on the
+	// main thread; only the compilation runs in the background
+	std::vector<std::pair<ShaderInfo, std::string>> shaders = {};
+
+	for (const auto& name : shader_manager.GetAdaptiveShaderNames()) {
+		if (shader_cache.contains(name)) {
+			continue;
+		}
+		if (auto maybe_result = shader_manager.LoadShader(name, GlslExtension);
+		    maybe_result) {
+			shaders.emplace_back(std::move(*maybe_result));
+		}
+	}
+
+	if (shaders.empty()) {
+		return;
+	}
+
+	// The worker context needs a drawable of its own; a hidden window is
+	// the portable way to get one
+	precompile_window = SDL_CreateWindow("",
+	                                     SDL_WINDOWPOS_UNDEFINED,
+	                                     SDL_WINDOWPOS_UNDEFINED,
+	                                     1,
+	                                     1,
+	                                     SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+	if (!precompile_window) {
+		return;
+	}
+
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+	precompile_context = SDL_GL_CreateContext(precompile_window);
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+
+	// Creating a context makes it current
+	SDL_GL_MakeCurrent(window, context);
+
+	if (!precompile_context) {
+		LOG_WARNING("OPENGL: Error creating shader precompilation context: %s",
+		            SDL_GetError());
+
+		SDL_DestroyWindow(precompile_window);
+		precompile_window = {};
+		return;
+	}
+
+	{
+		std::lock_guard lock(precompile_mutex);
+		for (const auto& [shader_info, _] : shaders) {
+			pending_precompiles.push_back(shader_info.name);
+		}
+	}
+
+	precompile_thread = std::thread(&OpenGlRenderer::PrecompileShaders,
+	                                this,
+	                                std::move(shaders));
+#endif
+}
+
+void OpenGlRenderer::PrecompileShaders(std::vector<std::pair<ShaderInfo, std::string>> shaders)
+{
+	const auto is_current = (SDL_GL_MakeCurrent(precompile_window,
+	                                            precompile_context) == 0);
+
+	for (const auto& [shader_info, shader_source] : shaders) {
+		std::optional<Shader> maybe_shader = {};
+
+		if (is_current && !stop_precompiling) {
+			if (const auto maybe_program = BuildShaderProgram(shader_source);
+			    maybe_program) {
+				maybe_shader = Shader{shader_info, *maybe_program};
+			}
+
+			// The program must be complete before other contexts
+			// may use it
+			glFinish();
+		}
+
+		{
+			std::lock_guard lock(precompile_mutex);
+			precompiled_shaders[shader_info.name] = maybe_shader;
+		}
+		precompile_done.notify_all();
+
+#ifdef DEBUG_OPENGL
+		if (maybe_shader) {
+			LOG_DEBUG("OPENGL: Precompiled shader '%s'",
+			          shader_info.name.c_str());
+		}
+#endif
+	}
+
+	if (is_current) {
+		SDL_GL_MakeCurrent(precompile_window, nullptr);
+	}
+}
+
+std::optional<OpenGlRenderer::Shader> OpenGlRenderer::TakePrecompiledShader(
+        const std::string& shader_name)
+{
+	std::unique_lock lock(precompile_mutex);
+
+	if (!contains(pending_precompiles, shader_name)) {
+		return {};
+	}
+
+	// Wait for the shader if it's still being built; that's never slower
+	// than building it again on the main thread
+	precompile_done.wait(lock, [&] {
+		return precompiled_shaders.contains(shader_name);
+	});
+
+	auto maybe_shader = precompiled_shaders[shader_name];
+
+	precompiled_shaders.erase(shader_name);
+	std::erase(pending_precompiles, shader_name);
+
+	return maybe_shader;
+}
+
+void OpenGlRenderer::StopShaderPrecompilation()
+{
+	stop_precompiling = true;
+
+	if (precompile_thread.joinable()) {
+		precompile_thread.join();
+	}
+
+	// Programs are shared between the contexts, so we can delete the
+	// ones nobody took from the main context
+	for (auto& [_, maybe_shader] : precompiled_shaders) {
+		if (maybe_shader) {
+			glDeleteProgram(maybe_shader->program_object);
+		}
+	}
+	precompiled_shaders.clear();
+	pending_precompiles.clear();
+
+	if (precompile_context) {
+		SDL_GL_DeleteContext(precompile_context);
+		precompile_context = {};
+	}
+	if (precompile_window) {
+		SDL_DestroyWindow(precompile_window);
+		precompile_window = {};
+	}
+}
+
 OpenGlRenderer::SetShaderResult OpenGlRenderer::SetShader(const std::string& shader_descriptor)
 {
 	return SetShaderInternal(shader_descriptor);
@@ -754,6 +1274,10 @@ OpenGlRenderer::SetShaderResult OpenGlRenderer::SetShaderInternal(
 		return ShaderError;
 	}
 
+	// Build the other shaders the adaptive mode might switch to in the
+	// background, now that the current one is ready
+	MaybeStartShaderPrecompilation();
+
 	if (!new_descriptor.preset_name.empty() &&
 	    current_shader_descriptor.preset_name.empty()) {
 
@@ -944,7 +1468,18 @@ std::optional<OpenGlRenderer::Shader> OpenGlRenderer::GetOrLoadAndCacheShader(
         const std::string& shader_name)
 {
 	if (!shader_cache.contains(shader_name)) {
-		const auto maybe_shader = LoadAndBuildShader(shader_name);
+		// Precompiled shaders were loaded for the adaptive mode, so only
+		// use them while it's active
+		auto maybe_shader = TakePrecompiledShader(shader_name);
+
+		if (maybe_shader && ShaderManager::GetInstance().GetCurrentShaderMode() ==
+		                            ShaderMode::Single) {
+			glDeleteProgram(maybe_shader->program_object);
+			maybe_shader = {};
+		}
+		if (!maybe_shader) {
+			maybe_shader = LoadAndBuildShader(shader_name);
+		}
 		if (!maybe_shader) {
 			return {};
 		}
@@ -10,13 +10,19 @@
 
 #include "gui/private/shader_manager.h"
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #include "dosbox_config.h"
 #include "gui/render/render.h"
+#include "misc/std_filesystem.h"
 #include "misc/video.h"
 #include "utils/rect.h"
 
@@ -111,6 +117,16 @@ private:
 	std::optional<GLuint> BuildShader(const GLenum type,
 	                                  const std::string& source) const;
 
+	void InitProgramBinaryCache();
+	std_fs::path GetProgramBinaryPath(const std::string& source) const;
+	std::optional<GLuint> LoadProgramBinary(const std::string& source) const;
+	void SaveProgramBinary(const std::string& source, const GLuint program) const;
+
+	void MaybeStartShaderPrecompilation();
+	void StopShaderPrecompilation();
+	void PrecompileShaders(std::vector<std::pair<ShaderInfo, std::string>> shaders);
+	std::optional<Shader> TakePrecompiledShader(const std::string& shader_name);
+
 	void GetPass1UniformLocations();
 	void UpdatePass1Uniforms();
 
@@ -118,6 +134,8 @@ private:
 	void UpdatePass2Uniforms();
 
 	void RecreatePass1InputTextureAndRenderBuffer();
+	void RecreateUploadBuffers();
+	void DeleteUploadBuffers();
 	void RecreatePass1OutputTexture();
 	void SetPass1OutputTextureFiltering();
 
@@ -142,12 +160,41 @@ private:
 	//
 	std::vector<uint32_t> curr_framebuf = {};
 
-	// Contains the last fully rendered frame, waiting to be presented.
-	std::vector<uint32_t> last_framebuf = {};
+	// Ring of pixel buffer objects the finished frames are copied into.
+	// The texture update is then sourced from the buffer, so the driver can
+	// perform it asynchronously instead of copying the frame from client
+	// memory before `glTexSubImage2D()` returns. Each buffer is fenced after
+	// its upload is issued, and it's only written again once the fence has
+	// signalled.
+	static constexpr int NumUploadBuffers = 3;
+
+	struct UploadBuffer {
+		GLuint pbo   = 0;
+		GLsync fence = nullptr;
+	};
+
+	std::array<UploadBuffer, NumUploadBuffers> upload_buffers = {};
+
+	size_t upload_buffer_size = 0;
+
+	// The buffer the next finished frame gets copied into
+	int next_upload_buffer = 0;
+
+	// The buffer containing the last fully rendered frame, waiting to be
+	// presented
+	int last_upload_buffer = 0;
 
 	// True if the last framebuffer has been updated since the last present
 	bool last_framebuf_dirty = false;
 
+	// Time spent on copying & uploading the frames and on presenting them,
+	// reported periodically in debug builds
+	struct {
+		int64_t upload_us  = 0;
+		int64_t present_us = 0;
+		int num_frames     = 0;
+	} timing_stats = {};
+
 	DosBox::Rect viewport_rect_px = {};
 
 	GLuint frame_count = 0;
@@ -245,6 +292,43 @@ private:
 	// Might contain the .glsl file extension if set by the user.
 	//
 	std::string current_shader_descriptor_string = {};
+
+	// ---------------------------------------------------------------------
+	// Persistent program binary cache
+	// ---------------------------------------------------------------------
+
+	// Linked programs are stored on disk keyed by a hash of the shader
+	// source and the driver identification string, so the next launch can
+	// skip compiling and linking. Only set if the driver supports program
+	// binaries.
+	std_fs::path program_binary_cache_dir = {};
+
+	std::string driver_id = {};
+
+	// ---------------------------------------------------------------------
+	// Background shader precompilation
+	// ---------------------------------------------------------------------
+
+	// When an adaptive CRT shader is selected, the shaders the
+	// auto-switching may pick are built in the background on a context
+	// sharing objects with ours, so video mode changes don't stall on
+	// compiling them.
+	SDL_Window* precompile_window    = {};
+	SDL_GLContext precompile_context = {};
+
+	std::thread precompile_thread = {};
+
+	std::atomic<bool> stop_precompiling = false;
+
+	// Guards the precompilation results below
+	std::mutex precompile_mutex = {};
+
+	std::condition_variable precompile_done = {};
+
+	// Shaders queued for precompilation that haven't been taken yet. An
+	// empty value marks a finished build that failed.
+	std::unordered_map<std::string, std::optional<Shader>> precompiled_shaders = {};
+	std::vector<std::string> pending_precompiles = {};
 };
 
 #endif // C_OPENGL
@@ -281,6 +281,16 @@ ShaderMode ShaderManager::GetCurrentShaderMode() const
 	return current_shader.mode;
 }
 
+std::vector<std::string> ShaderManager::GetAdaptiveShaderNames() const
+{
+	using namespace ShaderName;
+
+	if (current_shader.mode == ShaderMode::Single) {
+		return {};
+	}
+	return {CrtHyllian, Sharp, Vga1080p, Vga1080pFakeDoubleScan};
+}
+
 std::deque<std::string> ShaderManager::GenerateShaderInventoryMessage() const
 {
 	std::deque<std::string> inventory;
@@ -669,7 +679,7 @@ ShaderDescriptor ShaderManager::GetVgaShader() const
 
 		if (video_mode.is_double_scanned_mode &&
 		    video_mode.height <= MaxFakeDoubleScanVideoModeHeight) {
-			return {"crt/vga-1080p-fake-double-scan", ""};
+			return {Vga1080pFakeDoubleScan, ""};
 
 		} else {
 			// This shader works correctly only with exact 2x
@@ -683,7 +693,7 @@ ShaderDescriptor ShaderManager::GetVgaShader() const
 			// Double-scanned 216 to 270 line modes are also handled
 			// by this shader.
 			//
-			return {"crt/vga-1080p", ""};
+			return {Vga1080p, ""};
 		}
 	}
 	return {Sharp, ""};
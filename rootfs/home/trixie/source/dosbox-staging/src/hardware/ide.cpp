@@ -8,13 +8,17 @@
 #include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <cstring>
 
 #include "audio/mixer.h"
 #include "config/config.h"
 #include "config/setup.h"
 #include "cpu/callback.h"
 #include "cpu/cpu.h"
+#include "cpu/paging.h"
 #include "dos/cdrom.h"
+#include "hardware/memory.h"
+#include "hardware/pci_bus.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
 #include "hardware/timer.h"
@@ -28,6 +32,8 @@ static void ide_altio_w(io_port_t port, io_val_t val, io_width_t width);
 static uint32_t ide_altio_r(io_port_t port, io_width_t width);
 static void ide_baseio_w(io_port_t port, io_val_t val, io_width_t width);
 static uint32_t ide_baseio_r(io_port_t port, io_width_t width);
+static void ide_busmaster_w(io_port_t port, io_val_t val, io_width_t width);
+static uint32_t ide_busmaster_r(io_port_t port, io_width_t width);
 bool GetMSCDEXDrive(uint8_t drive_letter, CDROM_Interface **_cdrom);
 
 enum IDEDeviceType { IDE_TYPE_NONE, IDE_TYPE_HDD = 1, IDE_TYPE_CDROM };
@@ -51,6 +57,25 @@ enum {
 	IDE_STATUS_ERROR = 0x01
 };
 
+/* PCI bus master IDE registers (per channel, relative to the channel's base) */
+enum {
+	IDE_BM_COMMAND = 0x0,
+	IDE_BM_STATUS = 0x2,
+	IDE_BM_PRD_ADDRESS = 0x4
+};
+
+enum {
+	IDE_BM_COMMAND_START = 0x01,
+	IDE_BM_COMMAND_READ = 0x08 /* bus master writes to memory (device to host) */
+};
+
+enum {
+	IDE_BM_STATUS_ACTIVE = 0x01,
+	IDE_BM_STATUS_ERROR = 0x02,
+	IDE_BM_STATUS_INTERRUPT = 0x04,
+	IDE_BM_STATUS_DMA_CAPABLE = 0x60 /* both drives DMA capable */
+};
+
 class IDEController;
 
 #if 0 // unused
@@ -174,6 +199,8 @@ public:
 	virtual void prepare_write(uint32_t offset, uint32_t size);
 	virtual void io_completion();
 	virtual bool increment_current_address(uint32_t count = 1);
+	bool get_current_sector(uint32_t &sectorn);
+	void busmaster_transfer();
 
 public:
 	uint8_t sector[512 * 128] = {};
@@ -182,6 +209,7 @@ public:
 
 	uint32_t multiple_sector_max = sizeof(sector) / 512;
 	uint32_t multiple_sector_count = 1;
+	uint8_t multiword_dma_mode = 2; /* selected by SET FEATURES, reported in IDENTIFY word 63 */
 
 	uint32_t heads = 0;
 	uint32_t sects = 0;
@@ -287,8 +315,8 @@ public:
 	int IRQ = -1;
 	bool int13fakeio = false; /* on certain INT 13h calls, force IDE state as if BIOS had carried them out */
 	bool int13fakev86io = false; /* on certain INT 13h calls in virtual 8086 mode, trigger fake CPU I/O traps */
-	bool enable_pio32 = false; /* enable 32-bit PIO (if disabled, attempts at 32-bit PIO are handled as if
-	                              two 16-bit I/O) */
+	bool enable_pio32 = true; /* enable 32-bit PIO on the data port (if disabled, attempts at 32-bit PIO
+	                             are handled as if two 16-bit I/O) */
 	bool ignore_pio32 = false; /* if 32-bit PIO enabled, but ignored, writes do nothing, reads return
 	                              0xFFFFFFFF */
 	bool register_pnp = false;
@@ -299,6 +327,8 @@ public:
 	IO_ReadHandleObject ReadHandlerAlt[2] = {};
 	IO_WriteHandleObject WriteHandler[8] = {};
 	IO_WriteHandleObject WriteHandlerAlt[2] = {};
+	IO_ReadHandleObject ReadHandlerBusMaster = {};
+	IO_WriteHandleObject WriteHandlerBusMaster = {};
 
 public:
 	IDEDevice *device[2] = {nullptr, nullptr}; /* IDE devices (master, slave) */
@@ -309,6 +339,12 @@ public:
 	bool interrupt_enable = true; /* bit 1 of alt (0x3F6) */
 	bool host_reset = false;      /* bit 2 of alt */
 	bool irq_pending = false;
+	/* PCI bus master DMA (primary and secondary controllers only) */
+	bool busmaster = false;
+	bool busmaster_scheduled = false; /* transfer event pending */
+	uint8_t bm_command = 0;
+	uint8_t bm_status = 0;
+	uint32_t bm_prd_address = 0;
 	/* defaults for CD-ROM emulation */
 	double spinup_time = 0.0;
 	double spindown_timeout = 0.0;
@@ -327,6 +363,7 @@ public:
 	void uninstall_io_ports();
 	void raise_irq();
 	void lower_irq();
+	void busmaster_start();
 };
 
 static std::array<IDEController *, MAX_IDE_CONTROLLERS> idecontroller{{
@@ -1424,6 +1461,176 @@ bool IDEATADevice::increment_current_address(uint32_t n)
 	return true;
 }
 
+/* sector addressed by the task file registers, in LBA or C/H/S mode */
+bool IDEATADevice::get_current_sector(uint32_t &sectorn)
+{
+	if (drivehead_is_lba(drivehead)) {
+		/* LBA */
+		sectorn = (((uint32_t)drivehead & 0xFu) << 24u) | (uint32_t)lba[0] |
+		          ((uint32_t)lba[1] << 8u) | ((uint32_t)lba[2] << 16u);
+		return true;
+	}
+
+	/* C/H/S */
+	const uint32_t cyl = (uint32_t)lba[1] | ((uint32_t)lba[2] << 8u);
+	if (lba[0] == 0 || (uint32_t)(drivehead & 0xFu) >= heads || (uint32_t)lba[0] > sects ||
+	    cyl >= cyls) {
+		LOG_WARNING("IDE: C/H/S %u/%u/%u out of bounds %u/%u/%u", cyl, drivehead & 0xFu,
+		            (uint32_t)lba[0], cyls, heads, sects);
+		return false;
+	}
+
+	sectorn = ((drivehead & 0xFu) * sects) + (cyl * sects * heads) + ((uint32_t)lba[0] - 1u);
+	return true;
+}
+
+/* Copies between a host buffer and guest physical memory on behalf of the bus master.
+ * Pages in the first megabyte go through the same remapping the CPU sees.
+ * Returns false if any part of the range is not backed by RAM. */
+static bool busmaster_copy(PhysPt addr, uint8_t *data, uint32_t len, const bool to_memory)
+{
+	const uint64_t mem_size = (uint64_t)MEM_TotalPages() * DosPageSize;
+
+	while (len != 0) {
+		auto page = addr / DosPageSize;
+		if (page < LINK_START)
+			page = paging.firstmb[page];
+
+		const uint32_t pos_in_page = addr & (DosPageSize - 1);
+		const uint32_t chunk = std::min<uint32_t>(len, DosPageSize - pos_in_page);
+		const uint64_t host_addr = (uint64_t)page * DosPageSize + pos_in_page;
+		if (host_addr + chunk > mem_size)
+			return false;
+
+		if (to_memory)
+			std::memcpy(MemBase + host_addr, data, chunk);
+		else
+			std::memcpy(data, MemBase + host_addr, chunk);
+
+		addr += chunk;
+		data += chunk;
+		len -= chunk;
+	}
+
+	return true;
+}
+
+/* READ/WRITE DMA: move every sector of the command in one go, scattering or gathering
+ * each one through the physical region descriptor (PRD) table set up by the host.
+ * Each PRD entry is a dword physical address and a word byte count (0 = 64KB), bit 31
+ * of the second dword marks the end of the table. */
+void IDEATADevice::busmaster_transfer()
+{
+	const bool is_write = (command == 0xCA || command == 0xCB);
+
+	auto disk = getBIOSdisk();
+	if (disk == nullptr) {
+		LOG_WARNING("IDE: ATA DMA fail, bios disk N/A");
+		abort_error();
+		controller->bm_status = (controller->bm_status & ~IDE_BM_STATUS_ACTIVE) | IDE_BM_STATUS_ERROR;
+		controller->raise_irq();
+		return;
+	}
+
+	if (is_write == ((controller->bm_command & IDE_BM_COMMAND_READ) != 0))
+		LOG_WARNING("IDE: bus master direction does not match ATA DMA command %02x", command);
+
+	uint32_t sectcount = count & 0xFF;
+	if (sectcount == 0)
+		sectcount = 256;
+
+	const uint64_t mem_size = (uint64_t)MEM_TotalPages() * DosPageSize;
+
+	uint32_t prd = controller->bm_prd_address;
+	uint32_t prd_addr = 0;
+	uint32_t prd_left = 0;
+	bool prd_last = false;
+	bool failed = false;
+	bool prd_exhausted = false;
+
+	while (sectcount != 0 && !failed) {
+		uint32_t sectorn;
+		if (!get_current_sector(sectorn)) {
+			failed = true;
+			break;
+		}
+
+		if (!is_write && disk->Read_AbsoluteSector(sectorn, sector) != 0) {
+			LOG_WARNING("IDE: ATA DMA read failed");
+			failed = true;
+			break;
+		}
+
+		for (uint32_t done = 0; done < 512;) {
+			if (prd_left == 0) {
+				if (prd_last) {
+					prd_exhausted = true;
+					break;
+				}
+				/* the phys_read helpers access MemBase directly */
+				if ((uint64_t)prd + 8 > mem_size) {
+					LOG_WARNING("IDE: bus master PRD table %08x outside of memory", prd);
+					failed = true;
+					break;
+				}
+				prd_addr = phys_readd(prd) & ~1u;
+				prd_left = phys_readw(prd + 4);
+				if (prd_left == 0)
+					prd_left = 0x10000;
+				prd_last = (phys_readd(prd + 4) & 0x80000000u) != 0;
+				prd += 8;
+			}
+
+			const uint32_t chunk = std::min(512u - done, prd_left);
+			if (!busmaster_copy(prd_addr, sector + done, chunk, !is_write)) {
+				LOG_WARNING("IDE: bus master PRD region %08x outside of memory", prd_addr);
+				failed = true;
+				break;
+			}
+			prd_addr += chunk;
+			prd_left -= chunk;
+			done += chunk;
+		}
+
+		if (prd_exhausted) {
+			LOG_WARNING("IDE: bus master PRD table smaller than the transfer");
+			failed = true;
+			break;
+		}
+		if (failed)
+			break;
+
+		if (is_write && disk->Write_AbsoluteSector(sectorn, sector) != 0) {
+			LOG_WARNING("IDE: ATA DMA write failed");
+			failed = true;
+			break;
+		}
+
+		progress_count++;
+		count = check_cast<uint16_t>((count - 1) & 0xFF);
+		if (--sectcount != 0 && !increment_current_address()) {
+			LOG_WARNING("IDE: DMA advance error");
+			failed = true;
+		}
+	}
+
+	if (failed) {
+		abort_error();
+		controller->bm_status = (controller->bm_status & ~IDE_BM_STATUS_ACTIVE) | IDE_BM_STATUS_ERROR;
+		controller->raise_irq();
+		return;
+	}
+
+	/* the bus master stays active if the PRD table describes more than was transferred */
+	if (prd_last && prd_left == 0)
+		controller->bm_status &= ~IDE_BM_STATUS_ACTIVE;
+
+	status = IDE_STATUS_DRIVE_READY | IDE_STATUS_DRIVE_SEEK_COMPLETE;
+	state = IDE_DEV_READY;
+	allow_writing = true;
+	controller->raise_irq();
+}
+
 void IDEATADevice::io_completion()
 {
 	/* lower DRQ */
@@ -2065,12 +2272,14 @@ void IDEATADevice::generate_identify_device()
 		host_writew(sector + (47 * 2),
 		            check_cast<uint16_t>(0x80 | multiple_sector_max)); /* <- READ/WRITE MULTIPLE MAX SECTORS */
 
-	host_writew(sector + (48 * 2), 0x0000); /* :0  0=we do not support doubleword (32-bit) PIO */
-	host_writew(sector + (49 * 2), 0x0A00); /* :13 0=Standby timer values managed by device */
-	                                        /* :11 1=IORDY supported */
-	                                        /* :10 0=IORDY not disabled */
-	                                        /* :9  1=LBA supported */
-	                                        /* :8  0=DMA not supported */
+	host_writew(sector + (48 * 2),
+	            controller->enable_pio32 ? 0x0001 : 0x0000); /* :0  1=doubleword (32-bit) PIO supported */
+	host_writew(sector + (49 * 2),
+	            controller->busmaster ? 0x0B00 : 0x0A00); /* :13 0=Standby timer values managed by device */
+	                                                      /* :11 1=IORDY supported */
+	                                                      /* :10 0=IORDY not disabled */
+	                                                      /* :9  1=LBA supported */
+	                                                      /* :8  1=DMA supported (if bus master) */
 	host_writew(sector + (50 * 2), 0x4000); /* TBD: ??? */
 	host_writew(sector + (51 * 2), 0x00F0); /* PIO data transfer cycle timing mode */
 	host_writew(sector + (52 * 2), 0x00F0); /* DMA data transfer cycle timing mode */
@@ -2090,8 +2299,11 @@ void IDEATADevice::generate_identify_device()
 
 	host_writed(sector + (60 * 2), check_cast<uint16_t>(ptotal)); /* total user addressable sectors (LBA) */
 	host_writew(sector + (62 * 2), 0x0000);                       /* TBD: ??? */
-	host_writew(sector + (63 * 2), 0x0000); /* :10 0=Multiword DMA mode 2 not selected */
-	                                        /* TBD: Basically, we don't do DMA. Fill out this comment */
+	if (controller->busmaster)
+		host_writew(sector + (63 * 2), /* 10:8 multiword DMA mode selected */
+		            check_cast<uint16_t>(0x0007 | (0x0100 << multiword_dma_mode))); /* 2:0 modes 0-2 supported */
+	else
+		host_writew(sector + (63 * 2), 0x0000); /* no multiword DMA */
 	host_writew(sector + (64 * 2), 0x0003); /* 7:0 PIO modes supported (TBD: ???) */
 	host_writew(sector + (65 * 2), 0x0000); /* TBD: ??? */
 	host_writew(sector + (66 * 2), 0x0000); /* TBD: ??? */
@@ -3290,6 +3502,14 @@ static void IDE_DelayedCommand(uint32_t idx /*which IDE controller*/)
 			dev->controller->raise_irq();
 			break;
 
+		case 0xC8: /* READ DMA */
+		case 0xC9: /* READ DMA WITHOUT RETRY */
+		case 0xCA: /* WRITE DMA */
+		case 0xCB: /* WRITE DMA WITHOUT RETRY */
+			dev->controller->busmaster_scheduled = false;
+			ata->busmaster_transfer();
+			break;
+
 		case 0xEC: /*IDENTIFY DEVICE (CONTINUED) */
 			dev->state = IDE_DEV_DATA_READ;
 			dev->status = IDE_STATUS_DRQ | IDE_STATUS_DRIVE_READY | IDE_STATUS_DRIVE_SEEK_COMPLETE;
@@ -3355,6 +3575,8 @@ static void IDE_DelayedCommand(uint32_t idx /*which IDE controller*/)
 void IDEController::raise_irq()
 {
 	irq_pending = true;
+	if (busmaster)
+		bm_status |= IDE_BM_STATUS_INTERRUPT;
 	if (IRQ >= 0 && interrupt_enable)
 		PIC_ActivateIRQ(check_cast<uint8_t>(IRQ));
 }
@@ -3366,6 +3588,30 @@ void IDEController::lower_irq()
 		PIC_DeActivateIRQ(check_cast<uint8_t>(IRQ));
 }
 
+/* begin the DMA transfer once both the ATA command has been issued and the host
+ * has set the start bit of the bus master */
+void IDEController::busmaster_start()
+{
+	if (!busmaster || busmaster_scheduled || !(bm_command & IDE_BM_COMMAND_START))
+		return;
+
+	const auto dev = device[select];
+	if (dev == nullptr || dev->type != IDE_TYPE_HDD || dev->state != IDE_DEV_BUSY)
+		return;
+
+	switch (dev->command) {
+	case 0xC8: /* READ DMA */
+	case 0xC9: /* READ DMA WITHOUT RETRY */
+	case 0xCA: /* WRITE DMA */
+	case 0xCB: /* WRITE DMA WITHOUT RETRY */
+		bm_status |= IDE_BM_STATUS_ACTIVE;
+		busmaster_scheduled = true;
+		PIC_AddEvent(IDE_DelayedCommand, (dev->faked_command ? 0.000001 : 0.1) /*ms*/, interface_index);
+		break;
+	default: break;
+	}
+}
+
 IDEController *match_ide_controller(io_port_t port)
 {
 	for (uint32_t i = 0; i < MAX_IDE_CONTROLLERS; i++) {
@@ -3697,6 +3943,43 @@ void IDEATADevice::writecommand(uint8_t cmd)
 		status = IDE_STATUS_DRIVE_READY | IDE_STATUS_DRQ;
 		prepare_write(0UL, 512UL * std::min(multiple_sector_count, (count == 0 ? 256u : count)));
 		break;
+	case 0xC8: /* READ DMA */
+	case 0xC9: /* READ DMA WITHOUT RETRY */
+	case 0xCA: /* WRITE DMA */
+	case 0xCB: /* WRITE DMA WITHOUT RETRY */
+		if (!controller->busmaster) {
+			abort_error();
+			controller->raise_irq();
+			break;
+		}
+		/* the drive stays busy until the host starts the bus master, which may
+		 * happen before or after the command is written */
+		progress_count = 0;
+		state = IDE_DEV_BUSY;
+		status = IDE_STATUS_BUSY;
+		controller->busmaster_start();
+		break;
+	case 0xEF: /* SET FEATURES */
+		if (feature == 0x03) { /* set transfer mode */
+			const auto mode = count & 0xFF;
+			if (mode <= 0x01 || (mode >= 0x08 && mode <= 0x0C)) {
+				/* PIO mode, nothing to do */
+			} else if (controller->busmaster && mode >= 0x20 && mode <= 0x22) {
+				multiword_dma_mode = check_cast<uint8_t>(mode & 7);
+			} else {
+				abort_error();
+				controller->raise_irq();
+				break;
+			}
+		} else if (feature != 0x02 && feature != 0x82) { /* write cache enable/disable are accepted */
+			abort_error();
+			controller->raise_irq();
+			break;
+		}
+		status = IDE_STATUS_DRIVE_READY | IDE_STATUS_DRIVE_SEEK_COMPLETE;
+		controller->raise_irq();
+		allow_writing = true;
+		break;
 	case 0xC6: /* SET MULTIPLE MODE */
 		/* only sector counts 1, 2, 4, 8, 16, 32, 64, and 128 are legal by standard.
 		 * NTS: There's a bug in VirtualBox that makes 0 legal too! */
@@ -3765,6 +4048,74 @@ void IDEDevice::select(uint8_t ndh, bool switched_to)
 	//  state = IDE_DEV_READY;
 }
 
+/* PCI function of the IDE controller, modelled after the PIIX3 IDE interface.
+ * Both channels run in legacy (compatibility) mode at the usual ports and IRQs,
+ * the PCI function only adds the bus master registers at a fixed I/O address. */
+struct PCI_IDEControllerDevice : public PCI_Device {
+	enum : uint16_t {
+		vendor = 0x8086,
+		device = 0x7010,
+	};
+
+	PCI_IDEControllerDevice() : PCI_Device(vendor, device) {}
+
+	bool InitializeRegisters(uint8_t registers[256]) override;
+	Bits ParseReadRegister(uint8_t regnum) override;
+	bool OverrideReadRegister(uint8_t regnum, uint8_t *rval, uint8_t *rval_mask) override;
+	Bits ParseWriteRegister(uint8_t regnum, uint8_t value) override;
+};
+
+bool PCI_IDEControllerDevice::InitializeRegisters(uint8_t registers[256])
+{
+	registers[0x04] = 0x05; // command register (I/O space, bus master)
+	registers[0x05] = 0x00;
+	registers[0x06] = 0x80; // status register (fast back-to-back)
+	registers[0x07] = 0x02; // medium DEVSEL timing
+
+	registers[0x08] = 0x00; // card revision
+	registers[0x09] = 0x80; // programming interface (bus master, both channels legacy)
+	registers[0x0a] = 0x01; // subclass code (IDE)
+	registers[0x0b] = 0x01; // class code (mass storage)
+	registers[0x0c] = 0x00; // cache line size
+	registers[0x0d] = 0x00; // latency timer
+	registers[0x0e] = 0x00; // header type (other)
+
+	registers[0x3c] = 0xff; // no IRQ, the channels use IRQ 14 and 15
+
+	constexpr auto port_num = static_cast<uint16_t>(port_num_ide_busmaster);
+	// BAR 4
+	registers[0x20] = static_cast<uint8_t>((port_num & 0xf0) + 1);
+	registers[0x21] = static_cast<uint8_t>((port_num >> 8) & 0xff);
+	registers[0x22] = 0;
+	registers[0x23] = 0;
+
+	// IDE timing registers, IDE decode enabled for both channels
+	registers[0x41] = 0x80;
+	registers[0x43] = 0x80;
+
+	return true;
+}
+
+Bits PCI_IDEControllerDevice::ParseReadRegister(uint8_t regnum)
+{
+	return regnum;
+}
+
+bool PCI_IDEControllerDevice::OverrideReadRegister([[maybe_unused]] uint8_t regnum,
+                                                   [[maybe_unused]] uint8_t *rval,
+                                                   [[maybe_unused]] uint8_t *rval_mask)
+{
+	return false;
+}
+
+Bits PCI_IDEControllerDevice::ParseWriteRegister(uint8_t regnum, uint8_t value)
+{
+	// drivers may tune the timing registers, everything else is fixed
+	if (regnum >= 0x40 && regnum <= 0x44)
+		return value;
+	return -1;
+}
+
 IDEController::IDEController(const uint8_t index,
                              const uint8_t irq,
                              const uint16_t port,
@@ -3802,6 +4153,12 @@ IDEController::IDEController(const uint8_t index,
 	LOG_MSG("IDE: Created %s controller IRQ %d, base I/O port %03xh, alternate I/O port %03xh",
 	        get_controller_name(index), IRQ, base_io, alt_io);
 
+	/* the primary and secondary channels are the legacy mode channels of the
+	 * PCI IDE function, which provides them with bus master DMA */
+	busmaster = (index < 2);
+	if (index == 0)
+		PCI_AddDevice(new PCI_IDEControllerDevice());
+
 	install_io_ports();
 	PIC_SetIRQMask((uint32_t)IRQ, false);
 
@@ -3824,6 +4181,12 @@ void IDEController::install_io_ports()
 		WriteHandlerAlt[1].Install(alt_io + 1u, ide_altio_w, io_width_t::dword);
 		ReadHandlerAlt[1].Install(alt_io + 1u, ide_altio_r, io_width_t::dword);
 	}
+
+	if (busmaster) {
+		const auto port = check_cast<io_port_t>(port_num_ide_busmaster + interface_index * 8u);
+		WriteHandlerBusMaster.Install(port, ide_busmaster_w, io_width_t::dword, 8);
+		ReadHandlerBusMaster.Install(port, ide_busmaster_r, io_width_t::dword, 8);
+	}
 }
 
 void IDEController::uninstall_io_ports()
@@ -3841,6 +4204,9 @@ void IDEController::uninstall_io_ports()
 		h.Uninstall();
 	for (auto & h : ReadHandlerAlt)
 		h.Uninstall();
+
+	WriteHandlerBusMaster.Uninstall();
+	ReadHandlerBusMaster.Uninstall();
 }
 
 IDEController::~IDEController()
@@ -3848,6 +4214,9 @@ IDEController::~IDEController()
 	lower_irq();
 	uninstall_io_ports();
 
+	if (interface_index == 0)
+		PCI_RemoveDevice(PCI_IDEControllerDevice::vendor, PCI_IDEControllerDevice::device);
+
 	for (auto &d : device) {
 		delete d;
 		d = nullptr;
@@ -3937,7 +4306,8 @@ static uint32_t ide_baseio_r(io_port_t port, io_width_t width)
 		return UINT32_MAX;
 	}
 
-	if (!ide->enable_pio32 && width == io_width_t::dword)
+	/* only the data port is 32 bits wide */
+	if ((!ide->enable_pio32 || (port & 7) != 0) && width == io_width_t::dword)
 		return ide_baseio_r(port, io_width_t::word) + (ide_baseio_r(port + 2, io_width_t::word) << 16);
 	else if (ide->ignore_pio32 && width == io_width_t::dword)
 		return UINT32_MAX;
@@ -3981,7 +4351,8 @@ static void ide_baseio_w(io_port_t port, io_val_t val, io_width_t width)
 		return;
 	}
 
-	if (!ide->enable_pio32 && width == io_width_t::dword) {
+	/* only the data port is 32 bits wide */
+	if ((!ide->enable_pio32 || (port & 7) != 0) && width == io_width_t::dword) {
 		ide_baseio_w(port, val & 0xFFFF, io_width_t::word);
 		ide_baseio_w(port + 2, val >> 16, io_width_t::word);
 		return;
@@ -4078,3 +4449,78 @@ static void ide_baseio_w(io_port_t port, io_val_t val, io_width_t width)
 		break;
 	}
 }
+
+static IDEController *match_ide_busmaster(io_port_t port)
+{
+	const auto index = (port - port_num_ide_busmaster) / 8u;
+	if (index >= 2)
+		return nullptr;
+	return idecontroller[index];
+}
+
+static uint32_t ide_busmaster_r(io_port_t port, io_width_t width)
+{
+	IDEController *ide = match_ide_busmaster(port);
+	if (ide == nullptr) {
+		LOG_WARNING("IDE: port read from I/O port not registered to IDE, yet callback triggered");
+		return UINT32_MAX;
+	}
+
+	const uint8_t status = ide->bm_status | IDE_BM_STATUS_DMA_CAPABLE;
+
+	switch (port & 7) {
+	case IDE_BM_COMMAND:
+		/* a dword read also covers the status register, like on the PIIX3 */
+		if (width == io_width_t::dword)
+			return ide->bm_command | (static_cast<uint32_t>(status) << 16);
+		return ide->bm_command;
+	case IDE_BM_STATUS: return status;
+	case IDE_BM_PRD_ADDRESS:
+		if (width == io_width_t::dword)
+			return ide->bm_prd_address;
+		return ide->bm_prd_address & 0xFFFF;
+	case IDE_BM_PRD_ADDRESS + 2: return ide->bm_prd_address >> 16;
+	default: return (width == io_width_t::byte) ? 0xFF : UINT32_MAX;
+	}
+}
+
+static void ide_busmaster_w(io_port_t port, io_val_t val, io_width_t width)
+{
+	IDEController *ide = match_ide_busmaster(port);
+	if (ide == nullptr) {
+		LOG_WARNING("IDE: port write to I/O port not registered to IDE, yet callback triggered");
+		return;
+	}
+
+	switch (port & 7) {
+	case IDE_BM_COMMAND:
+		if (!(val & IDE_BM_COMMAND_START)) {
+			/* stopping the bus master aborts a transfer that hasn't been run yet */
+			ide->bm_status &= ~IDE_BM_STATUS_ACTIVE;
+			if (ide->busmaster_scheduled) {
+				PIC_RemoveSpecificEvents(IDE_DelayedCommand, ide->interface_index);
+				ide->busmaster_scheduled = false;
+			}
+		}
+		ide->bm_command = check_cast<uint8_t>(val & (IDE_BM_COMMAND_START | IDE_BM_COMMAND_READ));
+		/* a dword write also covers the status register */
+		if (width == io_width_t::dword)
+			ide->bm_status &= check_cast<uint8_t>(~((val >> 16) & (IDE_BM_STATUS_ERROR | IDE_BM_STATUS_INTERRUPT)) & 0xFF);
+		ide->busmaster_start();
+		break;
+	case IDE_BM_STATUS:
+		/* error and interrupt are cleared by writing 1 */
+		ide->bm_status &= check_cast<uint8_t>(~(val & (IDE_BM_STATUS_ERROR | IDE_BM_STATUS_INTERRUPT)) & 0xFF);
+		break;
+	case IDE_BM_PRD_ADDRESS:
+		if (width == io_width_t::dword)
+			ide->bm_prd_address = val & ~3u;
+		else
+			ide->bm_prd_address = (ide->bm_prd_address & 0xFFFF0000u) | (val & 0xFFFCu);
+		break;
+	case IDE_BM_PRD_ADDRESS + 2:
+		ide->bm_prd_address = (ide->bm_prd_address & 0xFFFFu) | ((val & 0xFFFFu) << 16);
+		break;
+	default: break;
+	}
+}
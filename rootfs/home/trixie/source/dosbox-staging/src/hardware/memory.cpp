@@ -4,9 +4,16 @@
 
 #include "memory.h"
 
+#include <cerrno>
 #include <cstring>
 #include <memory>
 
+#if defined(WIN32)
+#include <memoryapi.h>
+#elif defined(HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+
 #include "config/setup.h"
 #include "cpu/paging.h"
 #include "cpu/registers.h"
@@ -25,11 +32,25 @@ constexpr auto SafeMegabytesDos   = 31;
 constexpr auto SafeMegabytesWin95 = 480;
 constexpr auto SafeMegabytesWin98 = 512;
 
+// Guest RAM is aligned to, and hinted as, transparent huge pages for this
+// many bytes from its start: conventional memory, the HMA, and the low
+// extended memory where DOS extenders usually load their code.
+constexpr size_t HugePageSize     = 2 * Megabyte;
+constexpr size_t HugePageHintSize = 4 * Megabyte;
+
 static struct MemoryBlock {
-	struct page_t {
-		uint8_t bytes[DosPageSize] = {};
-	};
-	std::vector<page_t> pages           = {};
+	// Guest RAM, num_pages * DosPageSize bytes. Reserved with an anonymous
+	// mapping where available, so pages are only committed once touched.
+	uint8_t* ram     = nullptr;
+	size_t num_pages = 0;
+
+	// The underlying allocation, which might start before ram
+	void* alloc_base  = nullptr;
+	size_t alloc_size = 0;
+
+	// Hand pages of freed XMS/EMS blocks back to the host
+	bool discard_freed_pages = false;
+
 	std::vector<PageHandler*> phandlers = {};
 	std::vector<MemHandle> mhandles     = {};
 	struct {
@@ -90,8 +111,8 @@ public:
 	// Get the starting byte address for the give page
 	HostPt GetHostReadPt(const size_t phys_page) override
 	{
-		assert(phys_page < memory.pages.size());
-		return &(memory.pages[phys_page].bytes[0]);
+		assert(phys_page < memory.num_pages);
+		return memory.ram + phys_page * DosPageSize;
 	}
 	HostPt GetHostWritePt(const size_t phys_page) override
 	{
@@ -139,7 +160,7 @@ void MEM_SetLFB(Bitu page, Bitu pages, PageHandler *handler, PageHandler *mmioha
 }
 
 PageHandler * MEM_GetPageHandler(Bitu phys_page) {
-	if (phys_page < memory.pages.size()) {
+	if (phys_page < memory.num_pages) {
 		return memory.phandlers[phys_page];
 	}
 	if (phys_page >= memory.lfb.start_page && phys_page < memory.lfb.end_page) {
@@ -226,7 +247,7 @@ void MEM_StrCopy(PhysPt pt,char * data,Bitu size) {
 
 uint32_t MEM_TotalPages(void)
 {
-	return check_cast<uint32_t>(memory.pages.size());
+	return check_cast<uint32_t>(memory.num_pages);
 }
 
 uint32_t MEM_FreeLargest()
@@ -234,7 +255,7 @@ uint32_t MEM_FreeLargest()
 	uint32_t size    = 0;
 	uint32_t largest = 0;
 	size_t   index   = XMS_START;
-	while (index < memory.pages.size()) {
+	while (index < memory.num_pages) {
 		if (!memory.mhandles[index]) {
 			++size;
 		} else {
@@ -251,7 +272,7 @@ uint32_t MEM_FreeTotal()
 {
 	uint32_t free  = 0;
 	size_t   index = XMS_START;
-	while (index < memory.pages.size()) {
+	while (index < memory.num_pages) {
 		if (!memory.mhandles[index]) {
 			++free;
 		}
@@ -278,7 +299,7 @@ inline Bitu BestMatch(Bitu size) {
 	Bitu first=0;
 	Bitu best=0xfffffff;
 	Bitu best_first=0;
-	while (index < memory.pages.size()) {
+	while (index < memory.num_pages) {
 		/* Check if we are searching for first free page */
 		if (!first) {
 			/* Check if this is a free page */
@@ -343,12 +364,55 @@ MemHandle MEM_GetNextFreePage(void) {
 	return (MemHandle)BestMatch(1);
 }
 
+// Lets the host drop the backing store of a run of freed guest pages; they
+// read back as zeroes. Only whole host pages inside the run are discarded.
+static void discard_pages([[maybe_unused]] const size_t first_page,
+                          [[maybe_unused]] const size_t num_pages)
+{
+#if defined(HAVE_MADVISE) && defined(MADV_DONTNEED)
+	const auto start = reinterpret_cast<uintptr_t>(memory.ram) +
+	                   first_page * DosPageSize;
+	const auto end = start + num_pages * DosPageSize;
+
+	const auto aligned_start = (start + HostPageSize - 1) &
+	                           ~static_cast<uintptr_t>(HostPageSize - 1);
+	const auto aligned_end = end & ~static_cast<uintptr_t>(HostPageSize - 1);
+	if (aligned_start >= aligned_end) {
+		return;
+	}
+	madvise(reinterpret_cast<void*>(aligned_start),
+	        aligned_end - aligned_start,
+	        MADV_DONTNEED);
+#endif
+}
+
 void MEM_ReleasePages(MemHandle handle) {
+	// Handles chain pages in ascending order, usually contiguously, so the
+	// freed pages are discarded in runs
+	size_t run_start = 0;
+	size_t run_pages = 0;
+
 	while (handle>0) {
 		MemHandle next=memory.mhandles[handle];
 		memory.mhandles[handle]=0;
+
+		if (memory.discard_freed_pages) {
+			const auto page = static_cast<size_t>(handle);
+			if (run_pages && page == run_start + run_pages) {
+				++run_pages;
+			} else {
+				if (run_pages) {
+					discard_pages(run_start, run_pages);
+				}
+				run_start = page;
+				run_pages = 1;
+			}
+		}
 		handle=next;
 	}
+	if (run_pages) {
+		discard_pages(run_start, run_pages);
+	}
 }
 
 bool MEM_ReAllocatePages(MemHandle & handle,Bitu pages,bool sequence) {
@@ -393,7 +457,7 @@ bool MEM_ReAllocatePages(MemHandle & handle,Bitu pages,bool sequence) {
 		if (sequence) {
 			index=last+1;
 			Bitu free=0;
-			while (static_cast<uint32_t>(index) < memory.pages.size() &&
+			while (static_cast<uint32_t>(index) < memory.num_pages &&
 			       !memory.mhandles[index]) {
 				index++;
 				free++;
@@ -704,6 +768,86 @@ HostPt GetMemBase(void)
 	return MemBase;
 }
 
+static void free_guest_ram()
+{
+	if (!memory.alloc_base) {
+		return;
+	}
+#if defined(WIN32)
+	VirtualFree(memory.alloc_base, 0, MEM_RELEASE);
+#elif defined(HAVE_MMAP)
+	munmap(memory.alloc_base, memory.alloc_size);
+#else
+	free(memory.alloc_base);
+#endif
+	memory.alloc_base = nullptr;
+	memory.alloc_size = 0;
+	memory.ram        = nullptr;
+	memory.num_pages  = 0;
+}
+
+// Allocates zeroed guest RAM without committing it: untouched pages don't
+// cost the host any memory.
+static void allocate_guest_ram(const size_t num_pages)
+{
+	free_guest_ram();
+
+	const auto size = num_pages * DosPageSize;
+
+#if defined(WIN32)
+	// Committed pages are only backed once they're first touched
+	memory.alloc_size = size;
+	memory.alloc_base = VirtualAlloc(nullptr,
+	                                 size,
+	                                 MEM_COMMIT | MEM_RESERVE,
+	                                 PAGE_READWRITE);
+	if (!memory.alloc_base) {
+		E_Exit("MEMORY: Failed allocating %zu bytes of guest memory",
+		       size);
+	}
+	memory.ram = static_cast<uint8_t*>(memory.alloc_base);
+
+#elif defined(HAVE_MMAP)
+	// Reserve a bit more so the start can be aligned to a huge page
+	memory.alloc_size = size + HugePageSize;
+	memory.alloc_base = mmap(nullptr,
+	                         memory.alloc_size,
+	                         PROT_READ | PROT_WRITE,
+	                         MAP_PRIVATE | MAP_ANON,
+	                         -1,
+	                         0);
+	if (memory.alloc_base == MAP_FAILED) {
+		memory.alloc_base = nullptr;
+		E_Exit("MEMORY: Failed memory-mapping guest memory because: %s",
+		       strerror(errno));
+	}
+	const auto aligned = (reinterpret_cast<uintptr_t>(memory.alloc_base) +
+	                      HugePageSize - 1) &
+	                     ~static_cast<uintptr_t>(HugePageSize - 1);
+	memory.ram = reinterpret_cast<uint8_t*>(aligned);
+
+#if defined(HAVE_MADVISE) && defined(MADV_HUGEPAGE)
+	// Best effort, the kernel might have transparent huge pages disabled
+	const auto hint_size = std::min(size, HugePageHintSize) &
+	                       ~(HugePageSize - 1);
+	if (hint_size) {
+		madvise(memory.ram, hint_size, MADV_HUGEPAGE);
+	}
+#endif
+
+#else
+	memory.alloc_size = size;
+	memory.alloc_base = calloc(num_pages, DosPageSize);
+	if (!memory.alloc_base) {
+		E_Exit("MEMORY: Failed allocating guest memory because: %s",
+		       strerror(errno));
+	}
+	memory.ram = static_cast<uint8_t*>(memory.alloc_base);
+#endif
+
+	memory.num_pages = num_pages;
+}
+
 class MEMORY {
 private:
 	IO_ReadHandleObject ReadHandler   = {};
@@ -719,14 +863,16 @@ public:
 
 		const auto num_pages = num_megabytes * PagesPerMegabyte;
 
-		// Size the actual memory pages
-		memory.pages.resize(num_pages);
+		// Reserve the actual memory pages
+		allocate_guest_ram(num_pages);
 
 		// The MemBase is address of the first page's first byte
-		MemBase = &(memory.pages[0].bytes[0]);
+		MemBase = memory.ram;
+
+		memory.discard_freed_pages = section->GetBool("release_freed_memory");
 
 		LOG_MSG("MEMORY: Using %d DOS memory pages (%u MB) at address: %p",
-		        static_cast<int>(memory.pages.size()),
+		        static_cast<int>(memory.num_pages),
 		        num_megabytes,
 		        static_cast<void*>(MemBase));
 
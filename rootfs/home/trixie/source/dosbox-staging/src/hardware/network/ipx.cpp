@@ -6,11 +6,14 @@
 
 #include "hardware/network/ipx.h"
 
+#include <array>
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <memory>
+#include <vector>
 
 #include <chrono>
 
@@ -28,10 +31,12 @@
 #include "dos/programs.h"
 #include "hardware/memory.h"
 #include "hardware/network/ipxserver.h"
+#include "hardware/network/net_io.h"
 #include "hardware/pic.h"
 #include "hardware/port.h"
 #include "hardware/timer.h"
 #include "misc/cross.h"
+#include "utils/spsc_queue.h"
 #include "utils/string_utils.h"
 
 #define SOCKTABLESIZE	150 // DOS IPX driver was limited to 150 open sockets
@@ -45,13 +50,23 @@ uint32_t udpPort;
 bool isIpxServer;
 bool isIpxConnected;
 IPaddress ipxServConnIp; // IPAddress for client connection to server
-uint8_t recvBuffer[IPXBUFFERSIZE];	// Incoming packet buffer
 
-static asio::io_context ipx_io;
+// The client socket is serviced on the network I/O thread while connected.
+// Received packets are queued for IPX_ClientLoop(), which runs as a receive
+// handler of the I/O thread; packets to send are posted to the I/O thread.
+struct IpxPacket {
+	uint16_t size = 0;
+	std::array<uint8_t, IPXBUFFERSIZE> data = {};
+};
+
+static std::shared_ptr<NetIoThread> ipx_io_thread               = {};
 static std::unique_ptr<asio::ip::udp::socket> ipx_client_socket = nullptr;
 static asio::ip::udp::endpoint ipx_server_endpoint              = {};
 static bool ipx_server_endpoint_valid                           = false;
 
+static SpscQueue<IpxPacket, 64> ipx_received_packets = {};
+static std::atomic_bool ipx_send_failed              = false;
+
 static RealPt ipx_callback;
 
 packetBuffer incomingPacket;
@@ -367,6 +382,7 @@ static void IPX_AES_EventHandler(uint32_t param)
 }
 
 static void sendPacket(ECBClass* sendecb);
+void DisconnectFromServer(bool unexpected);
 
 static void handleIpxRequest(void) {
 	ECBClass *tmpECB;
@@ -512,6 +528,97 @@ Bitu IPX_IntHandler(void) {
 	return CBRET_NONE;
 }
 
+// Runs on the network I/O thread
+static void ipx_client_arm_receive()
+{
+	if (!ipx_client_socket) {
+		return;
+	}
+
+	// One outstanding receive at a time, so it's safe to use these statics.
+	static asio::ip::udp::endpoint sender;
+	static IpxPacket packet;
+
+	ipx_client_socket->async_receive_from(
+	        asio::buffer(packet.data),
+	        sender,
+	        [](const std::error_code& ec, const std::size_t len) {
+		        if (ec) {
+			        // Expected when disconnecting
+			        if (ec == asio::error::operation_aborted) {
+				        return;
+			        }
+			        ipx_client_arm_receive();
+			        return;
+		        }
+
+		        packet.size = static_cast<uint16_t>(len);
+		        if (ipx_received_packets.TryEnqueue(packet)) {
+			        NetIoThread::NotifyReceived();
+		        } else {
+			        LOG_IPX("IPX: RX queue full, packet dropped");
+		        }
+		        ipx_client_arm_receive();
+	        });
+}
+
+// The packet is sent from the network I/O thread. If the send fails the
+// client disconnects on the next tick, unless it's only a reply to a ping.
+static bool ipx_client_send(const void* data, const size_t size,
+                            const char* description = nullptr)
+{
+	if (!ipx_io_thread || !ipx_server_endpoint_valid) {
+		return false;
+	}
+
+	const auto bytes = static_cast<const uint8_t*>(data);
+	asio::post(ipx_io_thread->GetContext(),
+	           [packet   = std::vector<uint8_t>(bytes, bytes + size),
+	            endpoint = ipx_server_endpoint,
+	            description]() {
+		           if (!ipx_client_socket) {
+			           return;
+		           }
+		           std::error_code ec;
+		           ipx_client_socket->send_to(asio::buffer(packet), endpoint, 0, ec);
+		           if (!ec) {
+			           return;
+		           }
+		           if (description) {
+			           LOG_WARNING("IPX: Failed to %s: %s",
+			                       description,
+			                       ec.message().c_str());
+		           } else {
+			           LOG_WARNING("IPX: Could not send packet: %s",
+			                       ec.message().c_str());
+			           ipx_send_failed = true;
+			           NetIoThread::NotifyReceived();
+		           }
+	           });
+	return true;
+}
+
+static void ipx_client_close()
+{
+	if (!ipx_io_thread) {
+		return;
+	}
+	ipx_io_thread->RunAndWait([]() {
+		if (ipx_client_socket) {
+			std::error_code ec;
+			ipx_client_socket->close(ec);
+			ipx_client_socket.reset();
+		}
+	});
+	ipx_io_thread.reset();
+
+	IpxPacket packet = {};
+	while (ipx_received_packets.TryDequeue(packet)) {
+		// Drop packets still waiting to be delivered
+	}
+	ipx_send_failed = false;
+}
+
 static void pingAck(IPaddress retAddr) {
 	IPXHeader regHeader;
 
@@ -528,18 +635,7 @@ static void pingAck(IPaddress retAddr) {
 	regHeader.transControl = 0;
 	regHeader.pType = 0x0;
 
-	if (!ipx_client_socket || !ipx_server_endpoint_valid) {
-		return;
-	}
-	std::error_code ec;
-	ipx_client_socket->send_to(asio::buffer(&regHeader, sizeof(regHeader)),
-	                           ipx_server_endpoint,
-	                           0,
-	                           ec);
-	if (ec) {
-		LOG_DEBUG("IPX: Failed to acknowledge send: %s",
-		          ec.message().c_str());
-	}
+	ipx_client_send(&regHeader, sizeof(regHeader), "acknowledge ping");
 }
 
 static void pingSend(void) {
@@ -559,18 +655,7 @@ static void pingSend(void) {
 	regHeader.transControl = 0;
 	regHeader.pType = 0x0;
 
-	if (!ipx_client_socket || !ipx_server_endpoint_valid) {
-		return;
-	}
-	std::error_code ec;
-	ipx_client_socket->send_to(asio::buffer(&regHeader, sizeof(regHeader)),
-	                           ipx_server_endpoint,
-	                           0,
-	                           ec);
-	if (ec) {
-		LOG_WARNING("IPX: Failed to send a ping packet: %s",
-		            ec.message().c_str());
-	}
+	ipx_client_send(&regHeader, sizeof(regHeader), "send a ping packet");
 }
 
 static void receivePacket(uint8_t *buffer, int16_t bufSize) {
@@ -609,21 +694,18 @@ static void receivePacket(uint8_t *buffer, int16_t bufSize) {
 }
 
 static void IPX_ClientLoop(void) {
-	if (!ipx_client_socket) {
+	if (ipx_send_failed.exchange(false)) {
+		DisconnectFromServer(true);
 		return;
 	}
-	std::error_code ec;
-	asio::ip::udp::endpoint sender;
-	const auto len = ipx_client_socket->receive_from(
-	        asio::buffer(recvBuffer, IPXBUFFERSIZE), sender, 0, ec);
-	if (ec == asio::error::would_block || ec == asio::error::try_again) {
-		return;
-	}
-	if (ec) {
-		return;
-	}
-	if (len) {
-		receivePacket(recvBuffer, static_cast<int16_t>(len));
+
+	// Only runs after the I/O thread has queued packets or a send failed
+	static IpxPacket packet = {};
+	while (incomingPacket.connected && ipx_received_packets.TryDequeue(packet)) {
+		if (packet.size) {
+			receivePacket(packet.data.data(),
+			              static_cast<int16_t>(packet.size));
+		}
 	}
 }
 
@@ -633,12 +715,8 @@ void DisconnectFromServer(bool unexpected) {
 	}
 	if (incomingPacket.connected) {
 		incomingPacket.connected = false;
-		TIMER_DelTickHandler(&IPX_ClientLoop);
-		if (ipx_client_socket) {
-			std::error_code ec;
-			ipx_client_socket->close(ec);
-			ipx_client_socket.reset();
-		}
+		NetIoThread::RemoveReceiveHandler(&incomingPacket);
+		ipx_client_close();
 		ipx_server_endpoint_valid = false;
 	}
 }
@@ -724,27 +802,15 @@ static void sendPacket(ECBClass* sendecb) {
 	}
 	LOG_IPX("SEND crc:%2x",packetCRC(&outbuffer[0], packetsize));
 	if(!isloopback) {
-		if (!ipx_client_socket || !ipx_server_endpoint_valid) {
+		// Send errors are only known later; the client then disconnects
+		// like it did when the send failed right away
+		if (!ipx_client_send(outbuffer, static_cast<size_t>(packetsize))) {
 			sendecb->setCompletionFlag(COMP_NOCONNECTION);
 			sendecb->NotifyESR();
 			return;
 		}
-		std::error_code ec;
-		ipx_client_socket->send_to(asio::buffer(outbuffer, packetsize),
-		                           ipx_server_endpoint,
-		                           0,
-		                           ec);
-		if (ec) {
-			LOG_WARNING("IPX: Could not send packet: %s",
-			            ec.message().c_str());
-			sendecb->setCompletionFlag(COMP_HARDWAREERROR);
-			sendecb->NotifyESR();
-			DisconnectFromServer(true);
-			return;
-		} else {
-			sendecb->setCompletionFlag(COMP_SUCCESS);
-			LOG_IPX("Packet sent: size: %d",packetsize);
-		}
+		sendecb->setCompletionFlag(COMP_SUCCESS);
+		LOG_IPX("Packet sent: size: %d",packetsize);
 	}
 	else sendecb->setCompletionFlag(COMP_SUCCESS);
 
@@ -757,24 +823,14 @@ static void sendPacket(ECBClass* sendecb) {
 }
 
 static bool pingCheck(IPXHeader * outHeader) {
-	if (!ipx_client_socket) {
+	static IpxPacket packet = {};
+	if (!ipx_received_packets.TryDequeue(packet)) {
 		return false;
 	}
-	uint8_t buffer[1024] = {};
-	asio::ip::udp::endpoint sender;
-	std::error_code ec;
-	const auto len = ipx_client_socket->receive_from(
-	        asio::buffer(buffer, sizeof(buffer)), sender, 0, ec);
-	if (ec == asio::error::would_block || ec == asio::error::try_again) {
+	if (packet.size < sizeof(IPXHeader)) {
 		return false;
 	}
-	if (ec) {
-		return false;
-	}
-	if (len < sizeof(IPXHeader)) {
-		return false;
-	}
-	std::memcpy(outHeader, buffer, sizeof(IPXHeader));
+	std::memcpy(outHeader, packet.data.data(), sizeof(IPXHeader));
 	return true;
 }
 
@@ -782,14 +838,17 @@ bool ConnectToServer(const char* strAddr)
 {
 	IPXHeader regHeader;
 
+	ipx_io_thread = NetIoThread::Get();
+
 	std::error_code ec;
-	asio::ip::udp::resolver resolver(ipx_io);
+	asio::ip::udp::resolver resolver(ipx_io_thread->GetContext());
 	auto endpoints = resolver.resolve(asio::ip::udp::v4(),
 	                                  strAddr,
 	                                  std::to_string(static_cast<uint16_t>(udpPort)),
 	                                  ec);
 	if (ec || endpoints.empty()) {
 		LOG_WARNING("IPX: Unable resolve connection to server");
+		ipx_client_close();
 		return false;
 	}
 
@@ -802,23 +861,22 @@ bool ConnectToServer(const char* strAddr)
 	// This idea is from the IPX over IP implementation as specified in RFC
 	// 1234: http://www.faqs.org/rfcs/rfc1234.html
 
-	// Select an anonymous UDP port
-	ipx_client_socket = std::make_unique<asio::ip::udp::socket>(ipx_io);
+	// Select an anonymous UDP port. Nothing runs on the socket on the I/O
+	// thread until we start receiving, so it's set up from here.
+	ipx_client_socket = std::make_unique<asio::ip::udp::socket>(
+	        ipx_io_thread->GetContext());
 	ipx_client_socket->open(asio::ip::udp::v4(), ec);
 	if (ec) {
 		LOG_WARNING("IPX: Unable to open socket");
+		ipx_server_endpoint_valid = false;
+		ipx_client_close();
 		return false;
 	}
 	ipx_client_socket->bind(asio::ip::udp::endpoint(asio::ip::udp::v4(), 0), ec);
 	if (ec) {
 		LOG_WARNING("IPX: Unable to open socket");
-		ipx_client_socket.reset();
-		return false;
-	}
-	ipx_client_socket->non_blocking(true, ec);
-	if (ec) {
-		LOG_WARNING("IPX: Unable to open socket");
-		ipx_client_socket.reset();
+		ipx_server_endpoint_valid = false;
+		ipx_client_close();
 		return false;
 	}
 
@@ -845,20 +903,24 @@ bool ConnectToServer(const char* strAddr)
 	if (ec) {
 		LOG_WARNING("IPX: Unable to connect to server: %s",
 		            ec.message().c_str());
-		ipx_client_socket.reset();
+		ipx_server_endpoint_valid = false;
+		ipx_client_close();
 		return false;
 	} else {
+		asio::post(ipx_io_thread->GetContext(), ipx_client_arm_receive);
+
 		// Wait for return packet from server.
 		// This will contain our IPX address and port num
-		const auto ticks                    = GetTicks();
-		uint8_t reply_buffer[IPXBUFFERSIZE] = {};
+		const auto ticks = GetTicks();
+		IpxPacket reply_packet = {};
 
 		while (true) {
 			const auto elapsed = GetTicksSince(ticks);
 			if (elapsed > 5000) {
 				LOG_WARNING("IPX: Timeout connecting to server at %s",
 				            strAddr);
-				ipx_client_socket.reset();
+				ipx_server_endpoint_valid = false;
+				ipx_client_close();
 
 				return false;
 			}
@@ -866,22 +928,12 @@ bool ConnectToServer(const char* strAddr)
 				break;
 			}
 
-			asio::ip::udp::endpoint sender;
-			const auto len = ipx_client_socket->receive_from(
-			        asio::buffer(reply_buffer, sizeof(reply_buffer)),
-			        sender,
-			        0,
-			        ec);
-			if (ec == asio::error::would_block ||
-			    ec == asio::error::try_again) {
-				continue;
-			}
-			if (ec) {
+			if (!ipx_received_packets.TryDequeue(reply_packet)) {
 				continue;
 			}
-			if (len >= sizeof(IPXHeader)) {
+			if (reply_packet.size >= sizeof(IPXHeader)) {
 				const auto* reply = reinterpret_cast<const IPXHeader*>(
-				        reply_buffer);
+				        reply_packet.data.data());
 				std::memcpy(localIpxAddr.netnode,
 				            reply->dest.addr.byNode.node,
 				            sizeof(localIpxAddr.netnode));
@@ -896,7 +948,7 @@ bool ConnectToServer(const char* strAddr)
 		        CONVIPX(localIpxAddr.netnode));
 
 		incomingPacket.connected = true;
-		TIMER_AddTickHandler(&IPX_ClientLoop);
+		NetIoThread::AddReceiveHandler(&incomingPacket, IPX_ClientLoop);
 		return true;
 	}
 
@@ -1113,7 +1165,7 @@ public:
 					WriteOut("IPX Tunneling Client not connected.\n");
 					return;
 				}
-				TIMER_DelTickHandler(&IPX_ClientLoop);
+				NetIoThread::RemoveReceiveHandler(&incomingPacket);
 				WriteOut("Sending broadcast ping:\n\n");
 				pingSend();
 				const auto ticks = GetTicks();
@@ -1133,7 +1185,7 @@ public:
 						        GetTicksSince(ticks));
 					}
 				}
-				TIMER_AddTickHandler(&IPX_ClientLoop);
+				NetIoThread::AddReceiveHandler(&incomingPacket, IPX_ClientLoop);
 				return;
 			}
 		}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hardware/network/net_io.h"
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "hardware/timer.h"
+#include "misc/support.h"
+
+// Set by the I/O thread, cleared by the tick handler on the emulation thread
+static std::atomic_bool data_received = false;
+
+// Only touched on the emulation thread
+static std::vector<std::pair<const void*, std::function<void()>>> receive_handlers = {};
+
+std::shared_ptr<NetIoThread> NetIoThread::Get()
+{
+	static std::mutex mutex                 = {};
+	static std::weak_ptr<NetIoThread> shared = {};
+
+	std::lock_guard lock(mutex);
+
+	auto io_thread = shared.lock();
+	if (!io_thread) {
+		io_thread = std::shared_ptr<NetIoThread>(new NetIoThread());
+		shared    = io_thread;
+	}
+	return io_thread;
+}
+
+NetIoThread::NetIoThread() : work_guard(asio::make_work_guard(io))
+{
+	thread = std::thread([this]() { io.run(); });
+	set_thread_name(thread, "dosbox:netio");
+}
+
+NetIoThread::~NetIoThread()
+{
+	// Handlers still pending (e.g. reads on sockets closed just before) are
+	// destroyed along with the io_context without being run
+	work_guard.reset();
+	io.stop();
+
+	if (thread.joinable()) {
+		thread.join();
+	}
+}
+
+void NetIoThread::RunAndWait(const std::function<void()>& func)
+{
+	if (std::this_thread::get_id() == thread.get_id()) {
+		func();
+		return;
+	}
+
+	std::promise<void> done = {};
+	asio::post(io, [&]() {
+		func();
+		done.set_value();
+	});
+	done.get_future().wait();
+}
+
+void NetIoThread::NotifyReceived()
+{
+	data_received.store(true, std::memory_order_release);
+}
+
+static void run_receive_handlers()
+{
+	if (!data_received.exchange(false, std::memory_order_acq_rel)) {
+		return;
+	}
+	// Handlers may remove themselves, e.g. when disconnecting
+	const auto handlers = receive_handlers;
+	for (const auto& [owner, handler] : handlers) {
+		handler();
+	}
+}
+
+void NetIoThread::AddReceiveHandler(const void* owner, std::function<void()> handler)
+{
+	if (receive_handlers.empty()) {
+		TIMER_AddTickHandler(&run_receive_handlers);
+	}
+	receive_handlers.emplace_back(owner, std::move(handler));
+
+	// Pick up anything that arrived before the handler was added
+	data_received = true;
+}
+
+void NetIoThread::RemoveReceiveHandler(const void* owner)
+{
+	const auto was_empty = receive_handlers.empty();
+
+	std::erase_if(receive_handlers,
+	              [owner](const auto& entry) { return entry.first == owner; });
+
+	if (!was_empty && receive_handlers.empty()) {
+		TIMER_DelTickHandler(&run_receive_handlers);
+	}
+}
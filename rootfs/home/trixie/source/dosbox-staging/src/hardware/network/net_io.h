@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_NET_IO_H
+#define DOSBOX_NET_IO_H
+
+#include "dosbox.h"
+
+#include <functional>
+#include <memory>
+#include <thread>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+// Network I/O thread shared by the emulated network devices (nullmodem
+// serial ports, IPX).
+//
+// Sockets created on its io_context wait for data on this thread instead of
+// being polled from the emulation thread. Received data is handed over to
+// the devices through lock-free queues (see SpscQueue), which they check
+// for the cost of an atomic load. The emulation thread has no way to be
+// woken up from another thread, so a single timer tick handler checks
+// whether any data arrived and only then runs the devices' receive handlers.
+//
+// Sockets with asynchronous operations on the thread must only be touched
+// from the thread itself, e.g. via asio::post() or RunAndWait().
+//
+class NetIoThread {
+public:
+	// Returns the shared thread and starts it if needed. The thread keeps
+	// running until the last returned pointer is released.
+	static std::shared_ptr<NetIoThread> Get();
+
+	~NetIoThread();
+
+	NetIoThread(const NetIoThread&)            = delete;
+	NetIoThread& operator=(const NetIoThread&) = delete;
+
+	asio::io_context& GetContext()
+	{
+		return io;
+	}
+
+	// Runs the function on the I/O thread and waits until it's done
+	void RunAndWait(const std::function<void()>& func);
+
+	// Called from the I/O thread after data was queued for the emulation
+	// thread, or a connection was closed. The receive handlers run on the
+	// next timer tick.
+	static void NotifyReceived();
+
+	// Receive handlers run on the emulation thread, only after
+	// NotifyReceived(), so the devices don't have to poll their queues
+	// while no data arrives. The owner pointer identifies the handler.
+	static void AddReceiveHandler(const void* owner, std::function<void()> handler);
+	static void RemoveReceiveHandler(const void* owner);
+
+private:
+	NetIoThread();
+
+	asio::io_context io = {};
+	asio::executor_work_guard<asio::io_context::executor_type> work_guard;
+	std::thread thread = {};
+};
+
+#endif // DOSBOX_NET_IO_H
@@ -144,6 +144,10 @@ constexpr io_port_t port_num_fast_a20 = 0x92u;
 constexpr io_port_t port_num_pci_config_address = 0xcf8u;
 constexpr io_port_t port_num_pci_config_data    = 0xcfcu;
 
+// PCI bus master IDE registers, 8 ports per IDE channel
+// (has to be aligned to 16 ports)
+constexpr io_port_t port_num_ide_busmaster = 0xffa0u;
+
 // VirtualBox communication interface
 // (can be moved, but two last bits have to be 0)
 constexpr io_port_t port_num_virtualbox = 0x5654u;
@@ -13,6 +13,7 @@
 #include <string>
 
 #include "hardware/timer.h"
+#include "utils/spsc_queue.h"
 
 // Constants
 constexpr int connection_timeout_ms = 5000;
@@ -475,6 +476,168 @@ void ENETClientSocket::updateState()
 
 // --- TCP NET INTERFACE -----------------------------------------------------
 
+// The connected socket, serviced on the network I/O thread. The emulation
+// thread only touches the queues and posts work to the I/O thread.
+//
+// Handlers hold a reference to the stream, so it stays alive until the last
+// of them has run after the socket is closed.
+class TcpStream : public std::enable_shared_from_this<TcpStream> {
+public:
+	explicit TcpStream(asio::ip::tcp::socket&& new_socket)
+	        : socket(std::move(new_socket))
+	{}
+
+	TcpStream(const TcpStream&)            = delete;
+	TcpStream& operator=(const TcpStream&) = delete;
+
+	// Emulation thread side
+
+	void Start()
+	{
+		asio::post(socket.get_executor(),
+		           [self = shared_from_this()]() { self->Read(); });
+	}
+
+	void Close()
+	{
+		asio::post(socket.get_executor(), [self = shared_from_this()]() {
+			std::error_code ec;
+			self->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ec);
+			self->socket.close(ec);
+			self->closed = true;
+		});
+	}
+
+	bool IsClosed() const
+	{
+		return closed;
+	}
+
+	size_t Receive(uint8_t* data, const size_t n)
+	{
+		const auto num_received = rx_queue.Dequeue(data, n);
+		if (num_received > 0 && rx_stalled.exchange(false)) {
+			// There's room again for what the last read returned
+			asio::post(socket.get_executor(), [self = shared_from_this()]() {
+				self->QueueReceived();
+			});
+		}
+		return num_received;
+	}
+
+	bool Send(const uint8_t* data, const size_t n)
+	{
+		size_t num_sent = 0;
+		while (!closed) {
+			num_sent += tx_queue.Enqueue(data + num_sent, n - num_sent);
+			RequestWrite();
+			if (num_sent == n) {
+				return true;
+			}
+			// The send queue is full, the I/O thread is busy emptying
+			// it. Previously this was a blocking write.
+			std::this_thread::yield();
+		}
+		return false;
+	}
+
+private:
+	// I/O thread side
+
+	void Read()
+	{
+		socket.async_read_some(asio::buffer(read_buffer),
+		                       [self = shared_from_this()](const std::error_code& ec,
+		                                                   const size_t n) {
+			                       if (ec) {
+				                       // Remote side closed the
+				                       // connection, or we did
+				                       self->closed = true;
+				                       NetIoThread::NotifyReceived();
+				                       return;
+			                       }
+			                       self->read_size = n;
+			                       self->read_pos  = 0;
+			                       self->QueueReceived();
+		                       });
+	}
+
+	void QueueReceived()
+	{
+		for (;;) {
+			const auto num_queued = rx_queue.Enqueue(read_buffer.data() + read_pos,
+			                                         read_size - read_pos);
+			if (num_queued > 0) {
+				read_pos += num_queued;
+				NetIoThread::NotifyReceived();
+			}
+			if (read_pos == read_size) {
+				Read();
+				return;
+			}
+
+			// Wait for the emulation thread to make room, unless it
+			// already did in the meantime
+			rx_stalled = true;
+			if (rx_queue.IsFull() || !rx_stalled.exchange(false)) {
+				return;
+			}
+		}
+	}
+
+	void RequestWrite()
+	{
+		if (!write_requested.exchange(true)) {
+			asio::post(socket.get_executor(), [self = shared_from_this()]() {
+				self->write_requested = false;
+				if (!self->writing) {
+					self->Write();
+				}
+			});
+		}
+	}
+
+	void Write()
+	{
+		const auto n = tx_queue.Dequeue(write_buffer.data(), write_buffer.size());
+		if (n == 0) {
+			return;
+		}
+		writing = true;
+		asio::async_write(socket,
+		                  asio::buffer(write_buffer.data(), n),
+		                  [self = shared_from_this()](const std::error_code& ec,
+		                                              const size_t) {
+			                  self->writing = false;
+			                  if (ec) {
+				                  self->closed = true;
+				                  NetIoThread::NotifyReceived();
+				                  return;
+			                  }
+			                  self->Write();
+		                  });
+	}
+
+	asio::ip::tcp::socket socket;
+
+	static constexpr size_t QueueSize  = 64 * 1024;
+	static constexpr size_t BufferSize = 4 * 1024;
+
+	SpscQueue<uint8_t, QueueSize> rx_queue = {};
+	SpscQueue<uint8_t, QueueSize> tx_queue = {};
+
+	std::atomic_bool closed          = false;
+	std::atomic_bool rx_stalled      = false;
+	std::atomic_bool write_requested = false;
+
+	// Only touched on the I/O thread
+	std::array<uint8_t, BufferSize> read_buffer  = {};
+	std::array<uint8_t, BufferSize> write_buffer = {};
+	size_t read_size                             = 0;
+	size_t read_pos                              = 0;
+	bool writing                                 = false;
+};
+
 static void setup_tcp_socket(asio::ip::tcp::socket& socket)
 {
 	std::error_code ec;
@@ -483,115 +646,110 @@ static void setup_tcp_socket(asio::ip::tcp::socket& socket)
 }
 
 TCPClientSocket::TCPClientSocket(asio::ip::tcp::socket&& new_socket,
-                                 const std::shared_ptr<asio::io_context>& io_context)
-        : io(io_context),
-          socket(std::move(new_socket))
+                                 const std::shared_ptr<NetIoThread>& io_thread)
+        : io_thread(io_thread)
 {
-	setup_tcp_socket(socket);
-	isopen = true;
+	Open(std::move(new_socket));
 }
 
 #ifdef NATIVESOCKETS
 TCPClientSocket::TCPClientSocket(int platformsocket)
-        : io(std::make_shared<asio::io_context>()),
-          socket(*io)
+        : io_thread(NetIoThread::Get())
 {
 	is_inherited_socket = true;
+	asio::ip::tcp::socket socket(io_thread->GetContext());
 	std::error_code ec;
 	socket.assign(asio::ip::tcp::v4(), platformsocket, ec);
 	if (ec) {
 		return;
 	}
-	setup_tcp_socket(socket);
-	isopen = true;
+	Open(std::move(socket));
 }
 #endif
 
 TCPClientSocket::TCPClientSocket(const char* destination, uint16_t port)
-        : io(std::make_shared<asio::io_context>()),
-          socket(*io)
+        : io_thread(NetIoThread::Get())
 {
+	auto& io = io_thread->GetContext();
+
 	std::error_code ec;
-	asio::ip::tcp::resolver resolver(*io);
+	asio::ip::tcp::resolver resolver(io);
 	auto endpoints = resolver.resolve(destination, std::to_string(port), ec);
 	if (ec) {
 		return;
 	}
+	asio::ip::tcp::socket socket(io);
 	asio::connect(socket, endpoints, ec);
 	if (ec) {
 		return;
 	}
+	Open(std::move(socket));
+}
+
+// Nothing runs on the socket on the I/O thread yet, so it's still safe to
+// set it up from here
+void TCPClientSocket::Open(asio::ip::tcp::socket&& socket)
+{
 	setup_tcp_socket(socket);
+
+	std::error_code ec;
+	const auto ep = socket.remote_endpoint(ec);
+	if (!ec && ep.address().is_v4()) {
+		remote_address = ep.address().to_string();
+	}
+
+	stream = std::make_shared<TcpStream>(std::move(socket));
+	stream->Start();
 	isopen = true;
 }
 
 TCPClientSocket::~TCPClientSocket()
 {
-	std::error_code ec;
-	if (socket.is_open()) {
-		socket.close(ec);
+	if (stream) {
+		stream->Close();
 	}
 }
 
 bool TCPClientSocket::GetRemoteAddressString(char* buffer)
 {
 	assert(buffer);
-	std::error_code ec;
-	const auto ep = socket.remote_endpoint(ec);
-	if (ec) {
-		return false;
-	}
-	const auto addr = ep.address();
-	if (!addr.is_v4()) {
+	if (remote_address.empty()) {
 		return false;
 	}
-	const auto addr_str = addr.to_string();
-	std::snprintf(buffer, 128, "%s", addr_str.c_str());
+	std::snprintf(buffer, 128, "%s", remote_address.c_str());
 	return true;
 }
 
 bool TCPClientSocket::ReceiveArray(uint8_t* data, size_t& n)
 {
 	assert(data);
-	std::error_code ec;
-	const auto available = socket.available(ec);
-	if (ec) {
-		isopen = false;
-		n      = 0;
-		return false;
-	}
-	if (available == 0) {
+	if (!stream) {
 		n = 0;
-		return true;
+		return false;
 	}
-	const auto to_read = std::min<size_t>(n, available);
-	const auto bytes_read = socket.read_some(asio::buffer(data, to_read), ec);
-	if (ec) {
+	n = stream->Receive(data, n);
+	if (n == 0 && stream->IsClosed()) {
+		// Everything received before the connection closed has been
+		// read
 		isopen = false;
-		n      = 0;
 		return false;
 	}
-	n = bytes_read;
 	return true;
 }
 
 SocketState TCPClientSocket::GetcharNonBlock(uint8_t& val)
 {
-	std::error_code ec;
-	const auto available = socket.available(ec);
-	if (ec) {
-		isopen = false;
+	if (!stream) {
 		return SocketState::Closed;
 	}
-	if (available == 0) {
-		return SocketState::Empty;
+	if (stream->Receive(&val, 1) == 1) {
+		return SocketState::Good;
 	}
-	const auto bytes_read = socket.read_some(asio::buffer(&val, 1), ec);
-	if (ec || bytes_read != 1) {
+	if (stream->IsClosed()) {
 		isopen = false;
 		return SocketState::Closed;
 	}
-	return SocketState::Good;
+	return SocketState::Empty;
 }
 
 bool TCPClientSocket::Putchar(uint8_t val)
@@ -602,9 +760,7 @@ bool TCPClientSocket::Putchar(uint8_t val)
 bool TCPClientSocket::SendArray(const uint8_t* data, const size_t n)
 {
 	assert(data);
-	std::error_code ec;
-	const auto bytes_sent = asio::write(socket, asio::buffer(data, n), ec);
-	if (ec || bytes_sent != n) {
+	if (!stream || !stream->Send(data, n)) {
 		isopen = false;
 		return false;
 	}
@@ -612,8 +768,8 @@ bool TCPClientSocket::SendArray(const uint8_t* data, const size_t n)
 }
 
 TCPServerSocket::TCPServerSocket(const uint16_t port)
-        : io(std::make_shared<asio::io_context>()),
-          acceptor(*io)
+        : io_thread(NetIoThread::Get()),
+          acceptor(io_thread->GetContext())
 {
 	isopen = false;
 	if (!port) {
@@ -650,13 +806,15 @@ TCPServerSocket::~TCPServerSocket()
 	}
 }
 
+// The acceptor is only used from the emulation thread, with non-blocking
+// accepts
 NETClientSocket* TCPServerSocket::Accept()
 {
 	if (!isopen || !acceptor.is_open()) {
 		return nullptr;
 	}
 	std::error_code ec;
-	asio::ip::tcp::socket new_socket(*io);
+	asio::ip::tcp::socket new_socket(io_thread->GetContext());
 	acceptor.accept(new_socket, ec);
 	if (ec) {
 		if (ec == asio::error::would_block || ec == asio::error::try_again) {
@@ -664,5 +822,5 @@ NETClientSocket* TCPServerSocket::Accept()
 		}
 		return nullptr;
 	}
-	return new TCPClientSocket(std::move(new_socket), io);
+	return new TCPClientSocket(std::move(new_socket), io_thread);
 }
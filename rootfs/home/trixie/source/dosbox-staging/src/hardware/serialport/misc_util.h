@@ -9,8 +9,10 @@
 #include <cstdint>
 #include <memory>
 #include <queue>
+#include <string>
 #include <vector>
 
+#include "hardware/network/net_io.h"
 #include "misc/support.h"
 
 #if defined WIN32
@@ -76,6 +78,13 @@ public:
 	virtual bool ReceiveArray(uint8_t* data, size_t& n)   = 0;
 	virtual bool GetRemoteAddressString(char* buffer)     = 0;
 
+	// True if received data and disconnects are signalled through
+	// NetIoThread::NotifyReceived(), otherwise the socket has to be polled
+	virtual bool NotifiesReceived() const
+	{
+		return false;
+	}
+
 	void FlushBuffer();
 	void SetSendBufferSize(size_t n);
 	bool SendByteBuffered(uint8_t val);
@@ -152,10 +161,16 @@ private:
 
 // --- TCP NET INTERFACE (Asio) ---------------------------------------------
 
+// Connected sockets are serviced on the shared network I/O thread; receiving
+// and sending only go through queues and never block the emulation thread
+// (unless the send queue is full).
+
+class TcpStream;
+
 class TCPClientSocket : public NETClientSocket {
 public:
 	TCPClientSocket(asio::ip::tcp::socket&& socket,
-	                const std::shared_ptr<asio::io_context>& io_context);
+	                const std::shared_ptr<NetIoThread>& io_thread);
 	TCPClientSocket(const char* destination, uint16_t port);
 #ifdef NATIVESOCKETS
 	TCPClientSocket(int platformsocket);
@@ -171,9 +186,17 @@ public:
 	bool ReceiveArray(uint8_t* data, size_t& n) override;
 	bool GetRemoteAddressString(char* buffer) override;
 
+	bool NotifiesReceived() const override
+	{
+		return true;
+	}
+
 private:
-	std::shared_ptr<asio::io_context> io = {};
-	asio::ip::tcp::socket socket;
+	void Open(asio::ip::tcp::socket&& socket);
+
+	std::shared_ptr<NetIoThread> io_thread = {};
+	std::shared_ptr<TcpStream> stream      = {};
+	std::string remote_address             = {};
 #ifdef NATIVESOCKETS
 	bool is_inherited_socket = false;
 #endif
@@ -189,7 +212,7 @@ public:
 	NETClientSocket* Accept() override;
 
 private:
-	std::shared_ptr<asio::io_context> io = {};
+	std::shared_ptr<NetIoThread> io_thread = {};
 	asio::ip::tcp::acceptor acceptor;
 };
 
@@ -6,6 +6,7 @@
 
 #include "shell/command_line.h"
 #include "config/config.h"
+#include "hardware/network/net_io.h"
 #include "serialport.h"
 #include "nullmodem.h"
 
@@ -138,6 +139,7 @@ CNullModem::CNullModem(const uint8_t port_idx, CommandLine *cmd)
 }
 
 CNullModem::~CNullModem() {
+	NetIoThread::RemoveReceiveHandler(this);
 	delete serversocket;
 	delete clientsocket;
 	// remove events
@@ -200,7 +202,7 @@ bool CNullModem::ClientConnect(NETClientSocket *newsocket)
 	if (!transparent) setRTSDTR(getRTS(), getDTR());
 	rx_state=N_RX_IDLE;
 	LOG_MSG("SERIAL: Port %" PRIu8 " connected to %s.", GetPortNumber(), peernamebuf);
-	setEvent(SERIAL_POLLING_EVENT, 1);
+	StartReceiving();
 	setCD(true);
 	return true;
 }
@@ -234,7 +236,7 @@ bool CNullModem::ServerConnect() {
 #endif
 	clientsocket->SetSendBufferSize(256);
 	rx_state=N_RX_IDLE;
-	setEvent(SERIAL_POLLING_EVENT, 1);
+	StartReceiving();
 	
 	// we don't accept further connections
 	delete serversocket;
@@ -247,7 +249,9 @@ bool CNullModem::ServerConnect() {
 }
 
 void CNullModem::Disconnect() {
+	NetIoThread::RemoveReceiveHandler(this);
 	removeEvent(SERIAL_POLLING_EVENT);
+	is_polling = false;
 	removeEvent(SERIAL_RX_EVENT);
 	// it was disconnected; free the socket and restart the server socket
 	LOG_MSG("SERIAL: Port %" PRIu8 " disconnected.", GetPortNumber());
@@ -274,8 +278,12 @@ void CNullModem::handleUpperEvent(uint16_t type)
 	switch (type) {
 	case SERIAL_POLLING_EVENT: {
 		// periodically check if new data arrived, disconnect
-		// if required. Add it back.
-		setEvent(SERIAL_POLLING_EVENT, 1.0f);
+		// if required. Add it back, unless the socket tells us
+		// about new data and there is no blocked receiver to
+		// time out.
+		is_polling = false;
+		if (!clientsocket->NotifiesReceived() || rx_state == N_RX_BLOCKED)
+			StartPolling();
 		// update Modem input line states
 		updateMSR();
 		switch (rx_state) {
@@ -291,6 +299,7 @@ void CNullModem::handleUpperEvent(uint16_t type)
 						log_ser(dbg_aux,"Nullmodem: block on polling.");
 #endif
 						rx_state=N_RX_BLOCKED;
+						StartPolling();
 						// have both delays (1ms + bytetime)
 						setEvent(SERIAL_RX_EVENT, bytetime*0.9f);
 					}
@@ -371,6 +380,8 @@ void CNullModem::handleUpperEvent(uint16_t type)
 #endif
 						setEvent(SERIAL_RX_EVENT, bytetime*0.65f);
 						rx_state=N_RX_BLOCKED;
+						// the polling event times out the block
+						StartPolling();
 					}
 
 					break;
@@ -437,6 +448,37 @@ void CNullModem::updateMSR () {
 	
 }
 
+void CNullModem::StartReceiving()
+{
+	if (clientsocket->NotifiesReceived()) {
+		// Data arrives on the network I/O thread; wait for it instead
+		// of polling the socket every millisecond
+		NetIoThread::AddReceiveHandler(this, [this]() { OnDataReceived(); });
+	} else {
+		StartPolling();
+	}
+}
+
+void CNullModem::StartPolling()
+{
+	if (!is_polling) {
+		setEvent(SERIAL_POLLING_EVENT, 1.0f);
+		is_polling = true;
+	}
+}
+
+// Runs on the timer tick after data arrived or the connection was closed
+void CNullModem::OnDataReceived()
+{
+	// A receiver that is already busy picks up the data with its RX
+	// events, a blocked one with the polling event
+	if (!clientsocket || rx_state != N_RX_IDLE || is_polling) {
+		return;
+	}
+	setEvent(SERIAL_POLLING_EVENT, 0.0f);
+	is_polling = true;
+}
+
 bool CNullModem::doReceive () {
 	uint8_t val;
 	SocketState state = readChar(val);
@@ -51,6 +51,9 @@ private:
 #define N_RX_DISC		4
 
 	bool doReceive();
+	void StartReceiving();
+	void StartPolling();
+	void OnDataReceived();
 	bool ClientConnect(NETClientSocket *newsocket);
 	bool ServerListen();
 	bool ServerConnect();
@@ -65,6 +68,9 @@ private:
 	bool tx_block = false; // true while the SERIAL_TX_REDUCTION event
 	                       // is pending
 
+	bool is_polling = false; // true while the SERIAL_POLLING_EVENT is
+	                         // pending
+
 	uint32_t rx_retry = 0; // counter of retries
 
 	uint32_t rx_retry_max = 0; // how many POLL_EVENTS to wait before
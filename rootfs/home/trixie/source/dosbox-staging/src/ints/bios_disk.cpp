@@ -150,6 +150,11 @@ uint8_t imageDisk::Read_Sector(uint32_t head,uint32_t cylinder,uint32_t sector,v
 }
 
 uint8_t imageDisk::Read_AbsoluteSector(uint32_t sectnum, void *data)
+{
+	return Read_AbsoluteSectors(sectnum, 1, data);
+}
+
+uint8_t imageDisk::Read_AbsoluteSectors(uint32_t sectnum, uint32_t count, void* data)
 {
 	const auto bytenum = check_cast<cross_off_t>(sectnum) * sector_size;
 
@@ -165,10 +170,12 @@ uint8_t imageDisk::Read_AbsoluteSector(uint32_t sectnum, void *data)
 	// Otherwise this would result in delay duplication in the int21 handler
 	if (DOS_IsGuestOsBooted()) {
 		DiskType type = hardDrive ? DiskType::HardDisk : DiskType::Floppy;
-		DOS_PerformDiskIoDelay(sector_size, type);
+		for (uint32_t i = 0; i < count; ++i) {
+			DOS_PerformDiskIoDelay(sector_size, type);
+		}
 	}
 
-	size_t ret   = fread(data, 1, sector_size, diskimg);
+	size_t ret   = fread(data, 1, static_cast<size_t>(sector_size) * count, diskimg);
 	current_fpos = bytenum + ret;
 	last_action=READ;
 
@@ -185,6 +192,11 @@ uint8_t imageDisk::Write_Sector(uint32_t head,uint32_t cylinder,uint32_t sector,
 
 
 uint8_t imageDisk::Write_AbsoluteSector(uint32_t sectnum, void *data) {
+	return Write_AbsoluteSectors(sectnum, 1, data);
+}
+
+uint8_t imageDisk::Write_AbsoluteSectors(uint32_t sectnum, uint32_t count, const void* data)
+{
 	const auto bytenum = check_cast<cross_off_t>(sectnum) * sector_size;
 
 	//LOG_MSG("Writing sectors to %ld at bytenum %d", sectnum, bytenum);
@@ -203,10 +215,12 @@ uint8_t imageDisk::Write_AbsoluteSector(uint32_t sectnum, void *data) {
 	// Otherwise this would result in delay duplication in the int21 handler
 	if (DOS_IsGuestOsBooted()) {
 		DiskType type = hardDrive ? DiskType::HardDisk : DiskType::Floppy;
-		DOS_PerformDiskIoDelay(sector_size, type);
+		for (uint32_t i = 0; i < count; ++i) {
+			DOS_PerformDiskIoDelay(sector_size, type);
+		}
 	}
 
-	size_t ret   = fwrite(data, 1, sector_size, diskimg);
+	size_t ret   = fwrite(data, 1, static_cast<size_t>(sector_size) * count, diskimg);
 	current_fpos = bytenum + ret;
 	last_action=WRITE;
 
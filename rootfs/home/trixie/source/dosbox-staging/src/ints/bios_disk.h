@@ -34,6 +34,11 @@ public:
 	uint8_t Read_AbsoluteSector(uint32_t sectnum, void * data);
 	uint8_t Write_AbsoluteSector(uint32_t sectnum, void * data);
 
+	// Transfer a run of consecutive sectors with a single seek and
+	// fread/fwrite call
+	uint8_t Read_AbsoluteSectors(uint32_t sectnum, uint32_t count, void* data);
+	uint8_t Write_AbsoluteSectors(uint32_t sectnum, uint32_t count, const void* data);
+
 	void Set_Geometry(uint32_t setHeads, uint32_t setCyl, uint32_t setSect, uint32_t setSectSize);
 	void Get_Geometry(uint32_t * getHeads, uint32_t *getCyl, uint32_t *getSect, uint32_t *getSectSize);
 	uint8_t GetBiosType(void);
@@ -3,7 +3,9 @@
 
 #include "zmbv.h"
 
+#include <bit>
 #include <cassert>
+#include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -14,6 +16,8 @@
 #include "misc/support.h"
 #include "utils/checks.h"
 
+#include "simde/x86/sse2.h"
+
 CHECK_NARROWING();
 
 constexpr uint8_t DBZV_VERSION_HIGH = 0;
@@ -32,6 +36,64 @@ constexpr int ZLIB_MEM_LEVEL           = 9;          // 1 to 9 (default 8)
 constexpr auto ZLIB_STRATEGY           = Z_FILTERED; // Z_DEFAULT_STRATEGY, Z_FILTERED,
                                                      // Z_HUFFMAN_ONLY, Z_RLE, Z_FIXED
 
+// Only the colour bits count when comparing 32-bit pixels
+template <class P>
+static constexpr uint32_t PixelCompareMask = (sizeof(P) == 4) ? 0x00ffffffu : ~0u;
+
+// Number of pixels in the row that differ between the two frames
+template <class P>
+static int count_changed_pixels(const P* pold, const P* pnew, const int num_pixels)
+{
+	constexpr int PixelsPerVector = sizeof(simde__m128i) / sizeof(P);
+
+	const auto mask = simde_mm_set1_epi32(static_cast<int32_t>(PixelCompareMask<P>));
+	const auto zero = simde_mm_setzero_si128();
+
+	int changed = 0;
+	int x       = 0;
+	for (; x + PixelsPerVector <= num_pixels; x += PixelsPerVector) {
+		const auto vold = simde_mm_loadu_si128(pold + x);
+		const auto vnew = simde_mm_loadu_si128(pnew + x);
+		const auto diff = simde_mm_and_si128(simde_mm_xor_si128(vold, vnew), mask);
+
+		// Each byte of an unchanged pixel sets its bit in the mask
+		simde__m128i same = {};
+		if constexpr (sizeof(P) == 1) {
+			same = simde_mm_cmpeq_epi8(diff, zero);
+		} else if constexpr (sizeof(P) == 2) {
+			same = simde_mm_cmpeq_epi16(diff, zero);
+		} else {
+			same = simde_mm_cmpeq_epi32(diff, zero);
+		}
+		const auto same_bits = static_cast<uint32_t>(simde_mm_movemask_epi8(same));
+		changed += PixelsPerVector - std::popcount(same_bits) / static_cast<int>(sizeof(P));
+	}
+	for (; x < num_pixels; ++x) {
+		changed += ((pold[x] ^ pnew[x]) & PixelCompareMask<P>) != 0;
+	}
+	return changed;
+}
+
+// Writes the XOR of the two rows to the (unaligned) destination
+template <class P>
+static void xor_pixels(uint8_t* dest, const P* a, const P* b, const int num_pixels)
+{
+	constexpr int PixelsPerVector = sizeof(simde__m128i) / sizeof(P);
+
+	int x = 0;
+	for (; x + PixelsPerVector <= num_pixels; x += PixelsPerVector) {
+		const auto va = simde_mm_loadu_si128(a + x);
+		const auto vb = simde_mm_loadu_si128(b + x);
+		simde_mm_storeu_si128(dest, simde_mm_xor_si128(va, vb));
+		dest += sizeof(simde__m128i);
+	}
+	for (; x < num_pixels; ++x) {
+		const P val = a[x] ^ b[x];
+		memcpy(dest, &val, sizeof(P));
+		dest += sizeof(P);
+	}
+}
+
 ZMBV_FORMAT BPPFormat(const int bpp)
 {
 	switch (bpp) {
@@ -87,7 +149,7 @@ bool VideoCodec::SetupBuffers(const ZMBV_FORMAT _format, const int blockwidth, c
 	buf2 = std::vector<uint8_t>(buf_sizes, 0);
 	work = std::vector<uint8_t>(buf_sizes, 0);
 
-	auto xblocks = (width / blockwidth);
+	xblocks = (width / blockwidth);
 
 	const auto xleft = width % blockwidth;
 	if (xleft)
@@ -102,6 +164,7 @@ bool VideoCodec::SetupBuffers(const ZMBV_FORMAT _format, const int blockwidth, c
 
 	const auto blocks_needed = check_cast<uint32_t>(xblocks * yblocks);
 	blocks.resize(blocks_needed);
+	blockVectors.assign(blocks_needed, {});
 
 	size_t i = 0;
 	for (auto y = 0; y < yblocks; ++y) {
@@ -163,17 +226,18 @@ int VideoCodec::PossibleBlock(const int vx, const int vy, const FrameBlock & blo
 	return ret;
 }
 
+// Stops counting once the count reaches the limit, as the caller is only
+// interested in blocks that beat it
 template <class P>
-int VideoCodec::CompareBlock(const int vx, const int vy, const FrameBlock & block)
+int VideoCodec::CompareBlock(const int vx, const int vy, const FrameBlock & block,
+                             const int limit)
 {
 	int diff_count = 0;
 	P *pold = reinterpret_cast<P *>(oldframe) + block.start + (vy * pitch) + vx;
 	P *pnew = reinterpret_cast<P *>(newframe) + block.start;
 
-	for (auto y = 0; y < block.dy; y++) {
-		for (auto x = 0; x < block.dx; x++) {
-			diff_count += ((pold[x] ^ pnew[x]) & 0x00ffffff) != 0;
-		}
+	for (auto y = 0; y < block.dy && diff_count < limit; y++) {
+		diff_count += count_changed_pixels(pold, pnew, block.dx);
 		pold += pitch;
 		pnew += pitch;
 	}
@@ -185,11 +249,10 @@ void VideoCodec::AddXorBlock(const int vx, const int vy, const FrameBlock & bloc
 {
 	P *pold = reinterpret_cast<P *>(oldframe) + block.start + (vy * pitch) + vx;
 	P *pnew = reinterpret_cast<P *>(newframe) + block.start;
+	const auto row_bytes = static_cast<size_t>(block.dx) * sizeof(P);
 	for (auto y = 0; y < block.dy; ++y) {
-		for (auto x = 0; x < block.dx; ++x) {
-			*reinterpret_cast<P *>(&work[workUsed]) = pnew[x] ^ pold[x];
-			workUsed += sizeof(P);
-		}
+		xor_pixels(&work[workUsed], pnew, pold, block.dx);
+		workUsed += row_bytes;
 		pold += pitch;
 		pnew += pitch;
 	}
@@ -212,9 +275,35 @@ void VideoCodec::AddXorFrame()
 
 		int8_t bestvx   = 0;
 		int8_t bestvy   = 0;
-		auto bestchange = CompareBlock<P>(0, 0, block);
+		auto bestchange = CompareBlock<P>(0, 0, block, INT_MAX);
 		auto possibles  = 64;
 
+		// Motion is usually the same as in the previous frame or in the
+		// neighbouring blocks, so try those vectors before searching.
+		// The left and top neighbours have been updated for this frame
+		// already, this block still holds its previous vector.
+		const BlockVector predicted[] = {
+		        blockVectors[b],
+		        (b % xblocks) ? blockVectors[b - 1] : BlockVector{},
+		        (b >= static_cast<size_t>(xblocks)) ? blockVectors[b - xblocks]
+		                                            : BlockVector{},
+		};
+		for (size_t i = 0; i < std::size(predicted) && bestchange >= 4; ++i) {
+			const auto& v = predicted[i];
+			const auto already_tried = (v.x == 0 && v.y == 0) ||
+			                           (i > 0 && v == predicted[0]) ||
+			                           (i > 1 && v == predicted[1]);
+			if (already_tried) {
+				continue;
+			}
+			const auto testchange = CompareBlock<P>(v.x, v.y, block, bestchange);
+			if (testchange < bestchange) {
+				bestchange = testchange;
+				bestvx     = v.x;
+				bestvy     = v.y;
+			}
+		}
+
 		for (auto v = 0; v < VectorCount && possibles; v++) {
 			if (bestchange < 4)
 				break;
@@ -224,7 +313,7 @@ void VideoCodec::AddXorFrame()
 				possibles--;
 				// if (!possibles) Msg("Ran out of possibles, at
 				// %d of %d best%d\n",v,VectorCount,bestchange);
-				auto testchange = CompareBlock<P>(vx, vy, block);
+				auto testchange = CompareBlock<P>(vx, vy, block, bestchange);
 				if (testchange < bestchange) {
 					bestchange = testchange;
 					bestvx     = check_cast<int8_t>(vx);
@@ -232,6 +321,8 @@ void VideoCodec::AddXorFrame()
 				}
 			}
 		}
+		blockVectors[b] = {bestvx, bestvy};
+
 		vectors[b * 2 + 0] = static_cast<uint8_t>(left_shift_signed(bestvx, 1));
 		vectors[b * 2 + 1] = static_cast<uint8_t>(left_shift_signed(bestvy, 1));
 		if (bestchange) {
@@ -406,11 +497,13 @@ void VideoCodec::UnXorBlock(const int vx, const int vy, const FrameBlock & block
 {
 	P *pold = reinterpret_cast<P *>(oldframe) + block.start + (vy * pitch) + vx;
 	P *pnew = reinterpret_cast<P *>(newframe) + block.start;
+	const auto row_bytes = static_cast<size_t>(block.dx) * sizeof(P);
 	for (auto y = 0; y < block.dy; ++y) {
-		for (auto x = 0; x < block.dx; ++x) {
-			pnew[x] = pold[x] ^ *reinterpret_cast<P *>(&work[workPos]);
-			workPos += sizeof(P);
-		}
+		xor_pixels(reinterpret_cast<uint8_t *>(pnew),
+		           pold,
+		           reinterpret_cast<const P *>(&work[workPos]),
+		           block.dx);
+		workPos += row_bytes;
 		pold += pitch;
 		pnew += pitch;
 	}
@@ -421,10 +514,9 @@ void VideoCodec::CopyBlock(const int vx, const int vy, const FrameBlock & block)
 {
 	P *pold = reinterpret_cast<P *>(oldframe) + block.start + (vy * pitch) + vx;
 	P *pnew = reinterpret_cast<P *>(newframe) + block.start;
+	const auto row_bytes = static_cast<size_t>(block.dx) * sizeof(P);
 	for (auto y = 0; y < block.dy; ++y) {
-		for (auto x = 0; x < block.dx; ++x) {
-			pnew[x] = pold[x];
-		}
+		memcpy(pnew, pold, row_bytes);
 		pold += pitch;
 		pnew += pitch;
 	}
@@ -440,8 +532,8 @@ void VideoCodec::UnXorFrame()
 	uint32_t b = 0;
 	for (const auto & block : blocks) {
 		const auto delta = vectors[b * 2 + 0] & 1;
-		const auto vx    = vectors[b * 2 + 0] >> 1;
-		const auto vy    = vectors[b * 2 + 1] >> 1;
+		const auto vx    = static_cast<int8_t>(vectors[b * 2 + 0]) >> 1;
+		const auto vy    = static_cast<int8_t>(vectors[b * 2 + 1]) >> 1;
 		if (delta)
 			UnXorBlock<P>(vx, vy, block);
 		else
@@ -482,10 +574,10 @@ bool VideoCodec::DecompressFrame(uint8_t *framedata, int size)
 	zstream.avail_out = bufsize;
 	zstream.total_out = 0;
 
-	// decompress all the pending data. Note that if Z_FINISH isn't used,
-	// then inflate can also return Z_OK, which indicates multiple inflation
-	// passes are needed.
-	if (inflate(&zstream, Z_FINISH) != Z_STREAM_END)
+	// The encoder flushes the stream after every frame without ending it,
+	// so all of the frame's data is available after a sync flush.
+	const auto inflate_result = inflate(&zstream, Z_SYNC_FLUSH);
+	if (inflate_result != Z_OK && inflate_result != Z_STREAM_END)
 		return false;
 
 	workUsed = check_cast<uint32_t>(zstream.total_out);
@@ -51,6 +51,12 @@ private:
 		int y = 0;
 		int slot = 0;
 	};
+	struct BlockVector {
+		int8_t x = 0;
+		int8_t y = 0;
+
+		bool operator==(const BlockVector &) const = default;
+	};
 	struct KeyframeHeader {
 		uint8_t high_version = 0;
 		uint8_t low_version = 0;
@@ -81,6 +87,10 @@ private:
 	uint32_t bufsize = 0;
 
 	std::vector<FrameBlock> blocks = {};
+	int xblocks = 0;
+
+	// Motion vectors of the previous frame, to seed the search
+	std::vector<BlockVector> blockVectors = {};
 	size_t workUsed = 0;
 	size_t workPos = 0;
 
@@ -106,7 +116,7 @@ private:
 	template <class P>
 	int PossibleBlock(int vx, int vy, const FrameBlock & block);
 	template <class P>
-	int CompareBlock(int vx, int vy, const FrameBlock & block);
+	int CompareBlock(int vx, int vy, const FrameBlock & block, int limit);
 	template <class P>
 	void AddXorBlock(int vx, int vy, const FrameBlock & block);
 	template <class P>
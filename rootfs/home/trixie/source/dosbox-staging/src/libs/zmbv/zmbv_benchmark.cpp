@@ -0,0 +1,201 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Encodes a recorded sequence of raw frames with the ZMBV codec and reports
+// the encoding speed and compressed size, then decodes the result again to
+// check it matches the input.
+//
+// The input is a file of back-to-back frames without padding between rows,
+// e.g. as produced from an existing capture with:
+//
+//   ffmpeg -i capture.avi -f rawvideo -pix_fmt bgra frames.raw
+//
+// Usage: zmbv_benchmark <width> <height> <bpp> <frames.raw>
+//
+// <bpp> is 8, 15, 16 or 32. 8-bit frames are encoded with a greyscale
+// palette.
+
+#include "zmbv.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+// Same keyframe interval as the video capture
+constexpr int KeyframeInterval = 300;
+
+void Msg(const char[], ...) {}
+
+static int usage()
+{
+	fprintf(stderr, "Usage: zmbv_benchmark <width> <height> <bpp> <frames.raw>\n");
+	return EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 5) {
+		return usage();
+	}
+
+	const auto width  = atoi(argv[1]);
+	const auto height = atoi(argv[2]);
+	const auto bpp    = atoi(argv[3]);
+
+	ZMBV_FORMAT format = ZMBV_FORMAT::NONE;
+	switch (bpp) {
+	case 8: format = ZMBV_FORMAT::BPP_8; break;
+	case 15: format = ZMBV_FORMAT::BPP_15; break;
+	case 16: format = ZMBV_FORMAT::BPP_16; break;
+	case 32: format = ZMBV_FORMAT::BPP_32; break;
+	default: return usage();
+	}
+	if (width <= 0 || height <= 0) {
+		return usage();
+	}
+
+	std::ifstream input(argv[4], std::ios::binary);
+	if (!input) {
+		fprintf(stderr, "Can't open '%s'\n", argv[4]);
+		return EXIT_FAILURE;
+	}
+
+	const auto line_bytes  = static_cast<size_t>(width) *
+	                        ZMBV_ToBytesPerPixel(format);
+	const auto frame_bytes = line_bytes * static_cast<size_t>(height);
+
+	std::vector<std::vector<uint8_t>> frames = {};
+	for (;;) {
+		std::vector<uint8_t> frame(frame_bytes);
+		if (!input.read(reinterpret_cast<char*>(frame.data()),
+		                static_cast<std::streamsize>(frame_bytes))) {
+			break;
+		}
+		frames.push_back(std::move(frame));
+	}
+	if (frames.empty()) {
+		fprintf(stderr, "No complete frames in '%s'\n", argv[4]);
+		return EXIT_FAILURE;
+	}
+
+	uint8_t palette[256 * 4] = {};
+	for (auto i = 0; i < 256; ++i) {
+		palette[i * 4 + 0] = palette[i * 4 + 1] = palette[i * 4 + 2] =
+		        static_cast<uint8_t>(i);
+	}
+
+	VideoCodec encoder = {};
+	if (!encoder.SetupCompress(width, height)) {
+		fprintf(stderr, "Can't set up the encoder\n");
+		return EXIT_FAILURE;
+	}
+	std::vector<uint8_t> buffer(
+	        static_cast<size_t>(encoder.NeededSize(width, height, format)));
+
+	std::vector<std::vector<uint8_t>> encoded = {};
+	encoded.reserve(frames.size());
+
+	std::vector<const uint8_t*> lines(static_cast<size_t>(height));
+
+	using namespace std::chrono;
+	const auto start = steady_clock::now();
+
+	for (size_t i = 0; i < frames.size(); ++i) {
+		const auto flags = (i % KeyframeInterval == 0) ? 1 : 0;
+		if (!encoder.PrepareCompressFrame(flags,
+		                                  format,
+		                                  palette,
+		                                  buffer.data(),
+		                                  static_cast<uint32_t>(buffer.size()))) {
+			fprintf(stderr, "Can't encode frame %zu\n", i);
+			return EXIT_FAILURE;
+		}
+		for (auto y = 0; y < height; ++y) {
+			lines[static_cast<size_t>(y)] = frames[i].data() +
+			                                static_cast<size_t>(y) * line_bytes;
+		}
+		encoder.CompressLines(height, lines.data());
+
+		const auto written = encoder.FinishCompressFrame();
+		encoded.emplace_back(buffer.begin(), buffer.begin() + written);
+	}
+
+	const auto elapsed = duration<double>(steady_clock::now() - start).count();
+	encoder.FinishVideo();
+
+	size_t compressed_bytes = 0;
+	for (const auto& frame : encoded) {
+		compressed_bytes += frame.size();
+	}
+	const auto raw_bytes = frame_bytes * frames.size();
+
+	printf("frames:           %zu (%dx%d, %d bpp)\n", frames.size(), width, height, bpp);
+	printf("encoding time:    %.3f s, %.3f ms per frame, %.1f fps\n",
+	       elapsed,
+	       elapsed * 1000.0 / static_cast<double>(frames.size()),
+	       static_cast<double>(frames.size()) / elapsed);
+	printf("compressed size:  %zu bytes (%.2f%% of %zu)\n",
+	       compressed_bytes,
+	       100.0 * static_cast<double>(compressed_bytes) /
+	               static_cast<double>(raw_bytes),
+	       raw_bytes);
+
+	// Check the encoded frames decode to the same image as the input
+	// encoded as keyframes only, which are stored verbatim
+	VideoCodec decoder           = {};
+	VideoCodec reference_encoder = {};
+	VideoCodec reference_decoder = {};
+	if (!decoder.SetupDecompress(width, height) ||
+	    !reference_encoder.SetupCompress(width, height) ||
+	    !reference_decoder.SetupDecompress(width, height)) {
+		fprintf(stderr, "Can't set up the decoders\n");
+		return EXIT_FAILURE;
+	}
+
+	// 24-bit output with rows padded to 32 bits
+	const auto output_bytes = static_cast<size_t>(width) *
+	                          static_cast<size_t>(height) * 4;
+	std::vector<uint8_t> decoded(output_bytes);
+	std::vector<uint8_t> expected(output_bytes);
+
+	for (size_t i = 0; i < encoded.size(); ++i) {
+		if (!decoder.DecompressFrame(encoded[i].data(),
+		                             static_cast<int>(encoded[i].size()))) {
+			fprintf(stderr, "Can't decode frame %zu\n", i);
+			return EXIT_FAILURE;
+		}
+		decoder.Output_UpsideDown_24(decoded.data());
+
+		reference_encoder.PrepareCompressFrame(1,
+		                                       format,
+		                                       palette,
+		                                       buffer.data(),
+		                                       static_cast<uint32_t>(
+		                                               buffer.size()));
+		for (auto y = 0; y < height; ++y) {
+			lines[static_cast<size_t>(y)] = frames[i].data() +
+			                                static_cast<size_t>(y) * line_bytes;
+		}
+		reference_encoder.CompressLines(height, lines.data());
+
+		const auto written = reference_encoder.FinishCompressFrame();
+		if (!reference_decoder.DecompressFrame(buffer.data(), written)) {
+			fprintf(stderr, "Can't decode reference frame %zu\n", i);
+			return EXIT_FAILURE;
+		}
+		reference_decoder.Output_UpsideDown_24(expected.data());
+
+		if (decoded != expected) {
+			fprintf(stderr, "Frame %zu doesn't match the input\n", i);
+			return EXIT_FAILURE;
+		}
+	}
+	reference_encoder.FinishVideo();
+
+	printf("decoding:         OK\n");
+
+	return EXIT_SUCCESS;
+}
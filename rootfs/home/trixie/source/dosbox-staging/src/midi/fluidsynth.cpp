@@ -6,16 +6,29 @@
 #include <bitset>
 #include <cassert>
 #include <compare>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <string>
 #include <tuple>
 #include <vector>
 
+#if defined(WIN32)
+#include <windows.h>
+#elif defined(HAVE_MMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "audio/channel_names.h"
 #include "audio/mixer.h"
 #include "config/config.h"
 #include "dos/programs.h"
 #include "hardware/pic.h"
+#include "hardware/timer.h"
 #include "ints/int10.h"
 #include "misc/ansi_code_markup.h"
 #include "misc/cross.h"
@@ -270,6 +283,201 @@ static std_fs::path find_sf_file(const std::string& sf_name)
 	return {};
 }
 
+// Read-only memory mapping of a SoundFont file.
+//
+// FluidSynth reads the SoundFont through the file callbacks below, which copy
+// straight from the mapping. Together with FluidSynth's dynamic sample
+// loading, only the sample data of the presets in use is ever read from the
+// disk, and the mapped pages can be dropped by the OS at any time.
+class MappedSoundFont {
+public:
+	// Returns the existing mapping of the file if there is one, or nullptr
+	// if the file can't be mapped
+	static std::shared_ptr<MappedSoundFont> Open(const std::string& filename);
+
+	~MappedSoundFont();
+
+	MappedSoundFont(const MappedSoundFont&)            = delete;
+	MappedSoundFont& operator=(const MappedSoundFont&) = delete;
+
+	const uint8_t* Data() const
+	{
+		return data;
+	}
+
+	size_t Size() const
+	{
+		return size;
+	}
+
+private:
+	MappedSoundFont() = default;
+
+	const uint8_t* data = nullptr;
+	size_t size         = 0;
+
+#if defined(WIN32)
+	HANDLE mapping = nullptr;
+#endif
+};
+
+// FluidSynth opens the SoundFont again every time it loads the samples of a
+// preset, so the open mappings are shared
+static std::mutex mapped_soundfonts_mutex = {};
+static std::map<std::string, std::weak_ptr<MappedSoundFont>> mapped_soundfonts = {};
+
+std::shared_ptr<MappedSoundFont> MappedSoundFont::Open(const std::string& filename)
+{
+	std::lock_guard lock(mapped_soundfonts_mutex);
+
+	if (auto mapped = mapped_soundfonts[filename].lock(); mapped) {
+		return mapped;
+	}
+
+	std::shared_ptr<MappedSoundFont> mapped(new MappedSoundFont());
+
+#if defined(WIN32)
+	const auto file = CreateFileA(filename.c_str(),
+	                              GENERIC_READ,
+	                              FILE_SHARE_READ,
+	                              nullptr,
+	                              OPEN_EXISTING,
+	                              FILE_ATTRIBUTE_NORMAL,
+	                              nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return {};
+	}
+
+	LARGE_INTEGER file_size = {};
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+		mapped->mapping = CreateFileMappingA(
+		        file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	// The mapping keeps the file open
+	CloseHandle(file);
+
+	if (!mapped->mapping) {
+		return {};
+	}
+
+	mapped->data = static_cast<const uint8_t*>(
+	        MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!mapped->data) {
+		return {};
+	}
+	mapped->size = static_cast<size_t>(file_size.QuadPart);
+
+#elif defined(HAVE_MMAP)
+	const auto fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return {};
+	}
+
+	struct stat file_stat = {};
+	void* data            = MAP_FAILED;
+	if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+		data = mmap(nullptr,
+		            static_cast<size_t>(file_stat.st_size),
+		            PROT_READ,
+		            MAP_PRIVATE,
+		            fd,
+		            0);
+	}
+	// The mapping stays valid after closing the file
+	close(fd);
+
+	if (data == MAP_FAILED) {
+		return {};
+	}
+	mapped->data = static_cast<const uint8_t*>(data);
+	mapped->size = static_cast<size_t>(file_stat.st_size);
+
+#else
+	return {};
+#endif
+
+	mapped_soundfonts[filename] = mapped;
+	return mapped;
+}
+
+MappedSoundFont::~MappedSoundFont()
+{
+#if defined(WIN32)
+	if (data) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+	}
+#elif defined(HAVE_MMAP)
+	if (data) {
+		munmap(const_cast<uint8_t*>(data), size);
+	}
+#endif
+}
+
+// FluidSynth SoundFont file callbacks reading from the mapped file
+struct SoundFontFileHandle {
+	std::shared_ptr<MappedSoundFont> file = {};
+	fluid_long_long_t pos                 = 0;
+};
+
+static void* soundfont_file_open(const char* filename)
+{
+	auto file = MappedSoundFont::Open(filename);
+	if (!file) {
+		return nullptr;
+	}
+	return new SoundFontFileHandle{std::move(file)};
+}
+
+static int soundfont_file_read(void* buf, fluid_long_long_t count, void* handle)
+{
+	auto sf_file    = static_cast<SoundFontFileHandle*>(handle);
+	const auto size = static_cast<fluid_long_long_t>(sf_file->file->Size());
+
+	if (count < 0 || count > size - sf_file->pos) {
+		return FLUID_FAILED;
+	}
+	memcpy(buf,
+	       sf_file->file->Data() + sf_file->pos,
+	       static_cast<size_t>(count));
+
+	sf_file->pos += count;
+	return FLUID_OK;
+}
+
+static int soundfont_file_seek(void* handle, fluid_long_long_t offset, int origin)
+{
+	auto sf_file    = static_cast<SoundFontFileHandle*>(handle);
+	const auto size = static_cast<fluid_long_long_t>(sf_file->file->Size());
+
+	fluid_long_long_t pos = 0;
+	switch (origin) {
+	case SEEK_SET: pos = offset; break;
+	case SEEK_CUR: pos = sf_file->pos + offset; break;
+	case SEEK_END: pos = size + offset; break;
+	default: return FLUID_FAILED;
+	}
+	if (pos < 0 || pos > size) {
+		return FLUID_FAILED;
+	}
+
+	sf_file->pos = pos;
+	return FLUID_OK;
+}
+
+static fluid_long_long_t soundfont_file_tell(void* handle)
+{
+	return static_cast<SoundFontFileHandle*>(handle)->pos;
+}
+
+static int soundfont_file_close(void* handle)
+{
+	delete static_cast<SoundFontFileHandle*>(handle);
+	return FLUID_OK;
+}
+
 static void log_unknown_midi_message(const std::vector<uint8_t>& msg)
 {
 	auto append_as_hex = [](const std::string& str, const uint8_t val) {
@@ -597,6 +805,8 @@ void MidiDeviceFluidSynth::SetVolume(const int volume_percent)
 	fluid_synth_set_gain(synth.get(), gain);
 }
 
+std::optional<MidiDeviceFluidSynth::CachedSynth> MidiDeviceFluidSynth::cached_synth = {};
+
 MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 {
 	fluid_set_log_function(FLUID_DBG, NULL, NULL);
@@ -607,46 +817,21 @@ MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 	fluid_set_log_function(FLUID_WARN, NULL, NULL);
 #endif
 
-	FluidSynthSettingsPtr fluid_settings(new_fluid_settings(),
-	                                     delete_fluid_settings);
-	if (!fluid_settings) {
-		const auto msg = "FSYNTH: Failed to initialise the FluidSynth settings";
-		LOG_ERR("%s", msg);
-		throw std::runtime_error(msg);
-	}
-
 	auto section = get_fluidsynth_section();
 
-	// Detailed explanation of all available FluidSynth settings:
-	// http://www.fluidsynth.org/api/fluidsettings.xml
-
 	// Per the FluidSynth API, the sample-rate should be part of the
 	// settings used to instantiate the synth, so we use the mixer's
 	// native rate to configure FluidSynth.
 	const auto sample_rate_hz = MIXER_GetSampleRate();
 	ms_per_audio_frame        = MillisInSecond / sample_rate_hz;
+	synth_sample_rate_hz      = sample_rate_hz;
 
-	fluid_settings_setnum(fluid_settings.get(),
-						  "synth.sample-rate",
-						  sample_rate_hz);
-
-	FluidSynthPtr fluid_synth(new_fluid_synth(fluid_settings.get()),
-	                          delete_fluid_synth);
-	if (!fluid_synth) {
-		const auto msg = "FSYNTH: Failed to create the FluidSynth synthesizer";
-		LOG_ERR("%s", msg);
-		throw std::runtime_error(msg);
-	}
-
-	// Load the requested SoundFont or quit if none provided
+	// Find the requested SoundFont or quit if none provided. Only the
+	// header is checked here, the SoundFont is loaded in the background.
 	const auto sf_name = section->GetString("soundfont");
 	const auto sf_path = find_sf_file(sf_name);
 
-	constexpr auto ResetPresets = true;
-	if (fluid_synth_sfload(fluid_synth.get(),
-						   sf_path.string().c_str(),
-						   ResetPresets) == FLUID_FAILED) {
-
+	if (sf_path.empty() || !fluid_is_soundfont(sf_path.string().c_str())) {
 		const auto msg = format_str("FSYNTH: Error loading SoundFont '%s'",
 		                            sf_name.c_str());
 
@@ -658,13 +843,81 @@ MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 		throw std::runtime_error(msg);
 	}
 
-	synth    = std::move(fluid_synth);
-	settings = std::move(fluid_settings);
+	soundfont_path = sf_path;
+
+	if (cached_synth && cached_synth->soundfont_path == sf_path &&
+	    cached_synth->sample_rate_hz == sample_rate_hz) {
+		// Reuse the synth of the previous device with the SoundFont
+		// already loaded
+		settings       = std::move(cached_synth->settings);
+		synth          = std::move(cached_synth->synth);
+		soundfont_file = std::move(cached_synth->soundfont_file);
+		cached_synth.reset();
+
+		fluid_synth_system_reset(synth.get());
+		soundfont_state = SoundFontState::Loaded;
 
+	} else {
+		// Free the cached SoundFont before loading another one
+		cached_synth.reset();
+
+		FluidSynthSettingsPtr fluid_settings(new_fluid_settings(),
+		                                     delete_fluid_settings);
+		if (!fluid_settings) {
+			const auto msg = "FSYNTH: Failed to initialise the FluidSynth settings";
+			LOG_ERR("%s", msg);
+			throw std::runtime_error(msg);
+		}
+
+		// Detailed explanation of all available FluidSynth settings:
+		// http://www.fluidsynth.org/api/fluidsettings.xml
+
+		fluid_settings_setnum(fluid_settings.get(),
+		                      "synth.sample-rate",
+		                      sample_rate_hz);
+
+		// Only load the samples of the presets selected on the MIDI
+		// channels, instead of the sample data of the whole SoundFont
+		fluid_settings_setint(fluid_settings.get(),
+		                      "synth.dynamic-sample-loading",
+		                      1);
+
+		FluidSynthPtr fluid_synth(new_fluid_synth(fluid_settings.get()),
+		                          delete_fluid_synth);
+		if (!fluid_synth) {
+			const auto msg = "FSYNTH: Failed to create the FluidSynth synthesizer";
+			LOG_ERR("%s", msg);
+			throw std::runtime_error(msg);
+		}
+
+		// Read the SoundFont from a memory mapping if possible,
+		// otherwise FluidSynth falls back to reading the file
+		soundfont_file = MappedSoundFont::Open(sf_path.string());
+		if (soundfont_file) {
+			// The synth takes ownership of the loader
+			const auto loader = new_fluid_defsfloader(fluid_settings.get());
+			if (loader) {
+				fluid_sfloader_set_callbacks(loader,
+				                             soundfont_file_open,
+				                             soundfont_file_read,
+				                             soundfont_file_seek,
+				                             soundfont_file_tell,
+				                             soundfont_file_close);
+
+				fluid_synth_add_sfloader(fluid_synth.get(), loader);
+			}
+		}
+
+		synth    = std::move(fluid_synth);
+		settings = std::move(fluid_settings);
+	}
+
+	// Configure the synth before the SoundFont loader thread starts, as
+	// the synth is locked until the SoundFont has been loaded
 	const auto volume_percent = section->GetInt("soundfont_volume");
 	SetVolume(volume_percent);
 
-	// Let the user know that the SoundFont was loaded
+	// Let the user know that the SoundFont is being used
 	if (volume_percent == 100) {
 		LOG_MSG("FSYNTH: Using SoundFont '%s'", sf_path.string().c_str());
 	} else {
@@ -678,9 +931,7 @@ MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 
 	// Use a 7th-order (highest) polynomial to generate MIDI channel
 	// waveforms
-	fluid_synth_set_interp_method(fluid_synth.get(),
-								  FxGroup,
-								  FLUID_INTERP_HIGHEST);
+	fluid_synth_set_interp_method(synth.get(), FxGroup, FLUID_INTERP_HIGHEST);
 
 	SetChorus();
 	SetReverb();
@@ -724,7 +975,12 @@ MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 	// Size the in-bound work FIFO
 	work_fifo.Resize(MaxMidiWorkFifoSize);
 
-	soundfont_path = sf_path;
+	// Start loading the SoundFont
+	if (soundfont_state == SoundFontState::Loading) {
+		soundfont_loader = std::thread(&MidiDeviceFluidSynth::LoadSoundFont,
+		                               this);
+		set_thread_name(soundfont_loader, "dosbox:sfload");
+	}
 
 	// Start rendering audio
 	const auto render = std::bind(&MidiDeviceFluidSynth::Render, this);
@@ -735,6 +991,27 @@ MidiDeviceFluidSynth::MidiDeviceFluidSynth()
 	MIXER_UnlockMixerThread();
 }
 
+void MidiDeviceFluidSynth::LoadSoundFont()
+{
+	const auto start_ms = GetTicks();
+
+	constexpr auto ResetPresets = true;
+	if (fluid_synth_sfload(synth.get(), soundfont_path.string().c_str(), ResetPresets) ==
+	    FLUID_FAILED) {
+
+		LOG_ERR("FSYNTH: Error loading SoundFont '%s'",
+		        soundfont_path.string().c_str());
+
+		soundfont_state = SoundFontState::Failed;
+		return;
+	}
+
+	LOG_INFO("FSYNTH: Loaded SoundFont in %d ms",
+	         static_cast<int>(GetTicksSince(start_ms)));
+
+	soundfont_state = SoundFontState::Loaded;
+}
+
 MidiDeviceFluidSynth::~MidiDeviceFluidSynth()
 {
 	LOG_MSG("FSYNTH: Shutting down");
@@ -767,6 +1044,20 @@ MidiDeviceFluidSynth::~MidiDeviceFluidSynth()
 	mixer_channel.reset();
 
 	MIXER_UnlockMixerThread();
+
+	// Loading can't be cancelled, so wait for the SoundFont to finish
+	// loading; at least it's cached for the next device then
+	if (soundfont_loader.joinable()) {
+		soundfont_loader.join();
+	}
+
+	if (soundfont_state == SoundFontState::Loaded) {
+		cached_synth = CachedSynth{soundfont_path,
+		                           synth_sample_rate_hz,
+		                           std::move(settings),
+		                           std::move(synth),
+		                           std::move(soundfont_file)};
+	}
 }
 
 void MidiDeviceFluidSynth::SetFilter()
@@ -962,21 +1253,26 @@ void MidiDeviceFluidSynth::RenderAudioFramesToFifo(const int num_audio_frames)
 		audio_frames.resize(num_audio_frames);
 	}
 
-	fluid_synth_write_float(synth.get(),
-							num_audio_frames,
-							&audio_frames[0][0],
-							0,
-							2,
-							&audio_frames[0][0],
-							1,
-							2);
+	if (is_soundfont_ready) {
+		fluid_synth_write_float(synth.get(),
+		                        num_audio_frames,
+		                        &audio_frames[0][0],
+		                        0,
+		                        2,
+		                        &audio_frames[0][0],
+		                        1,
+		                        2);
+	} else {
+		// The synth is locked while the SoundFont is loading
+		std::fill_n(audio_frames.begin(), num_audio_frames, AudioFrame{});
+	}
 
 	audio_frame_fifo.BulkEnqueue(audio_frames, num_audio_frames);
 }
 
 void MidiDeviceFluidSynth::ProcessWorkFromFifo()
 {
-	const auto work = work_fifo.Dequeue();
+	auto work = work_fifo.Dequeue();
 	if (!work) {
 		return;
 	}
@@ -997,6 +1293,15 @@ void MidiDeviceFluidSynth::ProcessWorkFromFifo()
 		RenderAudioFramesToFifo(work->num_pending_audio_frames);
 	}
 
+	if (!is_soundfont_ready) {
+		// Hold the message back until the SoundFont has been loaded;
+		// there's nothing to play it with if loading failed
+		if (soundfont_state != SoundFontState::Failed) {
+			held_back_work.emplace_back(std::move(*work));
+		}
+		return;
+	}
+
 	if (work->message_type == MessageType::Channel) {
 		assert(work->message.size() <= MaxMidiMessageLen);
 		ApplyChannelMessage(work->message);
@@ -1006,10 +1311,64 @@ void MidiDeviceFluidSynth::ProcessWorkFromFifo()
 	}
 }
 
+// Applies the MIDI messages received while the SoundFont was loading. Notes
+// that were both started and stopped in the meantime are skipped so they
+// don't all sound at once; only the notes still held are started.
+void MidiDeviceFluidSynth::ApplyHeldBackWork()
+{
+	constexpr auto NoHeldNote = SIZE_MAX;
+
+	// Index of the note on message of each channel's held notes
+	std::vector<size_t> held_notes(NumMidiChannels * NumMidiNotes, NoHeldNote);
+
+	auto is_note_message = [](const MidiWork& work) {
+		if (work.message_type != MessageType::Channel) {
+			return false;
+		}
+		const auto status = get_midi_status(work.message[0]);
+		return status == MidiStatus::NoteOn || status == MidiStatus::NoteOff;
+	};
+
+	auto note_index = [](const MidiWork& work) {
+		return get_midi_channel(work.message[0]) * NumMidiNotes +
+		       (work.message[1] & LastMidiNote);
+	};
+
+	for (size_t i = 0; i < held_back_work.size(); ++i) {
+		const auto& work = held_back_work[i];
+		if (!is_note_message(work)) {
+			continue;
+		}
+		const auto is_note_on = get_midi_status(work.message[0]) ==
+		                                MidiStatus::NoteOn &&
+		                        work.message[2] > 0;
+
+		held_notes[note_index(work)] = is_note_on ? i : NoHeldNote;
+	}
+
+	for (size_t i = 0; i < held_back_work.size(); ++i) {
+		const auto& work = held_back_work[i];
+
+		if (work.message_type == MessageType::SysEx) {
+			ApplySysExMessage(work.message);
+		} else if (!is_note_message(work) || held_notes[note_index(work)] == i) {
+			ApplyChannelMessage(work.message);
+		}
+	}
+
+	held_back_work.clear();
+	held_back_work.shrink_to_fit();
+}
+
 // Keep the fifo populated with freshly rendered buffers
 void MidiDeviceFluidSynth::Render()
 {
 	while (work_fifo.IsRunning()) {
+		if (!is_soundfont_ready && soundfont_state == SoundFontState::Loaded) {
+			is_soundfont_ready = true;
+			ApplyHeldBackWork();
+		}
+
 		work_fifo.IsEmpty() ? RenderAudioFramesToFifo()
 		                    : ProcessWorkFromFifo();
 	}
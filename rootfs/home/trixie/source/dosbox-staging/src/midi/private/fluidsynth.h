@@ -32,10 +32,15 @@ struct ReverbParameters {
 	double level     = {};
 };
 
+class MappedSoundFont;
+
 class MidiDeviceFluidSynth final : public MidiDevice {
 public:
 	// Throws `std::runtime_error` if the MIDI device cannot be initialiased
-	// (e.g., the requested SoundFont cannot be loaded).
+	// (e.g., the requested SoundFont cannot be found or opened).
+	//
+	// The SoundFont is loaded in the background; until it's ready, silence
+	// is rendered and the incoming MIDI messages are held back.
 	MidiDeviceFluidSynth();
 
 	~MidiDeviceFluidSynth() override;
@@ -67,8 +72,11 @@ private:
 	void SetChorusParams(const ChorusParameters& params);
 	void SetReverbParams(const ReverbParameters& params);
 
+	void LoadSoundFont();
+
 	void ApplyChannelMessage(const std::vector<uint8_t>& msg);
 	void ApplySysExMessage(const std::vector<uint8_t>& msg);
+	void ApplyHeldBackWork();
 	void MixerCallback(const int requested_audio_frames);
 	void ProcessWorkFromFifo();
 
@@ -84,12 +92,40 @@ private:
 	FluidSynthSettingsPtr settings{nullptr, &delete_fluid_settings};
 	FluidSynthPtr synth{nullptr, &delete_fluid_synth};
 
+	// The synth of the last device is kept with its SoundFont loaded, so
+	// reinitialising the device with the same SoundFont (e.g., after
+	// changing a setting) doesn't load it again.
+	struct CachedSynth {
+		std_fs::path soundfont_path = {};
+		int sample_rate_hz          = 0;
+
+		FluidSynthSettingsPtr settings{nullptr, &delete_fluid_settings};
+		FluidSynthPtr synth{nullptr, &delete_fluid_synth};
+
+		std::shared_ptr<MappedSoundFont> soundfont_file = {};
+	};
+
+	static std::optional<CachedSynth> cached_synth;
+
 	MixerChannelPtr mixer_channel = nullptr;
 	RWQueue<AudioFrame> audio_frame_fifo{1};
 	RWQueue<MidiWork> work_fifo{1};
 	std::thread renderer = {};
 
 	std_fs::path soundfont_path = {};
+	int synth_sample_rate_hz    = 0;
+
+	std::shared_ptr<MappedSoundFont> soundfont_file = {};
+
+	enum class SoundFontState { Loading, Loaded, Failed };
+
+	std::atomic<SoundFontState> soundfont_state = SoundFontState::Loading;
+	std::thread soundfont_loader = {};
+
+	// MIDI messages received while the SoundFont is loading; only accessed
+	// from the rendering thread
+	std::vector<MidiWork> held_back_work = {};
+	bool is_soundfont_ready              = false;
 
 	// Used to track the balance of time between the last mixer callback
 	// versus the current MIDI SysEx or Msg event.
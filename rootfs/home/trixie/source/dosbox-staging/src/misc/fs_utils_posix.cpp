@@ -14,6 +14,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
 #if defined(HAVE_SYS_XATTR_H)
 #include <sys/xattr.h>
 #endif
@@ -439,6 +444,65 @@ bool truncate_native_file(const NativeFileHandle handle)
 	return ftruncate(handle, current_position) == 0;
 }
 
+bool copy_native_file_contents(const NativeFileHandle src, const NativeFileHandle dst)
+{
+	off_t src_offset = 0;
+	off_t dst_offset = 0;
+
+#if defined(__linux__)
+	// On Btrfs, XFS and similar the copy shares the source's extents until
+	// either file is modified, so even huge files are copied instantly
+#if defined(FICLONE)
+	if (ioctl(dst, FICLONE, src) == 0) {
+		return true;
+	}
+#endif
+	// Otherwise let the kernel copy the data, which saves bouncing it
+	// through our buffer and lets NFS and similar copy server-side. This
+	// fails up front on filesystems or kernels that don't support it.
+	struct stat src_info = {};
+	if (fstat(src, &src_info) == 0) {
+		while (src_offset < src_info.st_size) {
+			const auto num_bytes_copied = copy_file_range(
+			        src, &src_offset, dst, &dst_offset,
+			        static_cast<size_t>(src_info.st_size - src_offset), 0);
+			if (num_bytes_copied <= 0) {
+				break;
+			}
+		}
+		if (src_offset >= src_info.st_size) {
+			return true;
+		}
+	}
+#endif
+
+	// Plain copy of whatever remains
+	constexpr size_t BufferSize = 64 * 1024;
+	std::vector<uint8_t> buffer(BufferSize);
+	while (true) {
+		const auto num_bytes_read = pread(src, buffer.data(), BufferSize, src_offset);
+		if (num_bytes_read < 0) {
+			return false;
+		}
+		if (num_bytes_read == 0) {
+			return true;
+		}
+		ssize_t num_bytes_written = 0;
+		while (num_bytes_written < num_bytes_read) {
+			const auto ret = pwrite(dst,
+			                        buffer.data() + num_bytes_written,
+			                        num_bytes_read - num_bytes_written,
+			                        dst_offset + num_bytes_written);
+			if (ret <= 0) {
+				return false;
+			}
+			num_bytes_written += ret;
+		}
+		src_offset += num_bytes_read;
+		dst_offset += num_bytes_read;
+	}
+}
+
 DosDateTime get_dos_file_time(const NativeFileHandle handle)
 {
 	// Legal defaults if we're unable to populate them
@@ -202,6 +202,32 @@ bool truncate_native_file(const NativeFileHandle handle)
 	return SetEndOfFile(handle);
 }
 
+bool copy_native_file_contents(const NativeFileHandle src, const NativeFileHandle dst)
+{
+	if (seek_native_file(src, 0, NativeSeek::Set) == NativeSeekFailed ||
+	    seek_native_file(dst, 0, NativeSeek::Set) == NativeSeekFailed) {
+		return false;
+	}
+
+	constexpr int64_t BufferSize = 64 * 1024;
+	std::vector<uint8_t> buffer(BufferSize);
+	while (true) {
+		const auto read_result = read_native_file(src, buffer.data(), BufferSize);
+		if (read_result.error) {
+			return false;
+		}
+		if (read_result.num_bytes == 0) {
+			return true;
+		}
+		const auto write_result = write_native_file(dst,
+		                                            buffer.data(),
+		                                            read_result.num_bytes);
+		if (write_result.error || write_result.num_bytes != read_result.num_bytes) {
+			return false;
+		}
+	}
+}
+
 DosDateTime get_dos_file_time(const NativeFileHandle handle)
 {
 	// Legal defaults if we're unable to populate them
@@ -207,6 +207,12 @@ void close_native_file(const NativeFileHandle handle);
 // Sets the file size to be equal to the current file position
 bool truncate_native_file(const NativeFileHandle handle);
 
+// Copies the whole of 'src' into the empty file 'dst'. Where the host
+// filesystem supports it, the copy shares storage with the source (reflink)
+// or is done by the kernel without passing through user space. File
+// positions of both handles are unspecified afterwards.
+bool copy_native_file_contents(const NativeFileHandle src, const NativeFileHandle dst);
+
 DosDateTime get_dos_file_time(const NativeFileHandle handle);
 void set_dos_file_time(const NativeFileHandle handle, const uint16_t date, const uint16_t time);
 
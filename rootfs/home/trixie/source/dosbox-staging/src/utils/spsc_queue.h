@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DOSBOX_SPSC_QUEUE_H
+#define DOSBOX_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+// Fixed-size lock-free queue with a single producer and a single consumer
+// thread.
+//
+// Unlike RWQueue, neither side ever blocks: enqueueing into a full queue and
+// dequeueing from an empty one simply do nothing, so the consumer can check for
+// new items from the emulation thread for the cost of an atomic load.
+//
+// The capacity must be a power of two.
+//
+template <class T, size_t N>
+class SpscQueue {
+	static_assert(std::has_single_bit(N), "SpscQueue size must be power of two");
+
+	static constexpr size_t IndexMask = (N - 1);
+
+public:
+	SpscQueue() = default;
+
+	SpscQueue(const SpscQueue&)            = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer side. Returns false if the queue is full.
+	bool TryEnqueue(const T& item)
+	{
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		if (tail - head_.load(std::memory_order_acquire) == N) {
+			return false;
+		}
+		items_[tail & IndexMask] = item;
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Producer side. Enqueues as many of the items as fit, returns the number
+	// enqueued.
+	size_t Enqueue(const T* items, const size_t num_items)
+	{
+		const auto tail = tail_.load(std::memory_order_relaxed);
+		const auto free = N - (tail - head_.load(std::memory_order_acquire));
+		const auto num  = std::min(num_items, free);
+
+		for (size_t i = 0; i < num; ++i) {
+			items_[(tail + i) & IndexMask] = items[i];
+		}
+		tail_.store(tail + num, std::memory_order_release);
+		return num;
+	}
+
+	// Consumer side. Returns false if the queue is empty.
+	bool TryDequeue(T& item)
+	{
+		const auto head = head_.load(std::memory_order_relaxed);
+		if (head == tail_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = items_[head & IndexMask];
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side. Dequeues up to the requested number of items, returns
+	// the number dequeued.
+	size_t Dequeue(T* items, const size_t num_items)
+	{
+		const auto head = head_.load(std::memory_order_relaxed);
+		const auto used = tail_.load(std::memory_order_acquire) - head;
+		const auto num  = std::min(num_items, used);
+
+		for (size_t i = 0; i < num; ++i) {
+			items[i] = items_[(head + i) & IndexMask];
+		}
+		head_.store(head + num, std::memory_order_release);
+		return num;
+	}
+
+	// Can be called from either side, but the result may be out of date by
+	// the time it is used.
+	size_t Size() const
+	{
+		return tail_.load(std::memory_order_acquire) -
+		       head_.load(std::memory_order_acquire);
+	}
+
+	bool IsEmpty() const
+	{
+		return Size() == 0;
+	}
+
+	bool IsFull() const
+	{
+		return Size() == N;
+	}
+
+	static constexpr size_t Capacity()
+	{
+		return N;
+	}
+
+private:
+	std::array<T, N> items_ = {};
+
+	// Keep the indices on separate cache lines, so the two sides don't
+	// keep stealing the same line from each other
+	alignas(64) std::atomic<size_t> head_ = 0;
+	alignas(64) std::atomic<size_t> tail_ = 0;
+};
+
+#endif // DOSBOX_SPSC_QUEUE_H
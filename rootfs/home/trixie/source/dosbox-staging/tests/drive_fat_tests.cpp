@@ -0,0 +1,414 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/drives.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dos/dos_system.h"
+#include "misc/std_filesystem.h"
+#include "utils/checks.h"
+
+#include "dosbox_test_fixture.h"
+
+namespace {
+
+// A 360 KB FAT12 floppy image with 2 sectors per cluster. The first FAT
+// starts at sector 1, the data area at sector 12. It holds:
+//
+//   FRAG.BIN   - 9000 bytes in clusters 2, 3, 4, 10, 11, 7, 20, 21, 5
+//   MARKER.BIN - 1024 bytes of 0xa5 in cluster 30
+//
+constexpr auto ImageFile = "tests/files/fat12_fragmented.img";
+
+constexpr uint32_t SectorSize     = 512;
+constexpr uint32_t ClusterSize    = 1024;
+constexpr uint32_t FirstFatSector = 1;
+constexpr uint32_t SectorsPerFat  = 2;
+constexpr uint16_t TotalClusters  = 354;
+constexpr uint32_t FragFileSize   = 9000;
+constexpr uint8_t MarkerByte      = 0xa5;
+
+// Contents of FRAG.BIN at the given byte position, and of the data appended
+// to it by the tests
+uint8_t frag_byte(const uint32_t pos)
+{
+	return static_cast<uint8_t>((pos * 131) ^ (pos >> 8));
+}
+
+uint16_t get_fat12_entry(const uint8_t* fat, const uint32_t cluster)
+{
+	const auto offset = cluster + cluster / 2;
+	const auto value  = static_cast<uint16_t>(fat[offset] | (fat[offset + 1] << 8));
+	return (cluster & 1) ? (value >> 4) : (value & 0xfff);
+}
+
+void set_fat12_entry(uint8_t* fat, const uint32_t cluster, const uint16_t value)
+{
+	const auto offset = cluster + cluster / 2;
+	if (cluster & 1) {
+		fat[offset] = static_cast<uint8_t>((fat[offset] & 0x0f) | (value << 4));
+		fat[offset + 1] = static_cast<uint8_t>(value >> 4);
+	} else {
+		fat[offset] = static_cast<uint8_t>(value);
+		fat[offset + 1] = static_cast<uint8_t>((fat[offset + 1] & 0xf0) |
+		                                       (value >> 8));
+	}
+}
+
+// Counts the free clusters by decoding every entry of the first FAT on the
+// image, independently of the drive's own bookkeeping
+uint16_t count_free_clusters(fatDrive& drive)
+{
+	std::vector<uint8_t> fat(SectorsPerFat * SectorSize);
+	for (uint32_t i = 0; i < SectorsPerFat; ++i) {
+		EXPECT_EQ(drive.readSector(FirstFatSector + i, &fat[i * SectorSize]), 0);
+	}
+
+	uint16_t num_free = 0;
+	for (uint32_t cluster = 2; cluster < TotalClusters + 2u; ++cluster) {
+		if (get_fat12_entry(fat.data(), cluster) == 0) {
+			++num_free;
+		}
+	}
+	return num_free;
+}
+
+bool is_cluster_free(fatDrive& drive, const uint32_t cluster)
+{
+	std::vector<uint8_t> fat(SectorsPerFat * SectorSize);
+	for (uint32_t i = 0; i < SectorsPerFat; ++i) {
+		EXPECT_EQ(drive.readSector(FirstFatSector + i, &fat[i * SectorSize]), 0);
+	}
+	return get_fat12_entry(fat.data(), cluster) == 0;
+}
+
+std::vector<uint8_t> read_at(DOS_File& file, uint32_t pos, const uint16_t size)
+{
+	EXPECT_TRUE(file.Seek(&pos, DOS_SEEK_SET));
+
+	std::vector<uint8_t> data(size);
+	auto num_read = size;
+	EXPECT_TRUE(file.Read(data.data(), &num_read));
+	data.resize(num_read);
+	return data;
+}
+
+void write_at(DOS_File& file, uint32_t pos, std::vector<uint8_t> data)
+{
+	EXPECT_TRUE(file.Seek(&pos, DOS_SEEK_SET));
+
+	auto num_written = check_cast<uint16_t>(data.size());
+	EXPECT_TRUE(file.Write(data.data(), &num_written));
+	EXPECT_EQ(num_written, data.size());
+}
+
+uint32_t get_file_size(DOS_File& file)
+{
+	uint32_t pos = 0;
+	EXPECT_TRUE(file.Seek(&pos, DOS_SEEK_END));
+	return pos;
+}
+
+class DriveFatTest : public DOSBoxTestFixture {
+protected:
+	void SetUp() override
+	{
+		DOSBoxTestFixture::SetUp();
+
+		// The tests write to the image, so they work on a copy
+		image_path = std_fs::path(::testing::TempDir()) /
+		             "dosbox_fat_test.img";
+		std_fs::copy_file(ImageFile,
+		                  image_path,
+		                  std_fs::copy_options::overwrite_existing);
+	}
+
+	void TearDown() override
+	{
+		std_fs::remove(image_path);
+
+		DOSBoxTestFixture::TearDown();
+	}
+
+	std::shared_ptr<fatDrive> Mount()
+	{
+		// The floppy geometry is derived from the image size
+		auto drive = std::make_shared<fatDrive>(
+		        image_path.string().c_str(), 512, 9, 2, 40, 0xfd, false);
+
+		EXPECT_TRUE(drive->created_successfully);
+		return drive;
+	}
+
+	std::unique_ptr<DOS_File> Open(fatDrive& drive, const char* name)
+	{
+		auto file = drive.FileOpen(name, OPEN_READWRITE);
+		EXPECT_TRUE(file) << name;
+		return file;
+	}
+
+	std::unique_ptr<DOS_File> Create(fatDrive& drive, const char* name)
+	{
+		auto file = drive.FileCreate(name, FatAttributeFlags{});
+		EXPECT_TRUE(file) << name;
+		return file;
+	}
+
+	// Appends up to the given number of bytes and returns how many fit
+	uint32_t Append(DOS_File& file, const uint32_t size)
+	{
+		auto pos = get_file_size(file);
+
+		uint32_t num_appended = 0;
+		while (num_appended < size) {
+			std::vector<uint8_t> data(std::min<uint32_t>(size - num_appended,
+			                                             16 * 1024));
+			for (size_t i = 0; i < data.size(); ++i) {
+				data[i] = frag_byte(pos + check_cast<uint32_t>(i));
+			}
+
+			auto num_written = check_cast<uint16_t>(data.size());
+			EXPECT_TRUE(file.Seek(&pos, DOS_SEEK_SET));
+			EXPECT_TRUE(file.Write(data.data(), &num_written));
+
+			pos += num_written;
+			num_appended += num_written;
+			if (num_written < data.size()) {
+				break;
+			}
+		}
+		return num_appended;
+	}
+
+	std_fs::path image_path = {};
+};
+
+TEST_F(DriveFatTest, ReadsAcrossFragmentedChain)
+{
+	const auto drive = Mount();
+	ASSERT_TRUE(drive);
+	const auto file = Open(*drive, "FRAG.BIN");
+	ASSERT_TRUE(file);
+
+	struct Span {
+		uint32_t pos;
+		uint16_t size;
+	};
+	const Span spans[] = {
+	        {0, FragFileSize}, // the whole file in one read
+	        {1, 1},
+	        {511, 2},      // across a sector boundary within a cluster
+	        {1000, 100},   // across clusters 2 and 3, which are adjacent
+	        {3000, 2100},  // from cluster 4 through 10 into 11
+	        {1536, 4096},  // sector-aligned, over several runs
+	        {5000, 4000},  // up to the end of the file
+	        {8999, 10},    // past the end of the file
+	};
+
+	for (const auto& span : spans) {
+		const auto data = read_at(*file, span.pos, span.size);
+
+		const auto expected_size = std::min<uint32_t>(span.size,
+		                                              FragFileSize - span.pos);
+		ASSERT_EQ(data.size(), expected_size) << "at " << span.pos;
+
+		for (uint32_t i = 0; i < data.size(); ++i) {
+			ASSERT_EQ(data[i], frag_byte(span.pos + i))
+			        << "at " << span.pos + i;
+		}
+	}
+
+	EXPECT_TRUE(read_at(*file, FragFileSize, 10).empty());
+
+	// Sequential reads in chunks that never line up with sectors
+	uint32_t pos = 0;
+	EXPECT_TRUE(file->Seek(&pos, DOS_SEEK_SET));
+	while (pos < FragFileSize) {
+		uint8_t chunk[777] = {};
+		uint16_t num_read  = sizeof(chunk);
+		ASSERT_TRUE(file->Read(chunk, &num_read));
+		ASSERT_GT(num_read, 0);
+
+		for (uint16_t i = 0; i < num_read; ++i) {
+			ASSERT_EQ(chunk[i], frag_byte(pos + i)) << "at " << pos + i;
+		}
+		pos += num_read;
+	}
+	EXPECT_EQ(pos, FragFileSize);
+
+	file->Close();
+}
+
+TEST_F(DriveFatTest, WriteExtendsFile)
+{
+	constexpr uint32_t NewSize = FragFileSize + 5000;
+
+	auto expected_contents = [](const uint32_t pos, const uint16_t size) {
+		std::vector<uint8_t> data(size);
+		for (uint16_t i = 0; i < size; ++i) {
+			data[i] = frag_byte(pos + i);
+		}
+		return data;
+	};
+
+	{
+		const auto drive = Mount();
+		ASSERT_TRUE(drive);
+		const auto file = Open(*drive, "FRAG.BIN");
+		ASSERT_TRUE(file);
+
+		// Fill the partly used last cluster, then allocate new ones,
+		// in writes that don't line up with sectors or clusters
+		write_at(*file, FragFileSize, expected_contents(FragFileSize, 1234));
+		write_at(*file,
+		         FragFileSize + 1234,
+		         expected_contents(FragFileSize + 1234, 3766));
+
+		EXPECT_EQ(get_file_size(*file), NewSize);
+		EXPECT_EQ(read_at(*file, 0, NewSize), expected_contents(0, NewSize));
+		file->Close();
+	}
+
+	// The new clusters are linked into the chain on the image
+	const auto drive = Mount();
+	ASSERT_TRUE(drive);
+	const auto file = Open(*drive, "FRAG.BIN");
+	ASSERT_TRUE(file);
+
+	EXPECT_EQ(get_file_size(*file), NewSize);
+	EXPECT_EQ(read_at(*file, 0, NewSize), expected_contents(0, NewSize));
+	EXPECT_EQ(read_at(*file, FragFileSize - 100, 300),
+	          expected_contents(FragFileSize - 100, 300));
+	file->Close();
+}
+
+TEST_F(DriveFatTest, RawFatWritesAreSeenByLookups)
+{
+	const auto drive = Mount();
+	ASSERT_TRUE(drive);
+	const auto file = Open(*drive, "FRAG.BIN");
+	ASSERT_TRUE(file);
+
+	// Read the whole file first, so the open file has mapped its chain
+	ASSERT_EQ(read_at(*file, 0, FragFileSize).size(), FragFileSize);
+
+	// Splice MARKER.BIN's cluster into FRAG.BIN's chain after the third
+	// cluster, the way a disk utility would through INT 26h
+	uint8_t fat_sector[SectorSize] = {};
+	ASSERT_EQ(drive->readSector(FirstFatSector, fat_sector), 0);
+	ASSERT_EQ(get_fat12_entry(fat_sector, 4), 10);
+
+	set_fat12_entry(fat_sector, 4, 30);
+	set_fat12_entry(fat_sector, 30, 10);
+	ASSERT_EQ(drive->writeSector(FirstFatSector, fat_sector), 0);
+
+	const auto data = read_at(*file, 0, FragFileSize);
+	ASSERT_EQ(data.size(), FragFileSize);
+
+	for (uint32_t pos = 0; pos < FragFileSize; ++pos) {
+		uint8_t expected = 0;
+		if (pos < 3 * ClusterSize) {
+			expected = frag_byte(pos);
+		} else if (pos < 4 * ClusterSize) {
+			expected = MarkerByte;
+		} else {
+			expected = frag_byte(pos - ClusterSize);
+		}
+		ASSERT_EQ(data[pos], expected) << "at " << pos;
+	}
+	file->Close();
+
+	// Files opened afterwards see the new chain as well
+	const auto reopened = Open(*drive, "FRAG.BIN");
+	ASSERT_TRUE(reopened);
+	EXPECT_EQ(read_at(*reopened, 3 * ClusterSize, 4),
+	          std::vector<uint8_t>(4, MarkerByte));
+	reopened->Close();
+}
+
+TEST_F(DriveFatTest, FreeClustersMatchFatScan)
+{
+	const auto drive = Mount();
+	ASSERT_TRUE(drive);
+
+	auto expect_free_clusters = [&](const uint16_t expected, const char* step) {
+		uint16_t bytes_per_sector = 0;
+		uint8_t sectors_per_cluster = 0;
+		uint16_t total_clusters     = 0;
+		uint16_t free_clusters      = 0;
+		ASSERT_TRUE(drive->AllocationInfo(&bytes_per_sector,
+		                                  &sectors_per_cluster,
+		                                  &total_clusters,
+		                                  &free_clusters));
+
+		EXPECT_EQ(total_clusters, TotalClusters) << step;
+		EXPECT_EQ(free_clusters, count_free_clusters(*drive)) << step;
+		EXPECT_EQ(free_clusters, expected) << step;
+	};
+
+	// FRAG.BIN and MARKER.BIN take 10 clusters
+	expect_free_clusters(TotalClusters - 10, "after mounting");
+
+	// Allocate chains of different lengths, then free one in the middle
+	for (const auto& [name, size] : {std::pair{"ONE.BIN", 3000u},
+	                                 std::pair{"TWO.BIN", 20000u},
+	                                 std::pair{"THREE.BIN", 1u}}) {
+		const auto file = Create(*drive, name);
+		ASSERT_TRUE(file);
+		EXPECT_EQ(Append(*file, size), size) << name;
+		file->Close();
+	}
+	expect_free_clusters(TotalClusters - 10 - 3 - 20 - 1, "after creating");
+
+	ASSERT_TRUE(drive->FileUnlink("TWO.BIN"));
+	expect_free_clusters(TotalClusters - 10 - 3 - 1, "after deleting");
+
+	// Fill up the disk, which moves the next-fit search past the last
+	// word of the free cluster map
+	{
+		const auto file = Create(*drive, "FILL.BIN");
+		ASSERT_TRUE(file);
+		const auto num_appended = Append(*file, TotalClusters * ClusterSize);
+		EXPECT_EQ(num_appended, (TotalClusters - 10 - 3 - 1) * ClusterSize);
+		file->Close();
+	}
+	expect_free_clusters(0, "with a full disk");
+
+	// Freeing FRAG.BIN makes clusters at the start of the map available
+	// again; the search has to wrap around to find them
+	ASSERT_TRUE(drive->FileUnlink("FRAG.BIN"));
+	expect_free_clusters(9, "after freeing the first clusters");
+	ASSERT_TRUE(is_cluster_free(*drive, 2));
+
+	{
+		const auto file = Create(*drive, "WRAP.BIN");
+		ASSERT_TRUE(file);
+		EXPECT_EQ(Append(*file, 3 * ClusterSize), 3 * ClusterSize);
+		EXPECT_EQ(read_at(*file, 0, 3 * ClusterSize).size(), 3 * ClusterSize);
+		file->Close();
+	}
+	expect_free_clusters(6, "after wrapping around");
+	EXPECT_FALSE(is_cluster_free(*drive, 2));
+
+	// A fresh mount builds the free cluster map from the FAT alone
+	const auto remounted = Mount();
+	ASSERT_TRUE(remounted);
+
+	uint16_t bytes_per_sector   = 0;
+	uint8_t sectors_per_cluster = 0;
+	uint16_t total_clusters     = 0;
+	uint16_t free_clusters      = 0;
+	ASSERT_TRUE(remounted->AllocationInfo(&bytes_per_sector,
+	                                      &sectors_per_cluster,
+	                                      &total_clusters,
+	                                      &free_clusters));
+	EXPECT_EQ(free_clusters, 6);
+}
+
+} // namespace
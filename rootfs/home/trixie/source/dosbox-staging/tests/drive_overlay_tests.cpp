@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dos/drives.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "misc/cross.h"
+#include "misc/std_filesystem.h"
+#include "utils/string_utils.h"
+
+#include "dosbox_test_fixture.h"
+
+namespace {
+
+// Large enough to make linear scans of the overlay caches stand out
+constexpr auto NumBaseFiles    = 20000;
+constexpr auto NumBaseDirs     = 5000;
+constexpr auto NumOverlayFiles = 10000;
+
+// Only these base directories get a subdirectory, to test lookups of paths
+// with a deleted leading directory
+constexpr auto NumBaseDirsWithSubdir = 100;
+
+std::string base_file_name(const int i)
+{
+	return format_str("F%05d.TXT", i);
+}
+
+std::string base_dir_name(const int i)
+{
+	return format_str("D%05d", i);
+}
+
+std::string overlay_file_name(const int i)
+{
+	return format_str("N%05d.TXT", i);
+}
+
+void create_empty_file(const std_fs::path& path)
+{
+	std::ofstream file(path);
+	ASSERT_TRUE(file.good()) << path;
+}
+
+class DriveOverlayTest : public DOSBoxTestFixture {
+protected:
+	void SetUp() override
+	{
+		DOSBoxTestFixture::SetUp();
+
+		test_dir = std_fs::path(::testing::TempDir()) / "dosbox_overlay_test";
+		base_dir    = test_dir / "base";
+		overlay_dir = test_dir / "overlay";
+
+		std_fs::remove_all(test_dir);
+		std_fs::create_directories(base_dir);
+		std_fs::create_directories(overlay_dir);
+
+		for (auto i = 0; i < NumBaseFiles; ++i) {
+			create_empty_file(base_dir / base_file_name(i));
+		}
+		for (auto i = 0; i < NumBaseDirs; ++i) {
+			std_fs::create_directory(base_dir / base_dir_name(i));
+			if (i < NumBaseDirsWithSubdir) {
+				std_fs::create_directory(base_dir / base_dir_name(i) / "SUB");
+			}
+		}
+
+		// Every even base file and directory is marked as deleted in
+		// the overlay, the same way FileUnlink() and RemoveDir() do it
+		for (auto i = 0; i < NumBaseFiles; i += 2) {
+			create_empty_file(overlay_dir /
+			                  ("DBOVERLAY_DEL_" + base_file_name(i)));
+		}
+		for (auto i = 0; i < NumBaseDirs; i += 2) {
+			create_empty_file(overlay_dir /
+			                  ("DBOVERLAY_RMD_" + base_dir_name(i)));
+		}
+		for (auto i = 0; i < NumOverlayFiles; ++i) {
+			create_empty_file(overlay_dir / overlay_file_name(i));
+		}
+	}
+
+	void TearDown() override
+	{
+		std_fs::remove_all(test_dir);
+
+		DOSBoxTestFixture::TearDown();
+	}
+
+	std::shared_ptr<Overlay_Drive> MountOverlay()
+	{
+		// The mount command passes directories with a trailing separator
+		const auto base    = base_dir.string() + CROSS_FILESPLIT;
+		const auto overlay = overlay_dir.string() + CROSS_FILESPLIT;
+
+		uint8_t error = 0;
+		auto drive = std::make_shared<Overlay_Drive>(
+		        base.c_str(), overlay.c_str(), 512, 32, 32765, 16000, 0xF8, error);
+
+		EXPECT_EQ(error, 0);
+		return drive;
+	}
+
+	std_fs::path test_dir    = {};
+	std_fs::path base_dir    = {};
+	std_fs::path overlay_dir = {};
+};
+
+TEST_F(DriveOverlayTest, LookupsWithManyEntries)
+{
+	using namespace std::chrono;
+
+	const auto mount_start = steady_clock::now();
+
+	const auto drive = MountOverlay();
+	ASSERT_TRUE(drive);
+
+	const auto lookup_start = steady_clock::now();
+
+	for (auto i = 0; i < NumBaseFiles; ++i) {
+		const auto name = base_file_name(i);
+		const auto is_deleted = (i % 2 == 0);
+		EXPECT_EQ(drive->FileExists(name.c_str()), !is_deleted) << name;
+	}
+	for (auto i = 0; i < NumOverlayFiles; ++i) {
+		const auto name = overlay_file_name(i);
+		EXPECT_TRUE(drive->FileExists(name.c_str())) << name;
+	}
+	for (auto i = 0; i < NumBaseDirs; ++i) {
+		const auto name = base_dir_name(i);
+		const auto is_deleted = (i % 2 == 0);
+		EXPECT_EQ(drive->TestDir(name.c_str()), !is_deleted) << name;
+
+		// A deleted leading directory hides everything below it
+		if (i < NumBaseDirsWithSubdir) {
+			const auto subdir = name + "\\SUB";
+			EXPECT_EQ(drive->TestDir(subdir.c_str()), !is_deleted)
+			        << subdir;
+		}
+	}
+
+	const auto lookup_end = steady_clock::now();
+
+	const auto to_ms = [](const auto duration) {
+		return static_cast<int>(duration_cast<milliseconds>(duration).count());
+	};
+	RecordProperty("mount_ms", to_ms(lookup_start - mount_start));
+	RecordProperty("lookup_ms", to_ms(lookup_end - lookup_start));
+}
+
+TEST_F(DriveOverlayTest, UnlinkAndRecreateWithManyEntries)
+{
+	const auto drive = MountOverlay();
+	ASSERT_TRUE(drive);
+
+	// Deleting the remaining base files adds them to the deletion set
+	for (auto i = 1; i < NumBaseFiles; i += 2) {
+		const auto name = base_file_name(i);
+		EXPECT_TRUE(drive->FileUnlink(name.c_str())) << name;
+	}
+	for (auto i = 0; i < NumBaseFiles; ++i) {
+		const auto name = base_file_name(i);
+		EXPECT_FALSE(drive->FileExists(name.c_str())) << name;
+	}
+
+	// The deletions are persisted in the overlay, so a fresh mount sees
+	// the same state
+	const auto remounted = MountOverlay();
+	ASSERT_TRUE(remounted);
+
+	for (auto i = 0; i < NumBaseFiles; ++i) {
+		const auto name = base_file_name(i);
+		EXPECT_FALSE(remounted->FileExists(name.c_str())) << name;
+	}
+	for (auto i = 0; i < NumOverlayFiles; ++i) {
+		const auto name = overlay_file_name(i);
+		EXPECT_TRUE(remounted->FileExists(name.c_str())) << name;
+	}
+}
+
+} // namespace
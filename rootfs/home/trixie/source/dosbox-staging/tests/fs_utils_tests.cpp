@@ -6,7 +6,12 @@
 #include <gtest/gtest.h>
 
 #include <cerrno>
+#include <fstream>
+#include <iterator>
 #include <string>
+#include <vector>
+
+#include "dos/dos_system.h"
 
 namespace {
 
@@ -123,4 +128,43 @@ TEST_F(CreateDirTest, FailDueToFileExisting2)
 	EXPECT_EQ(errno, EEXIST);
 }
 
+TEST(CopyNativeFileContents, LargerThanCopyBuffer)
+{
+	const auto dir = std_fs::path(::testing::TempDir()) / "dosbox_copy_test";
+	std_fs::remove_all(dir);
+	std_fs::create_directories(dir);
+
+	const auto src_path = dir / "src.bin";
+	const auto dst_path = dir / "dst.bin";
+
+	// Spans several 64 KiB chunks of the fallback copy and ends mid-chunk
+	std::vector<char> contents(3 * 64 * 1024 + 1234);
+	for (size_t i = 0; i < contents.size(); ++i) {
+		contents[i] = static_cast<char>((i * 131) ^ (i >> 8));
+	}
+	{
+		std::ofstream src_file(src_path, std::ios::binary);
+		src_file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+		ASSERT_TRUE(src_file.good());
+	}
+
+	const auto src = open_native_file(src_path, false);
+	ASSERT_NE(src, InvalidNativeFileHandle);
+	const auto dst = create_native_file(dst_path, std::nullopt);
+	ASSERT_NE(dst, InvalidNativeFileHandle);
+
+	EXPECT_TRUE(copy_native_file_contents(src, dst));
+
+	close_native_file(src);
+	close_native_file(dst);
+
+	std::ifstream dst_file(dst_path, std::ios::binary);
+	const std::vector<char> copied(std::istreambuf_iterator<char>(dst_file), {});
+	EXPECT_EQ(copied.size(), contents.size());
+	EXPECT_TRUE(copied == contents);
+
+	dst_file.close();
+	std_fs::remove_all(dir);
+}
+
 } // namespace
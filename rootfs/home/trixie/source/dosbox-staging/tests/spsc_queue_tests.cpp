@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText:  2025-2025 The DOSBox Staging Team
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "utils/spsc_queue.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(SpscQueue, empty)
+{
+	SpscQueue<int, 4> queue = {};
+	EXPECT_TRUE(queue.IsEmpty());
+	EXPECT_FALSE(queue.IsFull());
+	EXPECT_EQ(queue.Size(), 0);
+
+	int item = 0;
+	EXPECT_FALSE(queue.TryDequeue(item));
+}
+
+TEST(SpscQueue, fifo_order)
+{
+	SpscQueue<int, 4> queue = {};
+	EXPECT_TRUE(queue.TryEnqueue(1));
+	EXPECT_TRUE(queue.TryEnqueue(2));
+	EXPECT_TRUE(queue.TryEnqueue(3));
+	EXPECT_EQ(queue.Size(), 3);
+
+	int item = 0;
+	EXPECT_TRUE(queue.TryDequeue(item));
+	EXPECT_EQ(item, 1);
+	EXPECT_TRUE(queue.TryDequeue(item));
+	EXPECT_EQ(item, 2);
+	EXPECT_TRUE(queue.TryDequeue(item));
+	EXPECT_EQ(item, 3);
+	EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(SpscQueue, full)
+{
+	SpscQueue<int, 4> queue = {};
+	for (auto i = 0; i < 4; ++i) {
+		EXPECT_TRUE(queue.TryEnqueue(i));
+	}
+	EXPECT_TRUE(queue.IsFull());
+	EXPECT_FALSE(queue.TryEnqueue(4));
+
+	int item = 0;
+	EXPECT_TRUE(queue.TryDequeue(item));
+	EXPECT_EQ(item, 0);
+	EXPECT_TRUE(queue.TryEnqueue(4));
+	EXPECT_TRUE(queue.IsFull());
+}
+
+TEST(SpscQueue, bulk_wraparound)
+{
+	SpscQueue<uint8_t, 8> queue = {};
+
+	const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+	uint8_t out[10]      = {};
+
+	EXPECT_EQ(queue.Enqueue(data, 6), 6);
+	EXPECT_EQ(queue.Dequeue(out, 4), 4);
+	EXPECT_EQ(out[3], 4);
+
+	// Only six of the ten fit, wrapping around the end of the buffer
+	EXPECT_EQ(queue.Enqueue(data, 10), 6);
+	EXPECT_EQ(queue.Dequeue(out, 10), 8);
+	EXPECT_EQ(out[0], 5);
+	EXPECT_EQ(out[1], 6);
+	EXPECT_EQ(out[2], 1);
+	EXPECT_EQ(out[7], 6);
+	EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(SpscQueue, two_threads)
+{
+	SpscQueue<uint32_t, 64> queue = {};
+
+	constexpr uint32_t NumItems = 100'000;
+
+	std::thread producer([&queue] {
+		for (uint32_t i = 0; i < NumItems;) {
+			if (queue.TryEnqueue(i)) {
+				++i;
+			} else {
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	std::vector<uint32_t> received = {};
+	received.reserve(NumItems);
+	while (received.size() < NumItems) {
+		uint32_t item = 0;
+		if (queue.TryDequeue(item)) {
+			received.push_back(item);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	for (uint32_t i = 0; i < NumItems; ++i) {
+		ASSERT_EQ(received[i], i);
+	}
+}
@@ -11,6 +11,8 @@
 #include <ddraw.h>
 #include <stdint.h>
 
+#include "voodoo_state.h"
+
 /* DirectDraw interfaces */
 static LPDIRECTDRAW g_dd = NULL;
 static LPDIRECTDRAW7 g_dd7 = NULL;
@@ -229,8 +231,10 @@ void display_destroy_window(void)
 }
 
 /* Present framebuffer to screen */
-void display_present(uint16_t *framebuffer, int width, int height)
+void display_present(const fbi_state *fbi, uint32_t bufoffs)
 {
+    int width = (int)fbi->width;
+    int height = (int)fbi->height;
     HRESULT hr;
     DDSURFACEDESC2 ddsd;
     MSG msg;
@@ -254,16 +258,14 @@ void display_present(uint16_t *framebuffer, int width, int height)
         return;
     }
 
-    /* Copy RGB565 data */
+    /* Copy RGB565 data, resolving tiles straight into the surface */
     uint16_t *dst = (uint16_t*)ddsd.lpSurface;
     int dst_pitch_pixels = ddsd.lPitch / 2;  /* pitch in 16-bit words */
 
     /* Clamp copy to prevent wrapping ("ZARDBLIZ" fix) */
     int copy_width = (width < dst_pitch_pixels) ? width : dst_pitch_pixels;
 
-    for (int y = 0; y < height; y++) {
-        memcpy(&dst[y * dst_pitch_pixels], &framebuffer[y * width], copy_width * 2);
-    }
+    voodoo_fbi_read_rect(fbi, bufoffs, 0, 0, copy_width, height, dst, dst_pitch_pixels);
 
     IDirectDrawSurface7_Unlock(g_backbuf, NULL);
 
@@ -1764,6 +1764,30 @@ typedef FxI32 GrTexTable_t;
  */
 FX_ENTRY void FX_CALL grTexDownloadTable(GrTexTable_t type, void *data);
 
+/*
+ * GuNccTable - NCC decompression table (GR_TEXTABLE_NCC0/NCC1 data)
+ *
+ * yRGB, iRGB and qRGB are the unpacked Y, I and Q entries; packed_data
+ * holds the same table as the 12 register values the hardware uses.
+ */
+typedef struct {
+    FxU8  yRGB[16];
+    FxI16 iRGB[4][3];
+    FxI16 qRGB[4][3];
+    FxU32 packed_data[12];
+} GuNccTable;
+
+typedef FxU32 GrNCCTable_t;
+#define GR_NCCTABLE_NCC0    0x0
+#define GR_NCCTABLE_NCC1    0x1
+
+/*
+ * grTexNCCTable - Select the NCC table for YIQ textures
+ *
+ * @param table: GR_NCCTABLE_NCC0 or GR_NCCTABLE_NCC1
+ */
+FX_ENTRY void FX_CALL grTexNCCTable(GrNCCTable_t table);
+
 #ifdef __cplusplus
 }
 #endif
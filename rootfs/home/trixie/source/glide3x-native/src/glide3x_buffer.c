@@ -25,6 +25,37 @@
 
 #include "glide3x_state.h"
 
+/*
+ * Fill a whole color or aux buffer with a 16-bit value
+ *
+ * With the tiled layout each tile holds the buffer as one contiguous
+ * 64-pixel plane, so whole tiles are filled (the padding past the screen
+ * edge included) instead of going row by row.
+ */
+static void fill_buffer(uint32_t bufoffs, uint16_t value)
+{
+    fbi_state *fbi = &g_voodoo->fbi;
+    uint16_t *buf = (uint16_t*)(fbi->ram + bufoffs);
+
+    if (fbi->x_tiles) {
+        uint32_t y_tiles = (fbi->height + FBI_TILE_SIZE - 1) >> FBI_TILE_SHIFT;
+        uint32_t num_tiles = fbi->x_tiles * y_tiles;
+        for (uint32_t t = 0; t < num_tiles; t++) {
+            uint16_t *plane = buf + t * FBI_TILE_STRIDE;
+            for (int i = 0; i < FBI_TILE_PLANE_PIXELS; i++) {
+                plane[i] = value;
+            }
+        }
+        return;
+    }
+
+    for (uint32_t y = 0; y < fbi->height; y++) {
+        for (uint32_t x = 0; x < fbi->width; x++) {
+            buf[y * fbi->rowpixels + x] = value;
+        }
+    }
+}
+
 /*
  * grBufferClear - Clear color and depth buffers
  *
@@ -66,9 +97,7 @@ void __stdcall grBufferClear(GrColor_t color, GrAlpha_t alpha, FxU32 depth)
 
     (void)alpha;  /* Alpha stored in aux buffer if enabled */
 
-    uint16_t *dest;
-    uint16_t *depthbuf;
-    int x, y;
+    uint32_t destoffs;
 
     /*
      * Check write masks - respect grColorMask and grDepthMask settings
@@ -91,17 +120,12 @@ void __stdcall grBufferClear(GrColor_t color, GrAlpha_t alpha, FxU32 depth)
     /* Get target color buffer based on current render buffer setting */
     if (g_render_buffer == 0) {
         /* Front buffer */
-        dest = (uint16_t*)(g_voodoo->fbi.ram +
-                          g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf]);
+        destoffs = g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf];
     } else {
         /* Back buffer (normal case) */
-        dest = (uint16_t*)(g_voodoo->fbi.ram +
-                          g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf]);
+        destoffs = g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf];
     }
 
-    /* Depth buffer */
-    depthbuf = (uint16_t*)(g_voodoo->fbi.ram + g_voodoo->fbi.auxoffs);
-
     /*
      * Clear color buffer only if RGB writes are enabled
      */
@@ -121,11 +145,7 @@ void __stdcall grBufferClear(GrColor_t color, GrAlpha_t alpha, FxU32 depth)
         int b = color & 0xFF;
         uint16_t color565 = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
 
-        for (y = 0; y < (int)g_voodoo->fbi.height; y++) {
-            for (x = 0; x < (int)g_voodoo->fbi.width; x++) {
-                dest[y * g_voodoo->fbi.rowpixels + x] = color565;
-            }
-        }
+        fill_buffer(destoffs, color565);
     }
 
     /*
@@ -136,11 +156,7 @@ void __stdcall grBufferClear(GrColor_t color, GrAlpha_t alpha, FxU32 depth)
      */
     if (doDepth) {
         uint16_t depth16 = (uint16_t)(depth >> 16);
-        for (y = 0; y < (int)g_voodoo->fbi.height; y++) {
-            for (x = 0; x < (int)g_voodoo->fbi.width; x++) {
-                depthbuf[y * g_voodoo->fbi.rowpixels + x] = depth16;
-            }
-        }
+        fill_buffer(g_voodoo->fbi.auxoffs, depth16);
     }
 }
 
@@ -182,21 +198,19 @@ void __stdcall grBufferSwap(FxU32 swap_interval)
 
     (void)swap_interval;  /* Ignored - we don't do vsync */
 
-    uint16_t *presentbuf;
+    uint32_t presentoffs;
     /* Determine which buffer to present */
     if (g_lfb_buffer_locked == GR_BUFFER_FRONTBUFFER) {
         /* LFB writes went to front buffer - present that */
-        presentbuf = (uint16_t*)(g_voodoo->fbi.ram +
-                                 g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf]);
+        presentoffs = g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf];
     } else {
         /* Normal case: present the back buffer */
-        presentbuf = (uint16_t*)(g_voodoo->fbi.ram +
-                                 g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf]);
+        presentoffs = g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf];
     }
 
 
     /* Send to display */
-    display_present(presentbuf, g_voodoo->fbi.width, g_voodoo->fbi.height);
+    display_present(&g_voodoo->fbi, presentoffs);
 
     /*
      * FPS tracking - log frames per second every second
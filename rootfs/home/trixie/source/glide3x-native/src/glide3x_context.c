@@ -118,6 +118,9 @@ GrContext_t __stdcall grSstWinOpen(
      *   Offset W*H*2: Back color buffer
      *   Offset W*H*4: Triple buffer (if enabled)
      *   Offset W*H*6: Depth buffer
+     *
+     * With GLIDE3X_TILED_FB=1 the buffers are instead interleaved in 8x8
+     * tiles (see voodoo_state.h), if they fit.
      */
 
     /* Check if FBI needs full initialization or just dimension update */
@@ -130,16 +133,9 @@ GrContext_t __stdcall grSstWinOpen(
         /* Skip reinitialization to preserve framebuffer content */
     } else {
         voodoo_init_fbi(&g_voodoo->fbi, 4 * 1024 * 1024);
-        g_voodoo->fbi.width = g_screen_width;
-        g_voodoo->fbi.height = g_screen_height;
-        g_voodoo->fbi.rowpixels = g_screen_width;
-
-        /* Calculate buffer offsets (16-bit = 2 bytes per pixel) */
-        int buffer_size = g_screen_width * g_screen_height * 2;
-        g_voodoo->fbi.rgboffs[0] = 0;                    /* Front buffer */
-        g_voodoo->fbi.rgboffs[1] = buffer_size;          /* Back buffer */
-        g_voodoo->fbi.rgboffs[2] = buffer_size * 2;      /* Triple buffer */
-        g_voodoo->fbi.auxoffs = buffer_size * 3;         /* Depth buffer */
+
+        /* Set dimensions and buffer offsets (16-bit = 2 bytes per pixel) */
+        voodoo_fbi_set_layout(&g_voodoo->fbi, g_screen_width, g_screen_height);
 
         g_voodoo->fbi.frontbuf = 0;
         g_voodoo->fbi.backbuf = 1;
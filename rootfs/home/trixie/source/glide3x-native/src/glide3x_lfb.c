@@ -49,6 +49,10 @@
 #include "glide3x_state.h"
 #include <stdlib.h>  /* For malloc/free */
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 /*
  * Get bytes per pixel for a given LFB write mode
  */
@@ -68,6 +72,150 @@ static int get_writemode_bpp(GrLfbWriteMode_t mode)
     }
 }
 
+/*
+ * Row converters
+ *
+ * Each converts one row of LFB pixels to the RGB565 framebuffer format.
+ * The converter is picked once per unlock / grLfbWriteRegion() call
+ * rather than switching on the format for every row, and the 16- and
+ * 32-bit ones process 8 pixels at a time with SSE2 where available.
+ */
+typedef void (*lfb_row_converter)(uint16_t *dst, const uint8_t *src, int width);
+
+/* RGB565: direct copy */
+static void convert_row_565(uint16_t *dst, const uint8_t *src, int width)
+{
+    memcpy(dst, src, (size_t)width * 2);
+}
+
+/*
+ * RGB555 / ARGB1555 to RGB565 (alpha discarded)
+ *
+ * -RRRRRGGGGGBBBBB -> RRRRRGGGGG0BBBBB: shift red and green up by one
+ * and leave blue in place.
+ */
+static void convert_row_555(uint16_t *dst, const uint8_t *src, int width)
+{
+    const uint16_t *src16 = (const uint16_t*)src;
+    int x = 0;
+
+#ifdef __SSE2__
+    const __m128i rg_mask = _mm_set1_epi16(0x7FE0);
+    const __m128i b_mask = _mm_set1_epi16(0x001F);
+    for (; x + 8 <= width; x += 8) {
+        __m128i pix = _mm_loadu_si128((const __m128i*)&src16[x]);
+        __m128i rg = _mm_slli_epi16(_mm_and_si128(pix, rg_mask), 1);
+        __m128i b = _mm_and_si128(pix, b_mask);
+        _mm_storeu_si128((__m128i*)&dst[x], _mm_or_si128(rg, b));
+    }
+#endif
+
+    for (; x < width; x++) {
+        uint16_t pix = src16[x];
+        dst[x] = (uint16_t)(((pix & 0x7FE0) << 1) | (pix & 0x001F));
+    }
+}
+
+/* RGB888 (B, G, R byte order) to RGB565 */
+static void convert_row_888(uint16_t *dst, const uint8_t *src, int width)
+{
+    for (int x = 0; x < width; x++) {
+        uint8_t b = src[x * 3 + 0];
+        uint8_t g = src[x * 3 + 1];
+        uint8_t r = src[x * 3 + 2];
+        dst[x] = (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    }
+}
+
+/* ARGB8888 to RGB565 (alpha discarded) */
+static void convert_row_8888(uint16_t *dst, const uint8_t *src, int width)
+{
+    const uint32_t *src32 = (const uint32_t*)src;
+    int x = 0;
+
+#ifdef __SSE2__
+    const __m128i r_mask = _mm_set1_epi32(0xF800);
+    const __m128i g_mask = _mm_set1_epi32(0x07E0);
+    const __m128i b_mask = _mm_set1_epi32(0x001F);
+    for (; x + 8 <= width; x += 8) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)&src32[x]);
+        __m128i hi = _mm_loadu_si128((const __m128i*)&src32[x + 4]);
+
+        lo = _mm_or_si128(_mm_or_si128(
+                 _mm_and_si128(_mm_srli_epi32(lo, 8), r_mask),
+                 _mm_and_si128(_mm_srli_epi32(lo, 5), g_mask)),
+                 _mm_and_si128(_mm_srli_epi32(lo, 3), b_mask));
+        hi = _mm_or_si128(_mm_or_si128(
+                 _mm_and_si128(_mm_srli_epi32(hi, 8), r_mask),
+                 _mm_and_si128(_mm_srli_epi32(hi, 5), g_mask)),
+                 _mm_and_si128(_mm_srli_epi32(hi, 3), b_mask));
+
+        /* Sign-extend the 16-bit results so the saturating pack keeps
+           them unchanged */
+        lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+        hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+        _mm_storeu_si128((__m128i*)&dst[x], _mm_packs_epi32(lo, hi));
+    }
+#endif
+
+    for (; x < width; x++) {
+        uint32_t pix = src32[x];
+        dst[x] = (uint16_t)(((pix >> 8) & 0xF800) | ((pix >> 5) & 0x07E0) | ((pix >> 3) & 0x001F));
+    }
+}
+
+/* Converter for a grLfbLock() write mode */
+static lfb_row_converter get_writemode_converter(GrLfbWriteMode_t mode)
+{
+    switch (mode) {
+    case GR_LFBWRITEMODE_555:
+    case GR_LFBWRITEMODE_1555:
+        return convert_row_555;
+    case GR_LFBWRITEMODE_888:
+        return convert_row_888;
+    case GR_LFBWRITEMODE_8888:
+        return convert_row_8888;
+    default:
+        /* 565 or unknown - direct copy */
+        return convert_row_565;
+    }
+}
+
+/* Converter for a grLfbWriteRegion() source format */
+static lfb_row_converter get_srcfmt_converter(GrLfbSrcFmt_t format)
+{
+    switch (format) {
+    case GR_LFB_SRC_FMT_555:
+    case GR_LFB_SRC_FMT_1555:
+        return convert_row_555;
+    case GR_LFB_SRC_FMT_888:
+        return convert_row_888;
+    case GR_LFB_SRC_FMT_8888:
+        return convert_row_8888;
+    default:
+        /* 565 or unknown - direct copy assuming 16-bit */
+        return convert_row_565;
+    }
+}
+
+/*
+ * Get the offset of a buffer in fbi.ram, or ~0 if the buffer is invalid
+ */
+static uint32_t get_buffer_offset(GrBuffer_t buffer)
+{
+    switch (buffer) {
+    case GR_BUFFER_FRONTBUFFER:
+        return g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf];
+    case GR_BUFFER_BACKBUFFER:
+        return g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf];
+    case GR_BUFFER_AUXBUFFER:
+    case GR_BUFFER_DEPTHBUFFER:
+        return g_voodoo->fbi.auxoffs;
+    default:
+        return (uint32_t)(~0);
+    }
+}
+
 /*
  * grLfbLock - Lock a buffer for direct CPU access
  *
@@ -132,6 +280,11 @@ static int get_writemode_bpp(GrLfbWriteMode_t mode)
  * we allocate a shadow buffer at that bit depth, return it to the app,
  * and convert to 16-bit on grLfbUnlock(). This fixes the "ZARDBLIZ" bug
  * in Diablo 2 where 32-bit writes with 16-bit stride caused wrapping.
+ *
+ * TILED FRAMEBUFFER:
+ * With GLIDE3X_TILED_FB=1 the buffers aren't linear, so 16-bit and read
+ * locks get a linear copy (g_lfb_linear_buffer) instead of a pointer into
+ * fbi.ram; write locks store it back on grLfbUnlock().
  */
 FxBool __stdcall grLfbLock(GrLock_t type, GrBuffer_t buffer, GrLfbWriteMode_t writeMode,
                  GrOriginLocation_t origin, FxBool pixelPipeline, GrLfbInfo_t *info)
@@ -201,21 +354,35 @@ FxBool __stdcall grLfbLock(GrLock_t type, GrBuffer_t buffer, GrLfbWriteMode_t wr
     } else {
         /* 16-bit mode or read-only: return direct framebuffer pointer */
         uint8_t *bufptr;
-        switch (buffer) {
-        case GR_BUFFER_FRONTBUFFER:
-            bufptr = g_voodoo->fbi.ram + g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf];
-            break;
-        case GR_BUFFER_BACKBUFFER:
-            bufptr = g_voodoo->fbi.ram + g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf];
-            break;
-        case GR_BUFFER_AUXBUFFER:
-        case GR_BUFFER_DEPTHBUFFER:
-            bufptr = g_voodoo->fbi.ram + g_voodoo->fbi.auxoffs;
-            break;
-        default:
+        uint32_t bufoffs = get_buffer_offset(buffer);
+        if (bufoffs == (uint32_t)(~0)) {
             return FXFALSE;
         }
 
+        if (g_voodoo->fbi.x_tiles) {
+            /*
+             * Tiled layout: hand out a linear copy of the buffer instead,
+             * written back on unlock for write locks.
+             */
+            size_t needed_size = (size_t)width * height * 2;
+            if (g_lfb_linear_buffer_size < needed_size) {
+                free(g_lfb_linear_buffer);
+                g_lfb_linear_buffer = (uint16_t*)malloc(needed_size);
+                if (!g_lfb_linear_buffer) {
+                    g_lfb_linear_buffer_size = 0;
+                    return FXFALSE;
+                }
+                g_lfb_linear_buffer_size = needed_size;
+            }
+            voodoo_fbi_read_rect(&g_voodoo->fbi, bufoffs, 0, 0, width, height,
+                                 g_lfb_linear_buffer, width);
+            g_lfb_linear_offs = bufoffs;
+            g_lfb_linear_target = buffer;
+            bufptr = (uint8_t*)g_lfb_linear_buffer;
+        } else {
+            bufptr = g_voodoo->fbi.ram + bufoffs;
+        }
+
         /* No shadow buffer in use */
         g_lfb_shadow_target = (GrBuffer_t)-1;
 
@@ -237,19 +404,11 @@ static void convert_shadow_to_framebuffer(GrBuffer_t buffer)
     if (!g_voodoo || !g_lfb_shadow_buffer) return;
 
     /* Get destination buffer */
-    uint16_t *dest;
-    switch (buffer) {
-    case GR_BUFFER_FRONTBUFFER:
-        dest = (uint16_t*)(g_voodoo->fbi.ram +
-                           g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf]);
-        break;
-    case GR_BUFFER_BACKBUFFER:
-        dest = (uint16_t*)(g_voodoo->fbi.ram +
-                           g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf]);
-        break;
-    default:
+    if (buffer != GR_BUFFER_FRONTBUFFER && buffer != GR_BUFFER_BACKBUFFER) {
         return;
     }
+    uint32_t destoffs = get_buffer_offset(buffer);
+    uint16_t *dest = (uint16_t*)(g_voodoo->fbi.ram + destoffs);
 
     int width = g_lfb_shadow_width;
     int height = g_lfb_shadow_height;
@@ -257,69 +416,26 @@ static void convert_shadow_to_framebuffer(GrBuffer_t buffer)
     int src_stride = width * bpp;
     int dst_stride = g_voodoo->fbi.rowpixels;
 
+    /* Tiled layout: convert each row into a linear row, then store it */
+    uint16_t *tiled_row = NULL;
+    if (g_voodoo->fbi.x_tiles) {
+        tiled_row = (uint16_t*)malloc((size_t)width * 2);
+        if (!tiled_row) return;
+    }
+
+    /* Pick the row converter once for the whole buffer */
+    lfb_row_converter convert_row = get_writemode_converter(g_lfb_write_mode);
+
     for (int y = 0; y < height; y++) {
-        uint16_t *dst_row = &dest[y * dst_stride];
-        uint8_t *src_row = &g_lfb_shadow_buffer[y * src_stride];
-
-        switch (g_lfb_write_mode) {
-        case GR_LFBWRITEMODE_8888:
-            /* Convert ARGB8888 to RGB565 */
-            {
-                uint32_t *src32 = (uint32_t*)src_row;
-                for (int x = 0; x < width; x++) {
-                    uint32_t pix = src32[x];
-                    uint8_t r = (pix >> 16) & 0xFF;
-                    uint8_t g = (pix >> 8) & 0xFF;
-                    uint8_t b = pix & 0xFF;
-                    dst_row[x] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
-                }
-            }
-            break;
-
-        case GR_LFBWRITEMODE_888:
-            /* Convert RGB888 to RGB565 */
-            for (int x = 0; x < width; x++) {
-                uint8_t b = src_row[x * 3 + 0];
-                uint8_t g = src_row[x * 3 + 1];
-                uint8_t r = src_row[x * 3 + 2];
-                dst_row[x] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
-            }
-            break;
-
-        case GR_LFBWRITEMODE_555:
-            /* Convert RGB555 to RGB565 */
-            {
-                uint16_t *src16 = (uint16_t*)src_row;
-                for (int x = 0; x < width; x++) {
-                    uint16_t pix = src16[x];
-                    uint16_t r = (pix >> 10) & 0x1F;
-                    uint16_t g = (pix >> 5) & 0x1F;
-                    uint16_t b = pix & 0x1F;
-                    dst_row[x] = (r << 11) | (g << 6) | b;
-                }
-            }
-            break;
-
-        case GR_LFBWRITEMODE_1555:
-            /* Convert ARGB1555 to RGB565 (discard alpha) */
-            {
-                uint16_t *src16 = (uint16_t*)src_row;
-                for (int x = 0; x < width; x++) {
-                    uint16_t pix = src16[x];
-                    uint16_t r = (pix >> 10) & 0x1F;
-                    uint16_t g = (pix >> 5) & 0x1F;
-                    uint16_t b = pix & 0x1F;
-                    dst_row[x] = (r << 11) | (g << 6) | b;
-                }
-            }
-            break;
+        uint16_t *dst_row = tiled_row ? tiled_row : &dest[y * dst_stride];
+        convert_row(dst_row, &g_lfb_shadow_buffer[y * src_stride], width);
 
-        default:
-            /* 565 or unknown - direct copy */
-            memcpy(dst_row, src_row, width * 2);
-            break;
+        if (tiled_row) {
+            voodoo_fbi_write_rect(&g_voodoo->fbi, destoffs, 0, y, width, 1, tiled_row, width);
         }
     }
+
+    free(tiled_row);
 }
 
 /*
@@ -362,12 +478,19 @@ FxBool __stdcall grLfbUnlock(GrLock_t type, GrBuffer_t buffer)
         g_lfb_shadow_target = (GrBuffer_t)-1;  /* Mark shadow as processed */
     }
 
+    /* If a linear copy of a tiled buffer was handed out, write it back */
+    if (g_lfb_linear_target == buffer && g_lfb_linear_buffer) {
+        if (type & GR_LFB_WRITE_ONLY) {
+            voodoo_fbi_write_rect(&g_voodoo->fbi, g_lfb_linear_offs, 0, 0,
+                                  g_voodoo->fbi.width, g_voodoo->fbi.height,
+                                  g_lfb_linear_buffer, g_voodoo->fbi.width);
+        }
+        g_lfb_linear_target = (GrBuffer_t)-1;
+    }
+
     /* If this was a write lock on front buffer, present immediately */
     if (type == GR_LFB_WRITE_ONLY && buffer == GR_BUFFER_FRONTBUFFER) {
-        uint16_t *frontbuf = (uint16_t*)(g_voodoo->fbi.ram +
-                                          g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf]);
-
-        display_present(frontbuf, g_voodoo->fbi.width, g_voodoo->fbi.height);
+        display_present(&g_voodoo->fbi, g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf]);
     }
 
     return FXTRUE;
@@ -423,100 +546,35 @@ FxBool __stdcall grLfbWriteRegion(GrBuffer_t dst_buffer, FxU32 dst_x, FxU32 dst_
     (void)pixelPipeline;   /* We don't support pipeline mode */
 
     /* Get destination buffer */
-    uint16_t *dest;
-    switch (dst_buffer) {
-    case GR_BUFFER_FRONTBUFFER:
-        dest = (uint16_t*)(g_voodoo->fbi.ram +
-                           g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf]);
-        break;
-    case GR_BUFFER_BACKBUFFER:
-        dest = (uint16_t*)(g_voodoo->fbi.ram +
-                           g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf]);
-        break;
-    case GR_BUFFER_AUXBUFFER:
-    case GR_BUFFER_DEPTHBUFFER:
-        dest = (uint16_t*)(g_voodoo->fbi.ram + g_voodoo->fbi.auxoffs);
-        break;
-    default:
+    uint32_t destoffs = get_buffer_offset(dst_buffer);
+    if (destoffs == (uint32_t)(~0)) {
         return FXFALSE;
     }
+    uint16_t *dest = (uint16_t*)(g_voodoo->fbi.ram + destoffs);
+
+    /* Tiled layout: convert each row into a linear row, then store it */
+    uint16_t *tiled_row = NULL;
+    if (g_voodoo->fbi.x_tiles) {
+        tiled_row = (uint16_t*)malloc((size_t)src_width * 2);
+        if (!tiled_row) return FXFALSE;
+    }
 
     /* Copy data row by row with format conversion if needed */
     uint8_t *src = (uint8_t*)src_data;
+    lfb_row_converter convert_row = get_srcfmt_converter(src_format);
 
     for (FxU32 y = 0; y < src_height; y++) {
-        uint16_t *dst_row = &dest[(dst_y + y) * g_voodoo->fbi.rowpixels + dst_x];
-
-        switch (src_format) {
-        case GR_LFB_SRC_FMT_565:
-            /* Direct copy - native format */
-            memcpy(dst_row, &src[y * src_stride], src_width * 2);
-            break;
-
-        case GR_LFB_SRC_FMT_555:
-            /* Convert RGB555 to RGB565 */
-            {
-                uint16_t *src_row = (uint16_t*)&src[y * src_stride];
-                for (FxU32 x = 0; x < src_width; x++) {
-                    uint16_t pix = src_row[x];
-                    /* RGB555: -RRRRRGGGGGBBBBB -> RGB565: RRRRRGGGGGGBBBBB */
-                    uint16_t r = (pix >> 10) & 0x1F;
-                    uint16_t g = (pix >> 5) & 0x1F;
-                    uint16_t b = pix & 0x1F;
-                    dst_row[x] = (r << 11) | (g << 6) | b;
-                }
-            }
-            break;
-
-        case GR_LFB_SRC_FMT_1555:
-            /* Convert ARGB1555 to RGB565 (discard alpha) */
-            {
-                uint16_t *src_row = (uint16_t*)&src[y * src_stride];
-                for (FxU32 x = 0; x < src_width; x++) {
-                    uint16_t pix = src_row[x];
-                    /* ARGB1555: ARRRRRGGGGGBBBBB -> RGB565: RRRRRGGGGGGBBBBB */
-                    uint16_t r = (pix >> 10) & 0x1F;
-                    uint16_t g = (pix >> 5) & 0x1F;
-                    uint16_t b = pix & 0x1F;
-                    dst_row[x] = (r << 11) | (g << 6) | b;
-                }
-            }
-            break;
-
-        case GR_LFB_SRC_FMT_888:
-            /* Convert RGB888 to RGB565 */
-            {
-                uint8_t *src_row = &src[y * src_stride];
-                for (FxU32 x = 0; x < src_width; x++) {
-                    uint8_t b = src_row[x * 3 + 0];
-                    uint8_t g = src_row[x * 3 + 1];
-                    uint8_t r = src_row[x * 3 + 2];
-                    dst_row[x] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
-                }
-            }
-            break;
-
-        case GR_LFB_SRC_FMT_8888:
-            /* Convert ARGB8888 to RGB565 (discard alpha) */
-            {
-                uint32_t *src_row = (uint32_t*)&src[y * src_stride];
-                for (FxU32 x = 0; x < src_width; x++) {
-                    uint32_t pix = src_row[x];
-                    uint8_t r = (pix >> 16) & 0xFF;
-                    uint8_t g = (pix >> 8) & 0xFF;
-                    uint8_t b = pix & 0xFF;
-                    dst_row[x] = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
-                }
-            }
-            break;
+        uint16_t *dst_row = tiled_row ? tiled_row
+                                      : &dest[(dst_y + y) * g_voodoo->fbi.rowpixels + dst_x];
+        convert_row(dst_row, &src[y * src_stride], (int)src_width);
 
-        default:
-            /* Unknown format - try direct copy assuming 16-bit */
-            memcpy(dst_row, &src[y * src_stride], src_width * 2);
-            break;
+        if (tiled_row) {
+            voodoo_fbi_write_rect(&g_voodoo->fbi, destoffs, (int)dst_x, (int)(dst_y + y),
+                                  (int)src_width, 1, tiled_row, (int)src_width);
         }
     }
 
+    free(tiled_row);
     return FXTRUE;
 }
 
@@ -567,30 +625,16 @@ FxBool __stdcall grLfbReadRegion(GrBuffer_t src_buffer, FxU32 src_x, FxU32 src_y
     }
 
     /* Get source buffer */
-    uint16_t *src;
-    switch (src_buffer) {
-    case GR_BUFFER_FRONTBUFFER:
-        src = (uint16_t*)(g_voodoo->fbi.ram +
-                          g_voodoo->fbi.rgboffs[g_voodoo->fbi.frontbuf]);
-        break;
-    case GR_BUFFER_BACKBUFFER:
-        src = (uint16_t*)(g_voodoo->fbi.ram +
-                          g_voodoo->fbi.rgboffs[g_voodoo->fbi.backbuf]);
-        break;
-    case GR_BUFFER_AUXBUFFER:
-    case GR_BUFFER_DEPTHBUFFER:
-        src = (uint16_t*)(g_voodoo->fbi.ram + g_voodoo->fbi.auxoffs);
-        break;
-    default:
+    uint32_t srcoffs = get_buffer_offset(src_buffer);
+    if (srcoffs == (uint32_t)(~0)) {
         return FXFALSE;
     }
 
-    /* Copy data row by row */
+    /* Copy data row by row (resolving tiles if needed) */
     uint8_t *dst = (uint8_t*)dst_data;
     for (FxU32 y = 0; y < src_height; y++) {
-        memcpy(&dst[y * dst_stride],
-               &src[(src_y + y) * g_voodoo->fbi.rowpixels + src_x],
-               src_width * 2);
+        voodoo_fbi_read_rect(&g_voodoo->fbi, srcoffs, (int)src_x, (int)(src_y + y),
+                             (int)src_width, 1, (uint16_t*)&dst[y * dst_stride], 0);
     }
 
     return FXTRUE;
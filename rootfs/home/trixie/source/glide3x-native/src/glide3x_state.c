@@ -99,6 +99,12 @@ int g_lfb_shadow_width = 0;
 int g_lfb_shadow_height = 0;
 GrBuffer_t g_lfb_shadow_target = 0;
 
+/* Linear copy of a locked buffer for the tiled framebuffer layout */
+uint16_t *g_lfb_linear_buffer = NULL;
+size_t g_lfb_linear_buffer_size = 0;
+uint32_t g_lfb_linear_offs = 0;
+GrBuffer_t g_lfb_linear_target = (GrBuffer_t)-1;
+
 /*************************************
  * FPS tracking for performance baseline
  *************************************/
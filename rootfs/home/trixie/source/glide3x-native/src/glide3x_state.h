@@ -155,6 +155,18 @@ extern int g_lfb_shadow_width;
 extern int g_lfb_shadow_height;
 extern GrBuffer_t g_lfb_shadow_target;  /* Which buffer to write to on unlock */
 
+/*
+ * g_lfb_linear_buffer - Linear copy of a locked buffer (tiled layout only)
+ *
+ * With the tiled framebuffer layout there is no linear buffer to point a
+ * 16-bit or read lock at, so grLfbLock() resolves the buffer into this
+ * copy and grLfbUnlock() writes it back for write locks.
+ */
+extern uint16_t *g_lfb_linear_buffer;
+extern size_t g_lfb_linear_buffer_size;
+extern uint32_t g_lfb_linear_offs;       /* Buffer offset in fbi.ram */
+extern GrBuffer_t g_lfb_linear_target;   /* Locked buffer, or -1 */
+
 
 
 /*************************************
@@ -188,8 +200,8 @@ extern void display_shutdown(void);
 /* Destroy the display window */
 extern void display_destroy_window(void);
 
-/* Present a framebuffer to the screen */
-extern void display_present(uint16_t *framebuffer, int width, int height);
+/* Present a color buffer (one of fbi->rgboffs[]) to the screen */
+extern void display_present(const fbi_state *fbi, uint32_t bufoffs);
 
 /*************************************
  * Helper functions
@@ -116,6 +116,7 @@ static int get_texel_bytes(GrTextureFormat_t format)
     case GR_TEXFMT_ARGB_1555:
     case GR_TEXFMT_ARGB_4444:
     case GR_TEXFMT_ALPHA_INTENSITY_88:
+    case GR_TEXFMT_AYIQ_8422:
     case GR_TEXFMT_AP_88:
         return 2;
     default:
@@ -157,6 +158,7 @@ static int get_voodoo_format(GrTextureFormat_t format)
     case GR_TEXFMT_INTENSITY_8:        return 3;   /* I 8 */
     case GR_TEXFMT_ALPHA_INTENSITY_44: return 4;   /* AI 4-4 */
     case GR_TEXFMT_P_8:                return 5;   /* P 8 */
+    case GR_TEXFMT_AYIQ_8422:          return 9;   /* AYIQ 8-4-2-2 */
     case GR_TEXFMT_RGB_565:            return 10;  /* RGB 5-6-5 */
     case GR_TEXFMT_ARGB_1555:          return 11;  /* ARGB 1-5-5-5 */
     case GR_TEXFMT_ARGB_4444:          return 12;  /* ARGB 4-4-4-4 */
@@ -168,13 +170,14 @@ static int get_voodoo_format(GrTextureFormat_t format)
 /*
  * Helper: Check if format can be pre-converted to ARGB32
  *
- * YIQ_422 (NCC) and AP_88 formats are not pre-converted due to complexity.
+ * AP_88 is not pre-converted due to complexity.
  * P_8 (palettized) IS pre-converted and tracked for reconversion on palette change.
+ * YIQ_422/AYIQ_8422 (NCC) are pre-converted by the emulator, which tracks
+ * the table each region was converted with (see voodoo_ncc_preconvert).
  */
 static int can_preconvert(GrTextureFormat_t format)
 {
     switch (format) {
-    case GR_TEXFMT_YIQ_422:  /* NCC table - too complex to track */
     case GR_TEXFMT_AP_88:    /* Alpha + palette index - rarely used */
         return 0;
     default:
@@ -256,7 +259,23 @@ static void preconvert_texture_data(tmu_state *ts, uint32_t dest_addr,
 {
     (void)data;  /* Used only for distinguishing fresh uploads in debug builds */
 
-    if (!ts->argb32_ram || !can_preconvert(format)) {
+    if (!ts->argb32_ram) {
+        return;
+    }
+
+    /* NCC textures are converted (and tracked) by the emulator, which
+       reads them back from TMU RAM */
+    int texel_bytes = get_texel_bytes(format);
+    if (format == GR_TEXFMT_YIQ_422 || format == GR_TEXFMT_AYIQ_8422) {
+        untrack_p8_region(ts, dest_addr, num_texels);
+        voodoo_ncc_preconvert(ts, dest_addr, (uint32_t)num_texels * texel_bytes, texel_bytes);
+        return;
+    }
+
+    /* Non-NCC texture may overwrite an NCC region */
+    voodoo_ncc_untrack(ts, dest_addr, (uint32_t)num_texels * texel_bytes);
+
+    if (!can_preconvert(format)) {
         return;
     }
 
@@ -1199,7 +1218,12 @@ void __stdcall grTexDownloadTable(GrTexTable_t type, void *data)
         switch (type) {
         case GR_TEXTABLE_NCC0:
         case GR_TEXTABLE_NCC1:
-            /* TODO: NCC decompression tables for YIQ textures - not implemented */
+            /*
+             * The packed table holds the 12 NCC register values. NCC
+             * textures pre-converted with an older table are brought up to
+             * date the next time they are drawn.
+             */
+            voodoo_ncc_table_load(ts, type, ((const GuNccTable*)data)->packed_data);
             break;
 
         case GR_TEXTABLE_PALETTE:
@@ -1231,3 +1255,28 @@ void __stdcall grTexDownloadTable(GrTexTable_t type, void *data)
         ts->regdirty = 1;
     }
 }
+
+/*
+ * grTexNCCTable - Select the NCC table used by YIQ textures
+ */
+void __stdcall grTexNCCTable(GrNCCTable_t table)
+{
+    if (!g_voodoo) {
+        return;
+    }
+
+    for (int t = 0; t < 2; t++) {
+        tmu_state *ts = &g_voodoo->tmu[t];
+
+        if (!ts->reg) {
+            continue;
+        }
+
+        if (table == GR_NCCTABLE_NCC1)
+            ts->reg[textureMode].u |= TEXMODE_NCC_TABLE_SELECT_BIT;
+        else
+            ts->reg[textureMode].u &= ~TEXMODE_NCC_TABLE_SELECT_BIT;
+
+        ts->regdirty = 1;
+    }
+}
@@ -302,6 +302,7 @@ typedef enum {
 /* Bit positions and masks for setting register values */
 #define TEXMODE_MINIFICATION_FILTER_BIT     (1 << 1)
 #define TEXMODE_MAGNIFICATION_FILTER_BIT    (1 << 2)
+#define TEXMODE_NCC_TABLE_SELECT_BIT        (1 << 5)
 #define TEXMODE_CLAMP_S_BIT                 (1 << 6)
 #define TEXMODE_CLAMP_T_BIT                 (1 << 7)
 #define TEXMODE_FORMAT_SHIFT                8
@@ -217,6 +217,187 @@ static void ncc_table_update(ncc_table* n)
     n->dirty = false;
 }
 
+/* Identifies the contents of an NCC table (FNV-1a over its registers) */
+static uint64_t ncc_table_key(const ncc_table* n)
+{
+    uint64_t key = 1469598103934665603ull;
+    for (int i = 0; i < 12; i++) {
+        key = (key ^ n->reg[i].u) * 1099511628211ull;
+    }
+    return key;
+}
+
+/* Load an NCC table from the 12 register values of a GuNccTable */
+void voodoo_ncc_table_load(tmu_state* t, int which, const uint32_t packed[12])
+{
+    ncc_table* n = &t->ncc[which];
+
+    for (uint32_t i = 0; i < 12; i++) {
+        ncc_table_write(n, i, packed[i]);
+    }
+    if (n->dirty) {
+        ncc_table_update(n);
+        t->regdirty = true;
+    }
+}
+
+/* Convert an NCC region of TMU RAM into argb32_ram */
+static void ncc_convert(tmu_state* t, uint32_t start, uint32_t size,
+                        int texel_bytes, const rgb_t* texel)
+{
+    if (texel_bytes == 1) {
+        for (uint32_t i = 0; i < size; i++) {
+            const uint32_t addr = (start + i) & t->mask;
+            t->argb32_ram[addr] = texel[t->ram[addr]];
+        }
+    }
+    else {
+        /* AYIQ 8-4-2-2: alpha in the high byte */
+        for (uint32_t i = 0; i + 1 < size; i += 2) {
+            const uint32_t addr = (start + i) & t->mask;
+            const uint16_t val = *(const uint16_t*)&t->ram[addr];
+            t->argb32_ram[addr] = (texel[val & 0xff] & 0xffffff) |
+                ((uint32_t)(val & 0xff00) << 16);
+        }
+    }
+}
+
+/* The selected NCC table, brought up to date */
+static ncc_table* ncc_selected_table(tmu_state* t)
+{
+    ncc_table* n = &t->ncc[TEXMODE_NCC_TABLE_SELECT(t->reg[textureMode].u)];
+    if (n->dirty) {
+        ncc_table_update(n);
+    }
+    return n;
+}
+
+/* Stop tracking NCC regions overlapping [addr, addr + size) */
+void voodoo_ncc_untrack(tmu_state* t, uint32_t addr, uint32_t size)
+{
+    const uint32_t end = addr + size;
+
+    for (int i = 0; i < t->ncc_region_count; ) {
+        const ncc_region* r = &t->ncc_regions[i];
+        if (addr < r->start_addr + r->size && end > r->start_addr) {
+            t->ncc_regions[i] = t->ncc_regions[t->ncc_region_count - 1];
+            t->ncc_region_count--;
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+/*
+ * Pre-convert NCC texels just downloaded to [addr, addr + size) with the
+ * selected NCC table. A partial download into a tracked region converts
+ * the downloaded part only, unless the region was converted with another
+ * table, in which case the whole region is brought up to date.
+ */
+void voodoo_ncc_preconvert(tmu_state* t, uint32_t addr, uint32_t size, int texel_bytes)
+{
+    if (!t->argb32_ram) {
+        return;
+    }
+
+    const ncc_table* n = ncc_selected_table(t);
+    const uint64_t key = ncc_table_key(n);
+
+    for (int i = 0; i < t->ncc_region_count; i++) {
+        ncc_region* r = &t->ncc_regions[i];
+        if (r->texel_bytes == texel_bytes && addr >= r->start_addr &&
+            addr + size <= r->start_addr + r->size) {
+            if (r->table_key == key) {
+                ncc_convert(t, addr, size, texel_bytes, n->texel);
+            }
+            else {
+                ncc_convert(t, r->start_addr, r->size, texel_bytes, n->texel);
+                r->table_key = key;
+            }
+            t->regdirty = true;
+            return;
+        }
+    }
+
+    voodoo_ncc_untrack(t, addr, size);
+    ncc_convert(t, addr, size, texel_bytes, n->texel);
+
+    /* Untracked texels simply fall back to the per-texel lookup */
+    if (t->ncc_region_count < MAX_NCC_REGIONS) {
+        ncc_region* r = &t->ncc_regions[t->ncc_region_count++];
+        r->start_addr = addr;
+        r->size = size;
+        r->texel_bytes = (uint8_t)texel_bytes;
+        r->table_key = key;
+    }
+    t->regdirty = true;
+}
+
+/*
+ * Check that [start, end) is covered by pre-converted regions, reconverting
+ * those made with a different table
+ */
+static bool ncc_prepare_range(tmu_state* t, const ncc_table* n, uint64_t key,
+                              uint32_t start, uint32_t end, int texel_bytes)
+{
+    uint32_t pos = start;
+    while (pos < end) {
+        ncc_region* found = NULL;
+        for (int i = 0; i < t->ncc_region_count; i++) {
+            ncc_region* r = &t->ncc_regions[i];
+            if (r->texel_bytes == texel_bytes && pos >= r->start_addr &&
+                pos < r->start_addr + r->size) {
+                found = r;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+        if (found->table_key != key) {
+            ncc_convert(t, found->start_addr, found->size, texel_bytes, n->texel);
+            found->table_key = key;
+        }
+        pos = found->start_addr + found->size;
+    }
+    return true;
+}
+
+/*
+ * Check that every LOD the current NCC texture can sample is pre-converted
+ * with the selected table. Returns false if the texture has to be decoded
+ * per texel instead.
+ */
+static bool ncc_prepare_texture(tmu_state* t, const ncc_table* n, int texel_bytes)
+{
+    if (!t->argb32_ram) {
+        return false;
+    }
+
+    const uint64_t key = ncc_table_key(n);
+    const int lodmin = t->lodmin >> 8;
+    const int lodmax = (t->lodmax >> 8) < 8 ? (t->lodmax >> 8) : 8;
+
+    /* Only the LODs between lodmin and lodmax were downloaded; the base
+       address may well point below the first of them */
+    for (int lod = lodmin; lod <= lodmax; lod++) {
+        if ((t->lodmask & (1 << lod)) == 0u) {
+            continue;
+        }
+        /* Only the texels the sampler can address; the 4-texel minimum
+           applies to the spacing between LODs, not to what is read */
+        const uint32_t size = ((t->wmask >> lod) + 1) * ((t->hmask >> lod) + 1);
+        const uint32_t start = t->lodoffset[lod];
+        const uint32_t end = start + size * texel_bytes;
+        if (end > t->mask + 1 ||
+            !ncc_prepare_range(t, n, key, start, end, texel_bytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 
 
 /*************************************
@@ -498,6 +679,8 @@ void voodoo_init_fbi(fbi_state *f, int fbmem)
     f->width = 640;
     f->height = 480;
     f->rowpixels = 640;
+    f->tile_width = f->tile_height = 0;
+    f->x_tiles = 0;
 
     f->vblank = 0;
 
@@ -512,6 +695,99 @@ void voodoo_init_fbi(fbi_state *f, int fbmem)
     memset(&f->lfb_stats, 0, sizeof(f->lfb_stats));
 }
 
+/* Tiled framebuffer layout, opt-in via GLIDE3X_TILED_FB=1 */
+static int get_tiled_framebuffer(void)
+{
+    const char *env = getenv("GLIDE3X_TILED_FB");
+    return env && atoi(env) > 0;
+}
+
+/*
+ * Set up the buffer offsets for a width x height screen with three color
+ * buffers and a depth buffer. Falls back to the linear layout if the
+ * tiled one (padded to whole tiles) doesn't fit in frame buffer RAM.
+ */
+void voodoo_fbi_set_layout(fbi_state *f, int width, int height)
+{
+    f->width = width;
+    f->height = height;
+    f->rowpixels = width;
+    f->tile_width = f->tile_height = 0;
+    f->x_tiles = 0;
+
+    if (get_tiled_framebuffer()) {
+        const uint32_t x_tiles = (width + FBI_TILE_SIZE - 1) >> FBI_TILE_SHIFT;
+        const uint32_t y_tiles = (height + FBI_TILE_SIZE - 1) >> FBI_TILE_SHIFT;
+        const uint64_t tiled_size = (uint64_t)x_tiles * y_tiles * FBI_TILE_STRIDE * 2;
+
+        if (tiled_size <= (uint64_t)f->mask + 1) {
+            f->tile_width = f->tile_height = FBI_TILE_SIZE;
+            f->x_tiles = x_tiles;
+            f->rgboffs[0] = 0;
+            f->rgboffs[1] = FBI_TILE_PLANE_PIXELS * 2;
+            f->rgboffs[2] = FBI_TILE_PLANE_PIXELS * 2 * 2;
+            f->auxoffs = FBI_TILE_PLANE_PIXELS * 2 * 3;
+            return;
+        }
+    }
+
+    /* Linear: front, back, triple and depth buffers one after another */
+    const uint32_t buffer_size = (uint32_t)width * height * 2;
+    f->rgboffs[0] = 0;
+    f->rgboffs[1] = buffer_size;
+    f->rgboffs[2] = buffer_size * 2;
+    f->auxoffs = buffer_size * 3;
+}
+
+/* Copy a rectangle of a buffer out to linear rows */
+void voodoo_fbi_read_rect(const fbi_state *f, uint32_t bufoffs, int x, int y,
+                          int width, int height, uint16_t *dst, int dst_stride)
+{
+    const uint16_t *base = (const uint16_t*)(f->ram + bufoffs);
+
+    for (int row = 0; row < height; row++) {
+        const uint16_t *src = base + fbi_row_offset(f, (uint32_t)(y + row));
+        uint16_t *out = dst + (size_t)row * dst_stride;
+
+        if (!f->x_tiles) {
+            memcpy(out, src + x, (size_t)width * 2);
+            continue;
+        }
+        /* One memcpy per tile the row passes through */
+        for (int col = 0; col < width; ) {
+            const int sx = x + col;
+            int run = FBI_TILE_SIZE - (sx & (FBI_TILE_SIZE - 1));
+            if (run > width - col) run = width - col;
+            memcpy(out + col, src + fbi_column_offset(f, (uint32_t)sx), (size_t)run * 2);
+            col += run;
+        }
+    }
+}
+
+/* Copy linear rows into a rectangle of a buffer */
+void voodoo_fbi_write_rect(fbi_state *f, uint32_t bufoffs, int x, int y,
+                           int width, int height, const uint16_t *src, int src_stride)
+{
+    uint16_t *base = (uint16_t*)(f->ram + bufoffs);
+
+    for (int row = 0; row < height; row++) {
+        uint16_t *dst = base + fbi_row_offset(f, (uint32_t)(y + row));
+        const uint16_t *in = src + (size_t)row * src_stride;
+
+        if (!f->x_tiles) {
+            memcpy(dst + x, in, (size_t)width * 2);
+            continue;
+        }
+        for (int col = 0; col < width; ) {
+            const int dx = x + col;
+            int run = FBI_TILE_SIZE - (dx & (FBI_TILE_SIZE - 1));
+            if (run > width - col) run = width - col;
+            memcpy(dst + fbi_column_offset(f, (uint32_t)dx), in + col, (size_t)run * 2);
+            col += run;
+        }
+    }
+}
+
 /*************************************
  * TMU (Texture Mapping Unit) init
  *************************************/
@@ -747,12 +1023,17 @@ static void raster_generic(voodoo_state* vs, uint32_t TMUS, uint32_t TEXMODE0,
     }
 
     /* get pointers to the target buffer and depth buffer */
-    uint16_t* dest = (uint16_t*)destbase + scry * fbi->rowpixels;
+    const uint32_t rowoffs = fbi_row_offset(fbi, (uint32_t)scry);
+    uint16_t* dest = (uint16_t*)destbase + rowoffs;
     uint16_t* depth = (fbi->auxoffs != (uint32_t)(~0))
-        ? ((uint16_t*)(fbi->ram + fbi->auxoffs) +
-            scry * fbi->rowpixels)
+        ? ((uint16_t*)(fbi->ram + fbi->auxoffs) + rowoffs)
         : NULL;
 
+    /* column addressing used by FB_PIXEL(); the identity when linear */
+    const uint32_t fb_xshift = fbi->x_tiles ? FBI_TILE_SHIFT : 0;
+    const uint32_t fb_tshift = fbi->x_tiles ? FBI_TILE_STRIDE_SHIFT : 0;
+    const int32_t fb_xmask = fbi->x_tiles ? (FBI_TILE_SIZE - 1) : 0;
+
     /* compute the starting parameters */
     const int32_t dx = startx - (fbi->ax >> 4);
     const int32_t dy = y - (fbi->ay >> 4);
@@ -1093,13 +1374,15 @@ static void prepare_tmu(tmu_state* t)
         recompute_texture_params(t);
 
         /* ensure that the NCC tables are up to date */
+        t->ncc_preconverted = false;
         if ((TEXMODE_FORMAT(t->reg[textureMode].u) & 7) == 1)
         {
-            ncc_table* n = &t->ncc[TEXMODE_NCC_TABLE_SELECT(t->reg[textureMode].u)];
+            ncc_table* n = ncc_selected_table(t);
             t->texel[1] = t->texel[9] = n->texel;
-            if (n->dirty) {
-                ncc_table_update(n);
-            }
+
+            /* sample the pre-converted copy if there is a current one */
+            const int texel_bytes = (TEXMODE_FORMAT(t->reg[textureMode].u) >> 3) + 1;
+            t->ncc_preconverted = ncc_prepare_texture(t, n, texel_bytes);
         }
     }
 
@@ -1895,14 +2178,16 @@ void voodoo_fastfill(voodoo_state *vs)
         if (FBZMODE_Y_ORIGIN(regs[fbzMode].u))
             scry = (fbi->yorigin - y) & 0x3ff;
 
-        uint16_t *dest = drawbuf + scry * fbi->rowpixels;
-        uint16_t *depth = depthbuf ? (depthbuf + scry * fbi->rowpixels) : NULL;
+        const uint32_t rowoffs = fbi_row_offset(fbi, (uint32_t)scry);
+        uint16_t *dest = drawbuf + rowoffs;
+        uint16_t *depth = depthbuf ? (depthbuf + rowoffs) : NULL;
 
         for (int32_t x = sx; x < ex; x++) {
+            const uint32_t col = fbi_column_offset(fbi, (uint32_t)x);
             if (FBZMODE_RGB_BUFFER_MASK(regs[fbzMode].u))
-                dest[x] = rgb565;
+                dest[col] = rgb565;
             if (depth && FBZMODE_AUX_BUFFER_MASK(regs[fbzMode].u))
-                depth[x] = depthval;
+                depth[col] = depthval;
         }
     }
 }
@@ -2625,9 +2910,11 @@ void voodoo_reg_write(voodoo_state *v, uint32_t offset, uint32_t data)
     case nccTable + 11:
         if ((chips & 2) != 0) {
             ncc_table_write(&v->tmu[0].ncc[0], regnum - nccTable, data);
+            v->tmu[0].regdirty = true;
         }
         if ((chips & 4) != 0) {
             ncc_table_write(&v->tmu[1].ncc[0], regnum - nccTable, data);
+            v->tmu[1].regdirty = true;
         }
         break;
 
@@ -2645,9 +2932,11 @@ void voodoo_reg_write(voodoo_state *v, uint32_t offset, uint32_t data)
     case nccTable + 23:
         if ((chips & 2) != 0) {
             ncc_table_write(&v->tmu[0].ncc[1], regnum - (nccTable + 12), data);
+            v->tmu[0].regdirty = true;
         }
         if ((chips & 4) != 0) {
             ncc_table_write(&v->tmu[1].ncc[1], regnum - (nccTable + 12), data);
+            v->tmu[1].regdirty = true;
         }
         break;
 
@@ -469,6 +469,17 @@ do                                                                          \
 }                                                                           \
 while (0)
 
+/*************************************
+ * Framebuffer addressing
+ *************************************/
+
+/* Offset of column XX within the dest/depth row pointers. Uses the
+   fb_xshift/fb_tshift/fb_xmask locals set up by the rasterizer: for the
+   tiled layout they select the tile and the column within it, for the
+   linear layout they are 0 and this reduces to XX. */
+#define FB_PIXEL(XX)                                                        \
+    ((((XX) >> fb_xshift) << fb_tshift) | ((XX) & fb_xmask))
+
 /*************************************
  * Alpha blending macro
  *************************************/
@@ -476,12 +487,12 @@ while (0)
 #define APPLY_ALPHA_BLEND(FBZMODE, ALPHAMODE, XX, DITHER, RR, GG, BB, AA)   \
 do {                                                                        \
     if (ALPHAMODE_ALPHABLEND(ALPHAMODE)) {                                  \
-        int dpix = dest[XX];                                                \
+        int dpix = dest[FB_PIXEL(XX)];                                      \
         int dr   = (dpix >> 8) & 0xf8;                                      \
         int dg   = (dpix >> 3) & 0xfc;                                      \
         int db   = (dpix << 3) & 0xf8;                                      \
         int da = (FBZMODE_ENABLE_ALPHA_PLANES(FBZMODE) && depth)            \
-                       ? depth[XX]                                          \
+                       ? depth[FB_PIXEL(XX)]                                \
                        : 0xff;                                              \
         const int sr_val = (RR);                                            \
         const int sg_val = (GG);                                            \
@@ -801,7 +812,7 @@ do                                                                          \
                 goto skipdrawdepth;                                         \
             case 1:     /* depthOP = less than */                           \
                 if (depth)                                                  \
-                    if (depthsource >= depth[XX])                           \
+                    if (depthsource >= depth[FB_PIXEL(XX)])                 \
                     {                                                       \
                         ADD_STAT_COUNT(STATS, zfunc_fail)                   \
                         goto skipdrawdepth;                                 \
@@ -809,7 +820,7 @@ do                                                                          \
                 break;                                                      \
             case 2:     /* depthOP = equal */                               \
                 if (depth)                                                  \
-                    if (depthsource != depth[XX])                           \
+                    if (depthsource != depth[FB_PIXEL(XX)])                 \
                     {                                                       \
                         ADD_STAT_COUNT(STATS, zfunc_fail)                   \
                         goto skipdrawdepth;                                 \
@@ -817,7 +828,7 @@ do                                                                          \
                 break;                                                      \
             case 3:     /* depthOP = less than or equal */                  \
                 if (depth)                                                  \
-                    if (depthsource > depth[XX])                            \
+                    if (depthsource > depth[FB_PIXEL(XX)])                  \
                     {                                                       \
                         ADD_STAT_COUNT(STATS, zfunc_fail)                   \
                         goto skipdrawdepth;                                 \
@@ -825,7 +836,7 @@ do                                                                          \
                 break;                                                      \
             case 4:     /* depthOP = greater than */                        \
                 if (depth)                                                  \
-                    if (depthsource <= depth[XX])                           \
+                    if (depthsource <= depth[FB_PIXEL(XX)])                 \
                     {                                                       \
                         ADD_STAT_COUNT(STATS, zfunc_fail)                   \
                         goto skipdrawdepth;                                 \
@@ -833,7 +844,7 @@ do                                                                          \
                 break;                                                      \
             case 5:     /* depthOP = not equal */                           \
                 if (depth)                                                  \
-                    if (depthsource == depth[XX])                           \
+                    if (depthsource == depth[FB_PIXEL(XX)])                 \
                     {                                                       \
                         ADD_STAT_COUNT(STATS, zfunc_fail)                   \
                         goto skipdrawdepth;                                 \
@@ -841,7 +852,7 @@ do                                                                          \
                 break;                                                      \
             case 6:     /* depthOP = greater than or equal */               \
                 if (depth)                                                  \
-                    if (depthsource < depth[XX])                            \
+                    if (depthsource < depth[FB_PIXEL(XX)])                  \
                     {                                                       \
                         ADD_STAT_COUNT(STATS, zfunc_fail)                   \
                         goto skipdrawdepth;                                 \
@@ -868,15 +879,15 @@ do                                                                          \
     {                                                                       \
         /* apply dithering */                                               \
         APPLY_DITHER(FBZMODE, XX, DITHER_LOOKUP, r, g, b);                  \
-        (dest)[XX] = (uint16_t)((r << 11) | (g << 5) | b);                  \
+        (dest)[FB_PIXEL(XX)] = (uint16_t)((r << 11) | (g << 5) | b);        \
     }                                                                       \
     /* write to aux buffer */                                               \
     if ((depth) && FBZMODE_AUX_BUFFER_MASK(FBZMODE))                        \
     {                                                                       \
         if (FBZMODE_ENABLE_ALPHA_PLANES(FBZMODE) == 0)                      \
-            (depth)[XX] = (uint16_t)depthval;                               \
+            (depth)[FB_PIXEL(XX)] = (uint16_t)depthval;                     \
         else                                                                \
-            (depth)[XX] = (uint16_t)a;                                      \
+            (depth)[FB_PIXEL(XX)] = (uint16_t)a;                            \
     }
 
 #define PIXEL_PIPELINE_END(STATS)                                           \
@@ -895,16 +906,16 @@ while (0)
  * Helper macro: Check if texture format uses pre-converted ARGB32 data
  *
  * Formats that CANNOT be pre-converted (need runtime lookup):
- *   1: YIQ_422 (NCC table)
  *   6: P_8 with alpha (palettea) - rarely used
- *   9: AYIQ_8422 (NCC with alpha)
  *   14: AP_88 (alpha + palette)
  *
  * P_8 (format 5) IS pre-converted and reconverted on palette change.
+ * YIQ_422 (1) and AYIQ_8422 (9) are pre-converted per NCC table; whether
+ * the current texture's copy is usable is decided in prepare_tmu().
  * All other formats (0, 2, 3, 4, 5, 8, 10, 11, 12, 13) are pre-converted.
  */
-#define TEXMODE_USE_PRECONVERTED(fmt) \
-    ((fmt) != 1 && (fmt) != 6 && (fmt) != 9 && (fmt) != 14)
+#define TEXMODE_USE_PRECONVERTED(TT, fmt) \
+    (((fmt) != 1 && (fmt) != 6 && (fmt) != 9 && (fmt) != 14) || (TT)->ncc_preconverted)
 
 #define TEXTURE_PIPELINE(TT, XX, DITHER4, TEXMODE, COTHER, LOOKUP, LODBASE, ITERS, ITERT, ITERW, RESULT) \
 do																				\
@@ -983,7 +994,7 @@ do																				\
 		if (TEXMODE_FORMAT(TEXMODE) < 8)										\
 		{																		\
 			uint32_t addr = (texbase + t + s) & (TT)->mask;						\
-			if (TEXMODE_USE_PRECONVERTED(TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) \
+			if (TEXMODE_USE_PRECONVERTED(TT, TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) \
 				c_local.u = (TT)->argb32_ram[addr];								\
 			else {																\
 				texel0 = (TT)->ram[addr];										\
@@ -993,7 +1004,7 @@ do																				\
 		else																	\
 		{																		\
 			uint32_t addr = (texbase + 2*(t + s)) & (TT)->mask;					\
-			if (TEXMODE_USE_PRECONVERTED(TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) \
+			if (TEXMODE_USE_PRECONVERTED(TT, TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) \
 				c_local.u = (TT)->argb32_ram[addr];								\
 			else {																\
 				texel0 = *(uint16_t *)&(TT)->ram[addr];							\
@@ -1057,7 +1068,7 @@ do																				\
 			uint32_t addr1 = (texbase + t + s1) & (TT)->mask;					\
 			uint32_t addr2 = (texbase + t1 + s) & (TT)->mask;					\
 			uint32_t addr3 = (texbase + t1 + s1) & (TT)->mask;					\
-			if (TEXMODE_USE_PRECONVERTED(TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) { \
+			if (TEXMODE_USE_PRECONVERTED(TT, TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) { \
 				texel0 = (TT)->argb32_ram[addr0];								\
 				texel1 = (TT)->argb32_ram[addr1];								\
 				texel2 = (TT)->argb32_ram[addr2];								\
@@ -1075,7 +1086,7 @@ do																				\
 			uint32_t addr1 = (texbase + 2*(t + s1)) & (TT)->mask;				\
 			uint32_t addr2 = (texbase + 2*(t1 + s)) & (TT)->mask;				\
 			uint32_t addr3 = (texbase + 2*(t1 + s1)) & (TT)->mask;				\
-			if (TEXMODE_USE_PRECONVERTED(TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) { \
+			if (TEXMODE_USE_PRECONVERTED(TT, TEXMODE_FORMAT(TEXMODE)) && (TT)->argb32_ram) { \
 				texel0 = (TT)->argb32_ram[addr0];								\
 				texel1 = (TT)->argb32_ram[addr1];								\
 				texel2 = (TT)->argb32_ram[addr2];								\
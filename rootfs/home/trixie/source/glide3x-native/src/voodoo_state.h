@@ -80,6 +80,25 @@ typedef struct {
     uint32_t    num_texels;       /* number of texels */
 } p8_region;
 
+/*************************************
+ * NCC texture region tracking
+ *
+ * YIQ_422 / AYIQ_8422 texels depend on an NCC table, so each region
+ * pre-converted into argb32_ram remembers the contents of the table it
+ * was converted with. Textures that each come with their own table then
+ * stay converted while the game switches tables between them; a region
+ * is only reconverted when it is drawn with different table contents.
+ *************************************/
+
+#define MAX_NCC_REGIONS 256
+
+typedef struct {
+    uint32_t    start_addr;       /* byte address in TMU RAM */
+    uint32_t    size;             /* size in bytes */
+    uint8_t     texel_bytes;      /* 1 = YIQ_422, 2 = AYIQ_8422 */
+    uint64_t    table_key;        /* ncc_table_key() of the table used */
+} ncc_region;
+
 /*************************************
  * TMU (Texture Mapping Unit) state
  *************************************/
@@ -133,6 +152,11 @@ typedef struct {
     /* P_8 texture region tracking for palette reconversion */
     p8_region   p8_regions[MAX_P8_REGIONS];
     int         p8_region_count;
+
+    /* NCC texture regions pre-converted to argb32_ram */
+    ncc_region  ncc_regions[MAX_NCC_REGIONS];
+    int         ncc_region_count;
+    bool        ncc_preconverted; /* current NCC texture is in argb32_ram */
 } tmu_state;
 
 /*************************************
@@ -173,6 +197,29 @@ typedef struct {
  * FBI (Frame Buffer Interface) state
  *************************************/
 
+/*
+ * Tiled framebuffer layout (GLIDE3X_TILED_FB=1)
+ *
+ * Instead of separate linear arrays, the three color buffers and the aux
+ * buffer are interleaved in 8x8 pixel tiles:
+ *
+ *   tile n: [color 0: 64 px][color 1: 64 px][color 2: 64 px][aux: 64 px]
+ *
+ * so rgboffs[i] = i * 128 bytes and auxoffs = 384 bytes, and the color and
+ * depth of a pixel share one 512-byte block instead of living megabytes
+ * apart. Within a plane pixels are stored row by row (8 per row).
+ *
+ * The rasterizer addresses the tiles directly through fbi_row_offset()
+ * and FB_PIXEL(); everything that hands pixels to the outside world
+ * (display, LFB locks and regions) goes through voodoo_fbi_read_rect() /
+ * voodoo_fbi_write_rect(), which convert to and from linear rows.
+ */
+#define FBI_TILE_SHIFT          3
+#define FBI_TILE_SIZE           (1 << FBI_TILE_SHIFT)
+#define FBI_TILE_PLANE_PIXELS   (FBI_TILE_SIZE * FBI_TILE_SIZE)
+#define FBI_TILE_STRIDE_SHIFT   8   /* 4 planes of 64 pixels per tile */
+#define FBI_TILE_STRIDE         (1 << FBI_TILE_STRIDE_SHIFT)
+
 typedef struct {
     uint8_t    *ram;              /* frame buffer RAM */
     uint32_t    mask;             /* address mask */
@@ -186,10 +233,10 @@ typedef struct {
 
     uint32_t    width;            /* frame buffer width */
     uint32_t    height;           /* frame buffer height */
-    uint32_t    rowpixels;        /* pixels per row */
-    uint32_t    tile_width;
+    uint32_t    rowpixels;        /* pixels per row (linear layout) */
+    uint32_t    tile_width;       /* FBI_TILE_SIZE if tiled, else 0 */
     uint32_t    tile_height;
-    uint32_t    x_tiles;
+    uint32_t    x_tiles;          /* tiles per row if tiled, else 0 */
 
     uint8_t     vblank;
     bool        vblank_dont_swap;
@@ -370,6 +417,26 @@ static inline int32_t clamp_to_uint8(int32_t val)
     return val;
 }
 
+/* Offset in pixels of column 0 of row y, relative to a buffer's base */
+static inline uint32_t fbi_row_offset(const fbi_state *f, uint32_t y)
+{
+    if (f->x_tiles) {
+        return (y >> FBI_TILE_SHIFT) * f->x_tiles * FBI_TILE_STRIDE +
+               ((y & (FBI_TILE_SIZE - 1)) << FBI_TILE_SHIFT);
+    }
+    return y * f->rowpixels;
+}
+
+/* Offset in pixels of column x, relative to fbi_row_offset() */
+static inline uint32_t fbi_column_offset(const fbi_state *f, uint32_t x)
+{
+    if (f->x_tiles) {
+        return ((x >> FBI_TILE_SHIFT) << FBI_TILE_STRIDE_SHIFT) |
+               (x & (FBI_TILE_SIZE - 1));
+    }
+    return x;
+}
+
 
 
 /*************************************
@@ -380,6 +447,7 @@ static inline int32_t clamp_to_uint8(int32_t val)
 voodoo_state* voodoo_create(void);
 void voodoo_destroy(voodoo_state *v);
 void voodoo_init_fbi(fbi_state *f, int fbmem);
+void voodoo_fbi_set_layout(fbi_state *f, int width, int height);
 void voodoo_init_tmu(voodoo_state *vs, tmu_state *t, voodoo_reg *reg, int tmem);
 void voodoo_init_tmu_shared(tmu_shared_state *s);
 
@@ -397,6 +465,18 @@ void voodoo_reg_write(voodoo_state *v, uint32_t offset, uint32_t data);
 uint32_t voodoo_lfb_read(voodoo_state *v, uint32_t offset);
 void voodoo_lfb_write(voodoo_state *v, uint32_t offset, uint32_t data, uint32_t mem_mask);
 
+/* Framebuffer conversion to/from linear RGB565 or depth rows
+   (strides in pixels; bufoffs is one of rgboffs[] or auxoffs) */
+void voodoo_fbi_read_rect(const fbi_state *f, uint32_t bufoffs, int x, int y,
+                          int width, int height, uint16_t *dst, int dst_stride);
+void voodoo_fbi_write_rect(fbi_state *f, uint32_t bufoffs, int x, int y,
+                           int width, int height, const uint16_t *src, int src_stride);
+
+/* NCC tables and pre-converted NCC textures */
+void voodoo_ncc_table_load(tmu_state *t, int which, const uint32_t packed[12]);
+void voodoo_ncc_preconvert(tmu_state *t, uint32_t addr, uint32_t size, int texel_bytes);
+void voodoo_ncc_untrack(tmu_state *t, uint32_t addr, uint32_t size);
+
 /* Texture */
 void voodoo_tex_write(voodoo_state *v, int tmu, uint32_t offset, uint32_t data);
 
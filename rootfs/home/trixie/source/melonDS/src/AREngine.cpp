@@ -16,6 +16,7 @@
     with melonDS. If not, see http://www.gnu.org/licenses/.
 */
 
+#include <algorithm>
 #include <stdio.h>
 #include <string.h>
 #include "NDS.h"
@@ -39,194 +40,427 @@ AREngine::AREngine(melonDS::NDS& nds) : NDS(nds)
     case ((x)+0x08): case ((x)+0x09): case ((x)+0x0A): case ((x)+0x0B): \
     case ((x)+0x0C): case ((x)+0x0D): case ((x)+0x0E): case ((x)+0x0F)
 
-void AREngine::RunCheat(const ARCode& arcode)
+void AREngine::SetCheats(const std::vector<ARCode>& cheats)
 {
-    const u32* code = &arcode.Code[0];
+    ClearCheats();
 
-    u32 offset = 0;
-    u32 datareg = 0;
-    u32 cond = 1;
-    u32 condstack = 0;
+    for (const ARCode& code : cheats)
+    {
+        if (code.Enabled)
+            Compile(code);
+    }
 
-    const u32* loopstart = code;
-    u32 loopcount = 0;
-    u32 loopcond = 1;
-    u32 loopcondstack = 0;
+    Link();
+}
 
-    // TODO: does anything reset this??
-    u32 c5count = 0;
+void AREngine::ClearCheats()
+{
+    Ops.clear();
+    Data.clear();
+    Programs.clear();
+}
+
+void AREngine::Compile(const ARCode& arcode)
+{
+    const std::vector<u32>& code = arcode.Code;
+
+    ARProgram program;
+    program.Start = Ops.size();
 
-    for (;;)
+    // What is known about the offset register at this point. Addresses
+    // relative to a known offset are made absolute, so Link() can resolve
+    // them. Loops only ever jump back to the opcode after a FOR, and once
+    // a condition is in play skippable opcodes may or may not run.
+    bool offsetknown = true;
+    u32 knownoffset = 0;
+    bool condtrue = true;
+
+    size_t pos = 0;
+    while (pos + 1 < code.size())
     {
-        if (code > &arcode.Code[arcode.Code.size() - 1])
-            // If the instruction pointer is past the end of the cheat code...
-            break;
+        u32 a = code[pos++];
+        u32 b = code[pos++];
 
-        u32 a = *code++;
-        u32 b = *code++;
+        u8 opcode = a >> 24;
 
-        u8 op = a >> 24;
+        AROp op {};
+        op.Skippable = (opcode < 0xD0 && opcode != 0xC5) || opcode > 0xD2;
+        op.Value = b;
 
-        if ((op < 0xD0 && op != 0xC5) || op > 0xD2)
+        auto relative = [&](u32 addr)
         {
-            if (!cond)
-            {
-                if ((op & 0xF0) == 0xE0)
-                {
-                    for (u32 i = 0; i < b; i += 8)
-                        code += 2;
-                }
-
-                continue;
-            }
-        }
+            op.Absolute = offsetknown;
+            op.Addr = offsetknown ? (addr + knownoffset) : addr;
+        };
+        auto absolute = [&](u32 addr)
+        {
+            op.Absolute = true;
+            op.Addr = addr;
+        };
+        auto setoffset = [&](bool known, u32 val)
+        {
+            offsetknown = known && condtrue;
+            knownoffset = val;
+        };
 
-        switch (op)
+        switch (opcode)
         {
         case16(0x00): // 32-bit write
-            NDS.ARM7Write32((a & 0x0FFFFFFF) + offset, b);
+            op.Type = AROpType::Write32;
+            relative(a & 0x0FFFFFFF);
             break;
 
         case16(0x10): // 16-bit write
-            NDS.ARM7Write16((a & 0x0FFFFFFF) + offset, b & 0xFFFF);
+            op.Type = AROpType::Write16;
+            op.Value = b & 0xFFFF;
+            relative(a & 0x0FFFFFFF);
             break;
 
         case16(0x20): // 8-bit write
-            NDS.ARM7Write8((a & 0x0FFFFFFF) + offset, b & 0xFF);
+            op.Type = AROpType::Write8;
+            op.Value = b & 0xFF;
+            relative(a & 0x0FFFFFFF);
             break;
 
         case16(0x30): // IF b > u32[a]
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case16(0x40): // IF b < u32[a]
+        case16(0x50): // IF b == u32[a]
+        case16(0x60): // IF b != u32[a]
+            op.Type = AROpType::If32;
+            op.Arg = Compare_GT + ((opcode >> 4) - 0x3);
+            if (a & 0x0FFFFFFF) absolute(a & 0x0FFFFFFF);
+            else                relative(0);
+            condtrue = false;
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u32 chk = NDS.ARM7Read32(addr);
+        case16(0x70): // IF b.l > ((~b.h) & u16[a])
+        case16(0x80): // IF b.l < ((~b.h) & u16[a])
+        case16(0x90): // IF b.l == ((~b.h) & u16[a])
+        case16(0xA0): // IF b.l != ((~b.h) & u16[a])
+            op.Type = AROpType::If16;
+            op.Arg = Compare_GT + ((opcode >> 4) - 0x7);
+            op.Value = b & 0xFFFF;
+            op.Extra = ~(b >> 16) & 0xFFFF;
+            if (a & 0x0FFFFFFF) absolute(a & 0x0FFFFFFF);
+            else                relative(0);
+            condtrue = false;
+            break;
 
-                cond = (b > chk) ? 1:0;
-            }
+        case16(0xB0): // offset = u32[a + offset]
+            op.Type = AROpType::LoadOffset;
+            relative(a & 0x0FFFFFFF);
+            setoffset(false, 0);
             break;
 
-        case16(0x40): // IF b < u32[a]
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case 0xC0: // FOR 0..b
+            op.Type = AROpType::For;
+            offsetknown = false;
+            condtrue = false;
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u32 chk = NDS.ARM7Read32(addr);
+        case 0xC4: // offset = pointer to C4000000 opcode
+            op.Type = AROpType::Stop;
+            op.Arg = 1;
+            break;
 
-                cond = (b < chk) ? 1:0;
-            }
+        case 0xC5: // count++ / IF (count & b.l) == b.h
+            op.Type = AROpType::Counter;
+            condtrue = false;
             break;
 
-        case16(0x50): // IF b == u32[a]
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case 0xC6: // u32[b] = offset
+            op.Type = AROpType::StoreOffset;
+            absolute(b);
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u32 chk = NDS.ARM7Read32(addr);
+        case 0xD0: // ENDIF
+            op.Type = AROpType::EndIf;
+            condtrue = false;
+            break;
 
-                cond = (b == chk) ? 1:0;
-            }
+        case 0xD1: // NEXT
+            op.Type = AROpType::Next;
+            offsetknown = false;
+            condtrue = false;
             break;
 
-        case16(0x60): // IF b != u32[a]
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case 0xD2: // NEXT+FLUSH
+            // the code after this only runs once the loop is done, and
+            // then always with everything flushed
+            op.Type = AROpType::NextFlush;
+            offsetknown = true;
+            knownoffset = 0;
+            condtrue = true;
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u32 chk = NDS.ARM7Read32(addr);
+        case 0xD3: // offset = b
+            op.Type = AROpType::SetOffset;
+            setoffset(true, b);
+            break;
 
-                cond = (b != chk) ? 1:0;
-            }
+        case 0xD4: // data op
+            op.Type = AROpType::DataOp;
+            op.Arg = a & 0xFF;
+            op.Addr = a;
             break;
 
-        case16(0x70): // IF b.l > ((~b.h) & u16[a])
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case 0xD5: // datareg = b
+            op.Type = AROpType::SetData;
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u16 val = NDS.ARM7Read16(addr);
-                u16 chk = ~(b >> 16);
-                chk &= val;
+        case 0xD6: // u32[b+offset] = datareg / offset += 4
+            op.Type = AROpType::StoreData32;
+            relative(b);
+            setoffset(offsetknown, knownoffset + 4);
+            break;
 
-                cond = ((b & 0xFFFF) > chk) ? 1:0;
-            }
+        case 0xD7: // u16[b+offset] = datareg / offset += 2
+            op.Type = AROpType::StoreData16;
+            relative(b);
+            setoffset(offsetknown, knownoffset + 2);
             break;
 
-        case16(0x80): // IF b.l < ((~b.h) & u16[a])
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case 0xD8: // u8[b+offset] = datareg / offset += 1
+            op.Type = AROpType::StoreData8;
+            relative(b);
+            setoffset(offsetknown, knownoffset + 1);
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u16 val = NDS.ARM7Read16(addr);
-                u16 chk = ~(b >> 16);
-                chk &= val;
+        case 0xD9: // datareg = u32[b+offset]
+            op.Type = AROpType::LoadData32;
+            relative(b);
+            break;
 
-                cond = ((b & 0xFFFF) < chk) ? 1:0;
-            }
+        case 0xDA: // datareg = u16[b+offset]
+            op.Type = AROpType::LoadData16;
+            relative(b);
             break;
 
-        case16(0x90): // IF b.l == ((~b.h) & u16[a])
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case 0xDB: // datareg = u8[b+offset]
+            op.Type = AROpType::LoadData8;
+            relative(b);
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u16 val = NDS.ARM7Read16(addr);
-                u16 chk = ~(b >> 16);
-                chk &= val;
+        case 0xDC: // offset += b
+            op.Type = AROpType::AddOffset;
+            setoffset(offsetknown, knownoffset + b);
+            break;
 
-                cond = ((b & 0xFFFF) == chk) ? 1:0;
+        case16(0xE0): // copy b param bytes to address a+offset
+            {
+                // the parameter bytes follow the opcode, padded to 8 bytes
+                op.Type = AROpType::CopyData;
+                relative(a & 0x0FFFFFFF);
+                op.Extra = Data.size();
+
+                // a malformed code can't copy more than what follows it
+                size_t numbytes = std::min<size_t>(b, (code.size() - pos) * 4);
+                op.Value = (u32)numbytes;
+
+                size_t numwords = (numbytes + 7) / 8 * 2;
+                for (size_t i = 0; i < numwords; i++)
+                    Data.push_back((pos < code.size()) ? code[pos++] : 0);
             }
             break;
 
-        case16(0xA0): // IF b.l != ((~b.h) & u16[a])
-            {
-                condstack <<= 1;
-                condstack |= cond;
+        case16(0xF0): // copy b bytes from address offset to address a
+            op.Type = AROpType::CopyMemory;
+            absolute(a & 0x0FFFFFFF);
+            break;
 
-                u32 addr = a & 0x0FFFFFFF;
-                if (!addr) addr = offset;
-                u16 val = NDS.ARM7Read16(addr);
-                u16 chk = ~(b >> 16);
-                chk &= val;
+        default:
+            op.Type = AROpType::Stop;
+            op.Arg = 0;
+            op.Addr = a;
+            break;
+        }
 
-                cond = ((b & 0xFFFF) != chk) ? 1:0;
-            }
+        Ops.push_back(op);
+    }
+
+    program.End = Ops.size();
+    if (program.End > program.Start)
+        Programs.push_back(program);
+}
+
+void AREngine::Link()
+{
+    LinkedMainRAM = NDS.MainRAM;
+    LinkedMainRAMMask = NDS.MainRAMMask;
+
+    for (AROp& op : Ops)
+    {
+        u32 size;
+        switch (op.Type)
+        {
+        case AROpType::Write32:
+        case AROpType::If32:
+        case AROpType::LoadOffset:
+        case AROpType::StoreOffset:
+        case AROpType::StoreData32:
+        case AROpType::LoadData32:
+            size = 4;
             break;
 
-        case16(0xB0): // offset = u32[a + offset]
-            offset = NDS.ARM7Read32((a & 0x0FFFFFFF) + offset);
+        case AROpType::Write16:
+        case AROpType::If16:
+        case AROpType::StoreData16:
+        case AROpType::LoadData16:
+            size = 2;
             break;
 
-        case 0xC0: // FOR 0..b
-            loopstart = code; // points to the first opcode after the FOR
-            loopcount = b;
+        case AROpType::Write8:
+        case AROpType::StoreData8:
+        case AROpType::LoadData8:
+            size = 1;
+            break;
+
+        default:
+            size = 0;
+            break;
+        }
+
+        op.Ptr = nullptr;
+        if (size && op.Absolute && (op.Addr & 0xFF000000) == 0x02000000)
+            op.Ptr = &NDS.MainRAM[(op.Addr & ~(size - 1)) & NDS.MainRAMMask];
+    }
+}
+
+// Main RAM is mapped the same way for the ARM7 on DS and DSi, so it's
+// accessed directly; everything else goes through the bus handlers
+template <typename T>
+T AREngine::Read(u32 addr)
+{
+    if ((addr & 0xFF000000) == 0x02000000)
+        return *(T*)&NDS.MainRAM[(addr & ~(sizeof(T) - 1)) & NDS.MainRAMMask];
+
+    if constexpr (sizeof(T) == 4)      return NDS.ARM7Read32(addr);
+    else if constexpr (sizeof(T) == 2) return NDS.ARM7Read16(addr);
+    else                               return NDS.ARM7Read8(addr);
+}
+
+template <typename T>
+void AREngine::Write(u32 addr, T val)
+{
+    if ((addr & 0xFF000000) == 0x02000000)
+    {
+        addr &= ~(sizeof(T) - 1);
+        NDS.JIT.CheckAndInvalidate<1, ARMJIT_Memory::memregion_MainRAM>(addr);
+        *(T*)&NDS.MainRAM[addr & NDS.MainRAMMask] = val;
+        return;
+    }
+
+    if constexpr (sizeof(T) == 4)      NDS.ARM7Write32(addr, val);
+    else if constexpr (sizeof(T) == 2) NDS.ARM7Write16(addr, val);
+    else                               NDS.ARM7Write8(addr, val);
+}
+
+template <typename T>
+T AREngine::ReadOp(const AROp& op, u32 offset)
+{
+    if (op.Ptr)
+        return *(T*)op.Ptr;
+
+    return Read<T>(op.Absolute ? op.Addr : (op.Addr + offset));
+}
+
+template <typename T>
+void AREngine::WriteOp(const AROp& op, u32 offset, T val)
+{
+    if (op.Ptr)
+    {
+        NDS.JIT.CheckAndInvalidate<1, ARMJIT_Memory::memregion_MainRAM>(op.Addr & ~(sizeof(T) - 1));
+        *(T*)op.Ptr = val;
+        return;
+    }
+
+    Write<T>(op.Absolute ? op.Addr : (op.Addr + offset), val);
+}
+
+static bool CompareARValues(u8 cmp, u32 val, u32 chk)
+{
+    switch (cmp)
+    {
+    case AREngine::Compare_GT: return val > chk;
+    case AREngine::Compare_LT: return val < chk;
+    case AREngine::Compare_EQ: return val == chk;
+    default:                   return val != chk;
+    }
+}
+
+void AREngine::RunProgram(const ARProgram& program)
+{
+    u32 offset = 0;
+    u32 datareg = 0;
+    u32 cond = 1;
+    u32 condstack = 0;
+
+    u32 loopstart = program.Start;
+    u32 loopcount = 0;
+    u32 loopcond = 1;
+    u32 loopcondstack = 0;
+
+    // TODO: does anything reset this??
+    u32 c5count = 0;
+
+    for (u32 pc = program.Start; pc < program.End;)
+    {
+        const AROp& op = Ops[pc++];
+
+        if (!cond && op.Skippable)
+            continue;
+
+        switch (op.Type)
+        {
+        case AROpType::Write32:
+            WriteOp<u32>(op, offset, op.Value);
+            break;
+
+        case AROpType::Write16:
+            WriteOp<u16>(op, offset, op.Value);
+            break;
+
+        case AROpType::Write8:
+            WriteOp<u8>(op, offset, op.Value);
+            break;
+
+        case AROpType::If32:
+            condstack <<= 1;
+            condstack |= cond;
+            cond = CompareARValues(op.Arg, op.Value, ReadOp<u32>(op, offset)) ? 1:0;
+            break;
+
+        case AROpType::If16:
+            condstack <<= 1;
+            condstack |= cond;
+            cond = CompareARValues(op.Arg, op.Value, ReadOp<u16>(op, offset) & op.Extra) ? 1:0;
+            break;
+
+        case AROpType::LoadOffset:
+            offset = ReadOp<u32>(op, offset);
+            break;
+
+        case AROpType::For:
+            loopstart = pc; // points to the first opcode after the FOR
+            loopcount = op.Value;
             loopcond = cond;           // checkme
             loopcondstack = condstack; // (GBAtek is not very clear there)
             break;
 
-        case 0xC4: // offset = pointer to C4000000 opcode
-            // theoretically used for safe storage, by accessing [offset+4]
-            // in practice could be used for a self-modifying AR code
-            // could be implemented with some hackery, but, does anything even
-            // use it??
-            Log(LogLevel::Error, "AR: !! THE FUCKING C4000000 OPCODE. TELL ARISOTURA.\n");
+        case AROpType::Stop:
+            if (op.Arg)
+            {
+                // theoretically used for safe storage, by accessing [offset+4]
+                // in practice could be used for a self-modifying AR code
+                // could be implemented with some hackery, but, does anything even
+                // use it??
+                Log(LogLevel::Error, "AR: !! THE FUCKING C4000000 OPCODE. TELL ARISOTURA.\n");
+            }
+            else
+                Log(LogLevel::Warn, "!! bad AR opcode %08X %08X\n", op.Addr, op.Value);
             return;
 
-        case 0xC5: // count++ / IF (count & b.l) == b.h
+        case AROpType::Counter:
             {
                 // with weird condition checking, apparently
                 // oh well
@@ -237,27 +471,27 @@ void AREngine::RunCheat(const ARCode& arcode)
                 condstack <<= 1;
                 condstack |= cond;
 
-                u16 mask = b & 0xFFFF;
-                u16 chk = b >> 16;
+                u16 mask = op.Value & 0xFFFF;
+                u16 chk = op.Value >> 16;
 
                 cond = ((c5count & mask) == chk) ? 1:0;
             }
             break;
 
-        case 0xC6: // u32[b] = offset
-            NDS.ARM7Write32(b, offset);
+        case AROpType::StoreOffset:
+            WriteOp<u32>(op, offset, offset);
             break;
 
-        case 0xD0: // ENDIF
+        case AROpType::EndIf:
             cond = condstack & 0x1;
             condstack >>= 1;
             break;
 
-        case 0xD1: // NEXT
+        case AROpType::Next:
             if (loopcount > 0)
             {
                 loopcount--;
-                code = loopstart;
+                pc = loopstart;
             }
             else
             {
@@ -266,11 +500,11 @@ void AREngine::RunCheat(const ARCode& arcode)
             }
             break;
 
-        case 0xD2: // NEXT+FLUSH
+        case AROpType::NextFlush:
             if (loopcount > 0)
             {
                 loopcount--;
-                code = loopstart;
+                pc = loopstart;
             }
             else
             {
@@ -281,150 +515,151 @@ void AREngine::RunCheat(const ARCode& arcode)
             }
             break;
 
-        case 0xD3: // offset = b
-            offset = b;
+        case AROpType::SetOffset:
+            offset = op.Value;
             break;
 
-        case 0xD4: // data op
-            switch (a & 0xFF)
+        case AROpType::AddOffset:
+            offset += op.Value;
+            break;
+
+        case AROpType::DataOp:
             {
-                case 0x00: datareg += b; break;
-                case 0x01: datareg |= b; break;
-                case 0x02: datareg &= b; break;
-                case 0x03: datareg ^= b; break;
-
-                case 0x04:
-                    b &= 0xFF;
-                    if (b > 31) datareg = 0;
-                    else        datareg <<= b;
-                    break;
-                case 0x05:
-                    b &= 0xFF;
-                    if (b > 31) datareg = 0;
-                    else        datareg >>= b;
-                    break;
-                case 0x06:
-                    datareg = ROR(datareg, b & 0x1F);
-                    break;
-                case 0x07:
-                    b &= 0xFF;
-                    if (b > 31) datareg = ((s32)datareg) >> 31;
-                    else        datareg = ((s32)datareg) >> b;
-                    break;
-
-                case 0x08: datareg *= b; break;
-
-                default:
-                    Log(LogLevel::Warn, "!! bad AR D4 opcode %08X %08X\n", a, b);
-                    break;
+                u32 b = op.Value;
+                switch (op.Arg)
+                {
+                    case 0x00: datareg += b; break;
+                    case 0x01: datareg |= b; break;
+                    case 0x02: datareg &= b; break;
+                    case 0x03: datareg ^= b; break;
+
+                    case 0x04:
+                        b &= 0xFF;
+                        if (b > 31) datareg = 0;
+                        else        datareg <<= b;
+                        break;
+                    case 0x05:
+                        b &= 0xFF;
+                        if (b > 31) datareg = 0;
+                        else        datareg >>= b;
+                        break;
+                    case 0x06:
+                        datareg = ROR(datareg, b & 0x1F);
+                        break;
+                    case 0x07:
+                        b &= 0xFF;
+                        if (b > 31) datareg = ((s32)datareg) >> 31;
+                        else        datareg = ((s32)datareg) >> b;
+                        break;
+
+                    case 0x08: datareg *= b; break;
+
+                    default:
+                        Log(LogLevel::Warn, "!! bad AR D4 opcode %08X %08X\n", op.Addr, b);
+                        break;
+                }
             }
             break;
 
-        case 0xD5: // datareg = b
-            datareg = b;
+        case AROpType::SetData:
+            datareg = op.Value;
             break;
 
-        case 0xD6: // u32[b+offset] = datareg / offset += 4
-            NDS.ARM7Write32(b + offset, datareg);
+        case AROpType::StoreData32:
+            WriteOp<u32>(op, offset, datareg);
             offset += 4;
             break;
 
-        case 0xD7: // u16[b+offset] = datareg / offset += 2
-            NDS.ARM7Write16(b + offset, datareg & 0xFFFF);
+        case AROpType::StoreData16:
+            WriteOp<u16>(op, offset, datareg & 0xFFFF);
             offset += 2;
             break;
 
-        case 0xD8: // u8[b+offset] = datareg / offset += 1
-            NDS.ARM7Write8(b + offset, datareg & 0xFF);
+        case AROpType::StoreData8:
+            WriteOp<u8>(op, offset, datareg & 0xFF);
             offset += 1;
             break;
 
-        case 0xD9: // datareg = u32[b+offset]
-            datareg = NDS.ARM7Read32(b + offset);
+        case AROpType::LoadData32:
+            datareg = ReadOp<u32>(op, offset);
             break;
 
-        case 0xDA: // datareg = u16[b+offset]
-            datareg = NDS.ARM7Read16(b + offset);
+        case AROpType::LoadData16:
+            datareg = ReadOp<u16>(op, offset);
             break;
 
-        case 0xDB: // datareg = u8[b+offset]
-            datareg = NDS.ARM7Read8(b + offset);
-            break;
-
-        case 0xDC: // offset += b
-            offset += b;
+        case AROpType::LoadData8:
+            datareg = ReadOp<u8>(op, offset);
             break;
 
-        case16(0xE0): // copy b param bytes to address a+offset
+        case AROpType::CopyData:
             {
                 // TODO: check for bad alignment of dstaddr
 
-                u32 dstaddr = (a & 0x0FFFFFFF) + offset;
-                u32 bytesleft = b;
+                // Data is empty if no code copies any bytes
+                const u32* data = Data.data() + op.Extra;
+                u32 dstaddr = op.Absolute ? op.Addr : (op.Addr + offset);
+                u32 bytesleft = op.Value;
                 while (bytesleft >= 8)
                 {
-                    NDS.ARM7Write32(dstaddr, *code++); dstaddr += 4;
-                    NDS.ARM7Write32(dstaddr, *code++); dstaddr += 4;
+                    Write<u32>(dstaddr, *data++); dstaddr += 4;
+                    Write<u32>(dstaddr, *data++); dstaddr += 4;
                     bytesleft -= 8;
                 }
                 if (bytesleft > 0)
                 {
-                    u8* leftover = (u8*)code;
-                    code += 2;
+                    const u8* leftover = (const u8*)data;
                     if (bytesleft >= 4)
                     {
-                        NDS.ARM7Write32(dstaddr, *(u32*)leftover); dstaddr += 4;
+                        Write<u32>(dstaddr, *(const u32*)leftover); dstaddr += 4;
                         leftover += 4;
                         bytesleft -= 4;
                     }
                     while (bytesleft > 0)
                     {
-                        NDS.ARM7Write8(dstaddr, *leftover++); dstaddr++;
+                        Write<u8>(dstaddr, *leftover++); dstaddr++;
                         bytesleft--;
                     }
                 }
             }
             break;
 
-        case16(0xF0): // copy b bytes from address offset to address a
+        case AROpType::CopyMemory:
             {
                 // TODO: check for bad alignment of srcaddr/dstaddr
 
                 u32 srcaddr = offset;
-                u32 dstaddr = (a & 0x0FFFFFFF);
-                u32 bytesleft = b;
+                u32 dstaddr = op.Addr;
+                u32 bytesleft = op.Value;
                 while (bytesleft >= 4)
                 {
-                    NDS.ARM7Write32(dstaddr, NDS.ARM7Read32(srcaddr));
+                    Write<u32>(dstaddr, Read<u32>(srcaddr));
                     srcaddr += 4;
                     dstaddr += 4;
                     bytesleft -= 4;
                 }
                 while (bytesleft > 0)
                 {
-                    NDS.ARM7Write8(dstaddr, NDS.ARM7Read8(srcaddr));
+                    Write<u8>(dstaddr, Read<u8>(srcaddr));
                     srcaddr++;
                     dstaddr++;
                     bytesleft--;
                 }
             }
             break;
-
-        default:
-            Log(LogLevel::Warn, "!! bad AR opcode %08X %08X\n", a, b);
-            return;
         }
     }
 }
 
 void AREngine::RunCheats()
 {
-    if (Cheats.empty()) return;
+    if (Programs.empty()) return;
 
-    for (const ARCode& code : Cheats)
-    {
-        if (code.Enabled)
-            RunCheat(code);
-    }
+    // the main RAM size depends on the console type and DSi RAM setting
+    if (NDS.MainRAM != LinkedMainRAM || NDS.MainRAMMask != LinkedMainRAMMask)
+        Link();
+
+    for (const ARProgram& program : Programs)
+        RunProgram(program);
 }
 }
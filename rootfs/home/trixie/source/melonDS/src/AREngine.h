@@ -30,11 +30,72 @@ class AREngine
 public:
     AREngine(melonDS::NDS& nds);
 
-    std::vector<ARCode> Cheats {};
+    // Replaces the cheat list. The enabled codes are compiled right away,
+    // so this has to be called again whenever a code is enabled or edited.
+    void SetCheats(const std::vector<ARCode>& cheats);
+    void ClearCheats();
+
+    // IF opcode comparisons, in opcode order
+    enum ARCompare : u8
+    {
+        Compare_GT, Compare_LT, Compare_EQ, Compare_NE,
+    };
 private:
     friend class ARM;
     void RunCheats();
-    void RunCheat(const ARCode& arcode);
+
+    // Cheat codes are decoded once into a flat list of operations, so the
+    // per-frame pass doesn't decode opcodes or scan for inline data
+    enum class AROpType : u8
+    {
+        Write32, Write16, Write8,
+        If32, If16,
+        LoadOffset,
+        For,
+        Stop,
+        Counter,
+        StoreOffset,
+        EndIf, Next, NextFlush,
+        SetOffset, AddOffset,
+        DataOp, SetData,
+        StoreData32, StoreData16, StoreData8,
+        LoadData32, LoadData16, LoadData8,
+        CopyData, CopyMemory,
+    };
+
+    struct AROp
+    {
+        AROpType Type;
+        bool Skippable;     // skipped while the current condition is false
+        bool Absolute;      // Addr doesn't depend on the offset register
+        u8 Arg;             // comparison, D4 operation
+        u32 Addr;           // address, relative to the offset register unless Absolute
+        u32 Value;          // immediate; If16: the value to compare
+        u32 Extra;          // If16: mask; CopyData: index of the inline data in Data
+        u8* Ptr;            // resolved main RAM location for absolute main RAM addresses
+    };
+
+    struct ARProgram
+    {
+        u32 Start, End;     // range in Ops
+    };
+
+    std::vector<AROp> Ops;
+    std::vector<u32> Data;
+    std::vector<ARProgram> Programs;
+
+    // main RAM layout Ops were linked against
+    u8* LinkedMainRAM = nullptr;
+    u32 LinkedMainRAMMask = 0;
+
+    void Compile(const ARCode& arcode);
+    void Link();
+    void RunProgram(const ARProgram& program);
+
+    template <typename T> T Read(u32 addr);
+    template <typename T> void Write(u32 addr, T val);
+    template <typename T> T ReadOp(const AROp& op, u32 offset);
+    template <typename T> void WriteOp(const AROp& op, u32 offset, T val);
 
     melonDS::NDS& NDS;
 };
@@ -654,6 +654,11 @@ void ARMv5::Execute()
                 }
             }
         }
+        else if (mode == CPUExecuteMode::CachedInterpreter && RunInterpreterBlock())
+        {
+            if (Halted)
+                break;
+        }
         else
 #endif
         {
@@ -727,6 +732,83 @@ template void ARMv5::Execute<CPUExecuteMode::Interpreter>();
 template void ARMv5::Execute<CPUExecuteMode::InterpreterGDB>();
 #ifdef JIT_ENABLED
 template void ARMv5::Execute<CPUExecuteMode::JIT>();
+template void ARMv5::Execute<CPUExecuteMode::CachedInterpreter>();
+#endif
+
+#ifdef JIT_ENABLED
+// Runs a block of predecoded instructions, exactly like the interpreter would.
+// The opcodes in the pipeline come from the block instead of being fetched.
+// Returns false if there's no usable block here, in which case the regular
+// interpreter takes over for an instruction.
+bool ARMv5::RunInterpreterBlock()
+{
+    bool thumb = CPSR & 0x20;
+    u32 instrSize = thumb ? 2 : 4;
+    u32 instrAddr = R[15] - instrSize;
+
+    if ((instrAddr < FastBlockLookupStart || instrAddr >= (FastBlockLookupStart + FastBlockLookupSize))
+        && !NDS.JIT.SetupExecutableRegion(0, instrAddr, FastBlockLookup, FastBlockLookupStart, FastBlockLookupSize))
+        return false;
+
+    JitBlock* block = NDS.JIT.LookUpInterpreterBlock(0, FastBlockLookup,
+        instrAddr - FastBlockLookupStart, instrAddr);
+    if (!block || block->Thumb != thumb)
+    {
+        block = NDS.JIT.CompileInterpreterBlock(this);
+        if (!block)
+            return false;
+    }
+
+    // whatever is in the pipeline has to match what the block expects
+    // (it won't after code was overwritten right in front of the CPU)
+    const u32* pipeline = block->Pipeline.Data;
+    if (NextInstr[0] != pipeline[0] || NextInstr[1] != pipeline[1])
+        return false;
+
+    const InterpretedInstr* instrs = block->Instrs.Data;
+    u32 numInstrs = block->Instrs.Length;
+    u32 invalidations = NDS.JIT.BlockInvalidations;
+
+    for (u32 i = 0; i < numInstrs; i++)
+    {
+        u32 r15 = R[15] + instrSize;
+        R[15] = r15;
+        CurInstr = NextInstr[0];
+        NextInstr[0] = NextInstr[1];
+        NextInstr[1] = pipeline[i + 2];
+
+        if (thumb && (r15 & 0x2))
+            CodeCycles = 0;
+        else
+            CodeFetchTiming(r15);
+
+        if (CheckCondition(instrs[i].Cond))
+            instrs[i].Handler(this);
+        else
+            AddCycles_C();
+
+        if (Halted)
+        {
+            if (Halted == 1 && NDS.ARM9Timestamp < NDS.ARM9Target)
+            {
+                NDS.ARM9Timestamp = NDS.ARM9Target;
+            }
+            return true;
+        }
+        if (IRQ) TriggerIRQ();
+
+        NDS.ARM9Timestamp += Cycles;
+        Cycles = 0;
+
+        // branched, or the block may be gone
+        if (R[15] != r15 || (CPSR & 0x20) != (thumb ? 0x20 : 0)
+            || NDS.JIT.BlockInvalidations != invalidations
+            || NDS.ARM9Timestamp >= NDS.ARM9Target)
+            break;
+    }
+
+    return true;
+}
 #endif
 
 template <CPUExecuteMode mode>
@@ -793,6 +875,11 @@ void ARMv4::Execute()
                 }
             }
         }
+        else if (mode == CPUExecuteMode::CachedInterpreter && RunInterpreterBlock())
+        {
+            if (Halted)
+                break;
+        }
         else
 #endif
         {
@@ -869,6 +956,72 @@ template void ARMv4::Execute<CPUExecuteMode::Interpreter>();
 template void ARMv4::Execute<CPUExecuteMode::InterpreterGDB>();
 #ifdef JIT_ENABLED
 template void ARMv4::Execute<CPUExecuteMode::JIT>();
+template void ARMv4::Execute<CPUExecuteMode::CachedInterpreter>();
+#endif
+
+#ifdef JIT_ENABLED
+// see ARMv5::RunInterpreterBlock()
+bool ARMv4::RunInterpreterBlock()
+{
+    bool thumb = CPSR & 0x20;
+    u32 instrSize = thumb ? 2 : 4;
+    u32 instrAddr = R[15] - instrSize;
+
+    if ((instrAddr < FastBlockLookupStart || instrAddr >= (FastBlockLookupStart + FastBlockLookupSize))
+        && !NDS.JIT.SetupExecutableRegion(1, instrAddr, FastBlockLookup, FastBlockLookupStart, FastBlockLookupSize))
+        return false;
+
+    JitBlock* block = NDS.JIT.LookUpInterpreterBlock(1, FastBlockLookup,
+        instrAddr - FastBlockLookupStart, instrAddr);
+    if (!block || block->Thumb != thumb)
+    {
+        block = NDS.JIT.CompileInterpreterBlock(this);
+        if (!block)
+            return false;
+    }
+
+    const u32* pipeline = block->Pipeline.Data;
+    if (NextInstr[0] != pipeline[0] || NextInstr[1] != pipeline[1])
+        return false;
+
+    const InterpretedInstr* instrs = block->Instrs.Data;
+    u32 numInstrs = block->Instrs.Length;
+    u32 invalidations = NDS.JIT.BlockInvalidations;
+
+    for (u32 i = 0; i < numInstrs; i++)
+    {
+        u32 r15 = R[15] + instrSize;
+        R[15] = r15;
+        CurInstr = NextInstr[0];
+        NextInstr[0] = NextInstr[1];
+        NextInstr[1] = pipeline[i + 2];
+
+        if (CheckCondition(instrs[i].Cond))
+            instrs[i].Handler(this);
+        else
+            AddCycles_C();
+
+        if (Halted)
+        {
+            if (Halted == 1 && NDS.ARM7Timestamp < NDS.ARM7Target)
+            {
+                NDS.ARM7Timestamp = NDS.ARM7Target;
+            }
+            return true;
+        }
+        if (IRQ) TriggerIRQ();
+
+        NDS.ARM7Timestamp += Cycles;
+        Cycles = 0;
+
+        if (R[15] != r15 || (CPSR & 0x20) != (thumb ? 0x20 : 0)
+            || NDS.JIT.BlockInvalidations != invalidations
+            || NDS.ARM7Timestamp >= NDS.ARM7Target)
+            break;
+    }
+
+    return true;
+}
 #endif
 
 void ARMv5::FillPipeline()
@@ -1278,33 +1431,44 @@ void ARMv5::BusWrite32(u32 addr, u32 val)
     NDS.ARM9Write32(addr, val);
 }
 
+void ARMv4::DetachedAccess()
+{
+    NDS.ARM7Thread.Reattach();
+}
+
 u8 ARMv4::BusRead8(u32 addr)
 {
+    CheckDetachedAccess(addr);
     return NDS.ARM7Read8(addr);
 }
 
 u16 ARMv4::BusRead16(u32 addr)
 {
+    CheckDetachedAccess(addr);
     return NDS.ARM7Read16(addr);
 }
 
 u32 ARMv4::BusRead32(u32 addr)
 {
+    CheckDetachedAccess(addr);
     return NDS.ARM7Read32(addr);
 }
 
 void ARMv4::BusWrite8(u32 addr, u8 val)
 {
+    CheckDetachedAccess(addr);
     NDS.ARM7Write8(addr, val);
 }
 
 void ARMv4::BusWrite16(u32 addr, u16 val)
 {
+    CheckDetachedAccess(addr);
     NDS.ARM7Write16(addr, val);
 }
 
 void ARMv4::BusWrite32(u32 addr, u32 val)
 {
+    CheckDetachedAccess(addr);
     NDS.ARM7Write32(addr, val);
 }
 }
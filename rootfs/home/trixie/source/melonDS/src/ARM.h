@@ -48,7 +48,8 @@ enum class CPUExecuteMode : u32
     Interpreter,
     InterpreterGDB,
 #ifdef JIT_ENABLED
-    JIT
+    JIT,
+    CachedInterpreter,
 #endif
 };
 
@@ -253,6 +254,8 @@ public:
 
     // all code accesses are forced nonseq 32bit
     u32 CodeRead32(u32 addr, bool branch);
+    // only the timing side of a sequential CodeRead32
+    void CodeFetchTiming(u32 addr);
 
     void DataRead8(u32 addr, u32* val) override;
     void DataRead16(u32 addr, u32* val) override;
@@ -372,6 +375,10 @@ public:
 #endif
 
 protected:
+#ifdef JIT_ENABLED
+    bool RunInterpreterBlock();
+#endif
+
     u8 BusRead8(u32 addr) override;
     u16 BusRead16(u32 addr) override;
     u32 BusRead32(u32 addr) override;
@@ -414,7 +421,22 @@ public:
     void AddCycles_CI(s32 num) override;
     void AddCycles_CDI() override;
     void AddCycles_CD() override;
+
+    // set while running on the ARM7 thread alongside the ARM9 (see ARM7Thread)
+    bool Detached = false;
 protected:
+#ifdef JIT_ENABLED
+    bool RunInterpreterBlock();
+#endif
+
+    void CheckDetachedAccess(u32 addr)
+    {
+        // the ARM7 BIOS and WRAM can't be seen by anything else
+        if (Detached && addr >= 0x00004000 && (addr & 0xFF800000) != 0x03800000)
+            DetachedAccess();
+    }
+    void DetachedAccess();
+
     u8 BusRead8(u32 addr) override;
     u16 BusRead16(u32 addr) override;
     u32 BusRead32(u32 addr) override;
@@ -0,0 +1,232 @@
+/*
+    Copyright 2016-2025 melonDS team
+
+    This file is part of melonDS.
+
+    melonDS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include <algorithm>
+#include <thread>
+
+#include "ARM7Thread.h"
+#include "NDS.h"
+
+namespace melonDS
+{
+
+// how long the ARM7 thread busy-waits for work before going to sleep
+const int kSpinCount = 4096;
+
+// fallback: checked every kStatPeriod timeslices, if the ARM7 ran detached
+// less than a quarter of the time, don't detach for kFallbackLength timeslices
+const u32 kStatPeriod = 256;
+const u32 kFallbackLength = 16384;
+
+// handing the ARM7 over to its thread isn't free, not worth it for short timeslices
+const u64 kMinSliceLength = 512;
+
+ARM7Thread::ARM7Thread(melonDS::NDS& nds) noexcept : NDS(nds)
+{
+}
+
+ARM7Thread::~ARM7Thread() noexcept
+{
+    SetEnabled(false);
+}
+
+void ARM7Thread::Reset() noexcept
+{
+    NumDetached = 0;
+    StatDetachedCycles = 0;
+    StatTotalCycles = 0;
+    FallbackCount = 0;
+}
+
+void ARM7Thread::SetEnabled(bool enable) noexcept
+{
+    if (enable == Enabled)
+        return;
+
+    Enabled = enable;
+    if (enable)
+    {
+        Sema_Wake = Platform::Semaphore_Create();
+        State = State_Idle;
+        Sleeping = false;
+        Thread = Platform::Thread_Create([this]() { ThreadFunc(); });
+    }
+    else
+    {
+        SetState(State_Quit);
+        Platform::Thread_Wait(Thread);
+        Platform::Thread_Free(Thread);
+        Thread = nullptr;
+        Platform::Semaphore_Free(Sema_Wake);
+        Sema_Wake = nullptr;
+    }
+
+    Reset();
+}
+
+void ARM7Thread::SetState(int state) noexcept
+{
+    State.store(state);
+    if (Sleeping.exchange(false))
+        Platform::Semaphore_Post(Sema_Wake);
+}
+
+void ARM7Thread::WaitState(int state) noexcept
+{
+    while (State.load(std::memory_order_acquire) != state)
+        std::this_thread::yield();
+}
+
+bool ARM7Thread::Detach(u64 target) noexcept
+{
+    if (!Enabled || NDS.ConsoleType != 0)
+        return false;
+
+    if (FallbackCount)
+    {
+        FallbackCount--;
+        return false;
+    }
+
+    // halted or about to take an IRQ: nothing worth running alongside the ARM9
+    if (NDS.CPUStop & CPUStop_DMA7)
+        return false;
+    if (NDS.ARM7.Halted || NDS.ARM7.IRQ)
+        return false;
+    if ((NDS.ARM7Timestamp + kMinSliceLength) > target)
+        return false;
+
+    DetachStart = NDS.ARM7Timestamp;
+    DetachTarget = std::min(target, DetachStart + MaxSkew);
+    DetachedCycles = 0;
+    DetachPending = true;
+    Parked = false;
+
+    SetState(State_Detached);
+    return true;
+}
+
+void ARM7Thread::WaitDetached() noexcept
+{
+    int state;
+    while ((state = State.load(std::memory_order_acquire)) == State_Detached)
+        std::this_thread::yield();
+
+    Parked = (state == State_Parked);
+    DetachPending = false;
+}
+
+void ARM7Thread::Join(u64 target) noexcept
+{
+    if (DetachPending)
+        WaitDetached();
+
+    StatDetachedCycles += DetachedCycles;
+    if (target > DetachStart)
+        StatTotalCycles += target - DetachStart;
+    if (++NumDetached >= kStatPeriod)
+    {
+        if ((StatDetachedCycles * 4) < StatTotalCycles)
+            FallbackCount = kFallbackLength;
+
+        NumDetached = 0;
+        StatDetachedCycles = 0;
+        StatTotalCycles = 0;
+    }
+
+    if (Parked)
+    {
+        // the ARM7 is waiting in the middle of an instruction, let its thread finish
+        JoinTarget = target;
+        SetState(State_Resumed);
+        WaitState(State_Done);
+        State = State_Idle;
+    }
+    else
+    {
+        State = State_Idle;
+        NDS.RunTimers(1);
+        NDS.RunARM7<CPUExecuteMode::Interpreter>(target);
+    }
+}
+
+void ARM7Thread::Reattach() noexcept
+{
+    NDS.ARM7.Detached = false;
+    DetachedCycles = NDS.ARM7Timestamp - DetachStart;
+
+    State.store(State_Parked, std::memory_order_release);
+    WaitState(State_Resumed);
+
+    NDS.ARM7Target = JoinTarget;
+}
+
+void ARM7Thread::ThreadFunc() noexcept
+{
+    for (;;)
+    {
+        int state;
+        for (int spin = 0;; spin++)
+        {
+            state = State.load(std::memory_order_acquire);
+            if (state == State_Detached || state == State_Quit)
+                break;
+
+            if (spin < kSpinCount)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            Sleeping = true;
+            state = State.load();
+            if (state == State_Detached || state == State_Quit)
+            {
+                Sleeping = false;
+                break;
+            }
+
+            Platform::Semaphore_Wait(Sema_Wake);
+            Sleeping = false;
+            spin = 0;
+        }
+
+        if (state == State_Quit)
+            break;
+
+        NDS.ARM7Target = DetachTarget;
+        NDS.ARM7.Detached = true;
+        NDS.ARM7.Execute<CPUExecuteMode::Interpreter>();
+
+        if (NDS.ARM7.Detached)
+        {
+            // reached the end of the detached timeslice without needing anything
+            NDS.ARM7.Detached = false;
+            DetachedCycles = NDS.ARM7Timestamp - DetachStart;
+            State.store(State_Finished, std::memory_order_release);
+            continue;
+        }
+
+        // reattached, the ARM9 is done and waiting for us to finish the timeslice
+        NDS.RunTimers(1);
+        NDS.RunARM7<CPUExecuteMode::Interpreter>(JoinTarget);
+        State.store(State_Done, std::memory_order_release);
+    }
+}
+
+}
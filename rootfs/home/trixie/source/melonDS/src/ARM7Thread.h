@@ -0,0 +1,127 @@
+/*
+    Copyright 2016-2025 melonDS team
+
+    This file is part of melonDS.
+
+    melonDS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef ARM7THREAD_H
+#define ARM7THREAD_H
+
+#include <atomic>
+
+#include "types.h"
+#include "Platform.h"
+
+namespace melonDS
+{
+class NDS;
+
+// Runs the ARM7 on its own host thread, alongside the ARM9.
+//
+// Normally, for every timeslice the ARM9 is run first, then the ARM7
+// catches up to it. With this enabled, the ARM7 starts its timeslice at the
+// same time as the ARM9, but "detached": it may only touch its own BIOS and
+// WRAM. As soon as it accesses anything else (IO, main RAM, shared WRAM...),
+// it waits for the ARM9 to be done with its timeslice, and the rest of the
+// ARM7 timeslice runs like before.
+//
+// Conversely, the ARM9 waits for the ARM7 to stop before it touches the ARM7's
+// interrupt state (IPC, IRQ lines), so the two never touch the same state
+// at the same time. What the ARM7 does while detached only depends on its own
+// state, so the emulation stays deterministic; the difference with the
+// regular path is that an IRQ raised by the ARM9 may be seen by the ARM7
+// up to one timeslice (at most MaxSkew cycles) later.
+//
+// Only used for the DS, with the interpreter. If the ARM7 keeps needing shared
+// state right away, detaching is turned off for a while.
+class ARM7Thread
+{
+public:
+    explicit ARM7Thread(melonDS::NDS& nds) noexcept;
+    ~ARM7Thread() noexcept;
+    ARM7Thread(const ARM7Thread&) = delete;
+    ARM7Thread& operator=(const ARM7Thread&) = delete;
+
+    void Reset() noexcept;
+
+    void SetEnabled(bool enable) noexcept;
+    [[nodiscard]] bool IsEnabled() const noexcept { return Enabled; }
+
+    /// Sets the maximum amount of system cycles the ARM7 may run detached.
+    void SetMaxSkew(u32 cycles) noexcept { MaxSkew = cycles ? cycles : 1; }
+    [[nodiscard]] u32 GetMaxSkew() const noexcept { return MaxSkew; }
+
+    // starts running the ARM7 on its thread, if possible
+    // returns whether it was started, in which case Join() must be called
+    bool Detach(u64 target) noexcept;
+
+    // once the ARM9 is done with its timeslice: runs the ARM7 up to the given target
+    void Join(u64 target) noexcept;
+
+    // to be called on the ARM9 side before touching the ARM7's state
+    void Sync() noexcept
+    {
+        if (DetachPending) WaitDetached();
+    }
+
+    // called by the detached ARM7 when it needs to access shared state
+    void Reattach() noexcept;
+
+private:
+    enum
+    {
+        State_Idle = 0,
+        State_Detached,
+        State_Finished,
+        State_Parked,
+        State_Resumed,
+        State_Done,
+        State_Quit,
+    };
+
+    melonDS::NDS& NDS;
+
+    bool Enabled = false;
+    u32 MaxSkew = 2048;
+
+    Platform::Thread* Thread = nullptr;
+    Platform::Semaphore* Sema_Wake = nullptr;
+    std::atomic_int State = State_Idle;
+    std::atomic_bool Sleeping = false;
+
+    // only touched by the emulator thread
+    bool DetachPending = false;
+    bool Parked = false;
+
+    u64 DetachStart = 0;
+    u64 DetachTarget = 0;
+    u64 JoinTarget = 0;
+    u64 DetachedCycles = 0;
+
+    // fallback: stop detaching if the ARM7 keeps reattaching right away
+    u32 NumDetached = 0;
+    u64 StatDetachedCycles = 0;
+    u64 StatTotalCycles = 0;
+    u32 FallbackCount = 0;
+
+    void ThreadFunc() noexcept;
+    void SetState(int state) noexcept;
+    void WaitState(int state) noexcept;
+    void WaitDetached() noexcept;
+};
+
+}
+
+#endif // ARM7THREAD_H
@@ -913,25 +913,225 @@ void ARMJIT::CompileBlock(ARM* cpu) noexcept
         assert(addressRanges[j] == block->AddressRanges()[j]);
         assert(addressMasks[j] == block->AddressMasks()[j]);
         assert(addressMasks[j] != 0);
+    }
 
-        AddressRange* region = CodeMemRegions[addressRanges[j] >> 27];
+    RegisterBlock(block);
 
-        if (!PageContainsCode(&region[(addressRanges[j] & 0x7FFF000 & ~(Memory.PageSize - 1)) / 512], Memory.PageSize))
-            Memory.SetCodeProtection(addressRanges[j] >> 27, addressRanges[j] & 0x7FFFFFF, true);
+    u64* entry = &FastBlockLookupRegions[(localAddr >> 27)][(localAddr & 0x7FFFFFF) / 2];
+    *entry = ((u64)blockAddr | cpu->Num) << 32;
+    *entry |= JITCompiler.SubEntryOffset(block->EntryPoint);
+}
 
-        AddressRange* range = &region[(addressRanges[j] & 0x7FFFFFF) / 512];
-        range->Code |= addressMasks[j];
+void ARMJIT::RegisterBlock(JitBlock* block) noexcept
+{
+    for (u32 j = 0; j < block->NumAddresses; j++)
+    {
+        u32 addr = block->AddressRanges()[j];
+        AddressRange* region = CodeMemRegions[addr >> 27];
+
+        if (!PageContainsCode(&region[(addr & 0x7FFF000 & ~(Memory.PageSize - 1)) / 512], Memory.PageSize))
+            Memory.SetCodeProtection(addr >> 27, addr & 0x7FFFFFF, true);
+
+        AddressRange* range = &region[(addr & 0x7FFFFFF) / 512];
+        range->Code |= block->AddressMasks()[j];
         range->Blocks.Add(block);
     }
 
+    if (block->Num == 0)
+        JitBlocks9[block->StartAddr] = block;
+    else
+        JitBlocks7[block->StartAddr] = block;
+}
+
+// the opcode as it would be found in NextInstr
+// (on the ARM9, THUMB code is fetched 32 bits at once)
+static u32 FetchPipelineOpcode(ARM* cpu, bool thumb, u32 addr)
+{
     if (cpu->Num == 0)
-        JitBlocks9[blockAddr] = block;
+    {
+        ARMv5* cpuv5 = (ARMv5*)cpu;
+        if (thumb && (addr & 0x2))
+            return cpuv5->CodeRead32(addr - 2, false) >> 16;
+        return cpuv5->CodeRead32(addr, false);
+    }
     else
-        JitBlocks7[blockAddr] = block;
+    {
+        ARMv4* cpuv4 = (ARMv4*)cpu;
+        if (thumb)
+            return cpuv4->CodeRead16(addr);
+        return cpuv4->CodeRead32(addr);
+    }
+}
 
-    u64* entry = &FastBlockLookupRegions[(localAddr >> 27)][(localAddr & 0x7FFFFFF) / 2];
-    *entry = ((u64)blockAddr | cpu->Num) << 32;
-    *entry |= JITCompiler.SubEntryOffset(block->EntryPoint);
+JitBlock* ARMJIT::CompileInterpreterBlock(ARM* cpu) noexcept
+{
+    const int maxBlockSize = 32;
+
+    bool thumb = cpu->CPSR & 0x20;
+    u32 instrSize = thumb ? 2 : 4;
+    u32 blockAddr = cpu->R[15] - instrSize;
+
+    u32 localAddr = LocaliseCodeAddress(cpu->Num, blockAddr);
+    if (!localAddr)
+        return nullptr;
+
+    auto& map = cpu->Num == 0 ? JitBlocks9 : JitBlocks7;
+    auto existingBlockIt = map.find(blockAddr);
+    if (existingBlockIt != map.end())
+    {
+        JitBlock* existingBlock = existingBlockIt->second;
+        if (existingBlock->StartAddrLocal == localAddr && existingBlock->Thumb == thumb)
+        {
+            // same block, seen through another mirror
+            u64* entry = &FastBlockLookupRegions[localAddr >> 27][(localAddr & 0x7FFFFFF) / 2];
+            *entry = (((u64)blockAddr | cpu->Num) << 32) | existingBlock->InterpreterSlot;
+            return existingBlock;
+        }
+
+        // some memory has been remapped, or we're in the other instruction set
+        RemoveInterpreterBlock(existingBlock);
+    }
+
+    InterpretedInstr instrs[maxBlockSize];
+    u32 pipeline[maxBlockSize + 2];
+
+    u32 addressRanges[maxBlockSize + 2];
+    u32 addressMasks[maxBlockSize + 2];
+    u32 numAddressRanges = 0;
+
+    // every opcode which goes through the pipeline is part of the block
+    // so that it gets invalidated if any of them are overwritten
+    auto addAddress = [&](u32 addr) -> bool
+    {
+        u32 translatedAddr = LocaliseCodeAddress(cpu->Num, addr);
+        if (!translatedAddr)
+            return false;
+
+        u32 translatedAddrRounded = translatedAddr & ~0x1FF;
+        u32 j = 0;
+        for (; j < numAddressRanges; j++)
+            if (addressRanges[j] == translatedAddrRounded)
+                break;
+        if (j == numAddressRanges)
+        {
+            addressRanges[numAddressRanges] = translatedAddrRounded;
+            addressMasks[numAddressRanges++] = 0;
+        }
+        addressMasks[j] |= 1 << ((translatedAddr & 0x1FF) / 16);
+        return true;
+    };
+
+    if (!addAddress(blockAddr) || !addAddress(blockAddr + instrSize))
+        return nullptr;
+
+    pipeline[0] = FetchPipelineOpcode(cpu, thumb, blockAddr);
+    pipeline[1] = FetchPipelineOpcode(cpu, thumb, blockAddr + instrSize);
+
+    int i = 0;
+    do
+    {
+        u32 fetchAddr = blockAddr + (i + 2) * instrSize;
+        if (!addAddress(fetchAddr))
+            break;
+        pipeline[i + 2] = FetchPipelineOpcode(cpu, thumb, fetchAddr);
+
+        u32 instr = pipeline[i];
+        ARMInstrInfo::Info info = ARMInstrInfo::Decode(thumb, cpu->Num, instr, false);
+
+        if (thumb)
+        {
+            instrs[i].Handler = ARMInterpreter::THUMBInstrTable[(instr >> 6) & 0x3FF];
+            instrs[i].Cond = 0xE;
+        }
+        else if (cpu->Num == 0 && (instr & 0xFE000000) == 0xFA000000)
+        {
+            instrs[i].Handler = ARMInterpreter::A_BLX_IMM;
+            instrs[i].Cond = 0xE;
+        }
+        else
+        {
+            instrs[i].Handler = ARMInterpreter::ARMInstrTable[((instr >> 4) & 0xF) | ((instr >> 16) & 0xFF0)];
+            instrs[i].Cond = instr >> 28;
+        }
+
+        i++;
+
+        // coprocessor writes can remap the memory we're running from
+        if (info.EndBlock || (!thumb && info.Kind == ARMInstrInfo::ak_MCR))
+            break;
+    } while (i < maxBlockSize);
+
+    if (i == 0)
+        return nullptr;
+
+    JitBlock* block = new JitBlock(cpu->Num, 0, numAddressRanges, 0);
+    block->LiteralHash = 0;
+    block->InstrHash = 0;
+    for (u32 j = 0; j < numAddressRanges; j++)
+    {
+        block->AddressRanges()[j] = addressRanges[j];
+        block->AddressMasks()[j] = addressMasks[j];
+    }
+    block->StartAddr = blockAddr;
+    block->StartAddrLocal = localAddr;
+    block->EntryPoint = nullptr;
+    block->Thumb = thumb;
+
+    block->Instrs.SetLength(i);
+    memcpy(block->Instrs.Data, instrs, i * sizeof(InterpretedInstr));
+    block->Pipeline.SetLength(i + 2);
+    memcpy(block->Pipeline.Data, pipeline, (i + 2) * sizeof(u32));
+
+    if (FreeInterpreterSlots.empty())
+    {
+        block->InterpreterSlot = InterpreterBlocks.size();
+        InterpreterBlocks.push_back(block);
+    }
+    else
+    {
+        block->InterpreterSlot = FreeInterpreterSlots.back();
+        FreeInterpreterSlots.pop_back();
+        InterpreterBlocks[block->InterpreterSlot] = block;
+    }
+
+    RegisterBlock(block);
+
+    u64* entry = &FastBlockLookupRegions[localAddr >> 27][(localAddr & 0x7FFFFFF) / 2];
+    *entry = (((u64)blockAddr | cpu->Num) << 32) | block->InterpreterSlot;
+
+    return block;
+}
+
+void ARMJIT::RemoveInterpreterBlock(JitBlock* block) noexcept
+{
+    for (int j = 0; j < block->NumAddresses; j++)
+    {
+        u32 addr = block->AddressRanges()[j];
+        AddressRange* region = CodeMemRegions[addr >> 27];
+        AddressRange* range = &region[(addr & 0x7FFFFFF) / 512];
+
+        // the code mask stays as it is, it's going to be fixed up by the next invalidation
+        range->Blocks.RemoveByValue(block);
+
+        if (range->Blocks.Length == 0
+            && !PageContainsCode(&region[(addr & 0x7FFF000 & ~(Memory.PageSize - 1)) / 512], Memory.PageSize))
+        {
+            Memory.SetCodeProtection(addr >> 27, addr & 0x7FFFFFF, false);
+        }
+    }
+
+    u64* entry = &FastBlockLookupRegions[block->StartAddrLocal >> 27][(block->StartAddrLocal & 0x7FFFFFF) / 2];
+    if ((u32)*entry == block->InterpreterSlot)
+        *entry = (u64)UINT32_MAX << 32;
+    if (block->Num == 0)
+        JitBlocks9.erase(block->StartAddr);
+    else
+        JitBlocks7.erase(block->StartAddr);
+
+    InterpreterBlocks[block->InterpreterSlot] = nullptr;
+    FreeInterpreterSlots.push_back(block->InterpreterSlot);
+    BlockInvalidations++;
+    delete block;
 }
 
 void ARMJIT::InvalidateByAddr(u32 localAddr) noexcept
@@ -1017,7 +1217,15 @@ void ARMJIT::InvalidateByAddr(u32 localAddr) noexcept
         else
             JitBlocks7.erase(block->StartAddr);
 
-        if (!literalInvalidation)
+        BlockInvalidations++;
+        if (block->Instrs.Length)
+        {
+            // cached interpreter blocks are cheap to rebuild, no need to keep them around
+            InterpreterBlocks[block->InterpreterSlot] = nullptr;
+            FreeInterpreterSlots.push_back(block->InterpreterSlot);
+            delete block;
+        }
+        else if (!literalInvalidation)
         {
             RetireJitBlock(block);
         }
@@ -1153,6 +1361,10 @@ void ARMJIT::ResetBlockCache() noexcept
     JitBlocks9.clear();
     JitBlocks7.clear();
 
+    InterpreterBlocks.clear();
+    FreeInterpreterSlots.clear();
+    BlockInvalidations++;
+
     JITCompiler.Reset();
 }
 
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <optional>
 #include <memory>
+#include <vector>
 #include "types.h"
 #include "MemConstants.h"
 #include "Args.h"
@@ -66,6 +67,21 @@ public:
     bool SetupExecutableRegion(u32 num, u32 blockAddr, u64*& entry, u32& start, u32& size) noexcept;
     u32 LocaliseCodeAddress(u32 num, u32 addr) const noexcept;
 
+    // cached interpreter: blocks of predecoded instructions, run by the
+    // interpreter and invalidated the same way as compiled blocks
+    // the block cache has to be reset when switching between this and the JIT
+    JitBlock* LookUpInterpreterBlock(u32 num, u64* entries, u32 offset, u32 addr) noexcept
+    {
+        u64* entry = &entries[offset / 2];
+        if (*entry >> 32 == (addr | num))
+            return InterpreterBlocks[(u32)*entry];
+        return nullptr;
+    }
+    JitBlock* CompileInterpreterBlock(ARM* cpu) noexcept;
+
+    // incremented every time blocks are thrown away
+    u32 BlockInvalidations = 0;
+
     ARMJIT_Memory Memory;
 private:
     int MaxBlockSize {};
@@ -73,6 +89,12 @@ private:
     bool BranchOptimizations = false;
     bool FastMemory = false;
 
+    std::vector<JitBlock*> InterpreterBlocks {};
+    std::vector<u32> FreeInterpreterSlots {};
+
+    void RegisterBlock(JitBlock* block) noexcept;
+    void RemoveInterpreterBlock(JitBlock* block) noexcept;
+
 public:
     melonDS::NDS& NDS;
     TinyVector<u32> InvalidLiterals {};
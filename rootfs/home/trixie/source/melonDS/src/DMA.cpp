@@ -196,6 +196,39 @@ void DMA::Start()
     NDS.StopCPU(CPU, 1<<Num);
 }
 
+// whether this channel is set up to fetch one word from the given I/O port
+// each time it's triggered, ie. the usual way of streaming data from the cart
+// such a channel can be started once for a whole block (see StartBulk())
+bool DMA::CanRunBulk(u32 srcaddr) const noexcept
+{
+    if (Running || InProgress) return false;
+
+    u32 countmask;
+    if (CPU == 0)
+        countmask = 0x001FFFFF;
+    else
+        countmask = (Num==3 ? 0x0000FFFF : 0x00003FFF);
+
+    // 32-bit, repeat, no IRQ
+    if ((Cnt & 0x46000000) != 0x06000000) return false;
+    // fixed source, destination not reloaded between triggers
+    if ((Cnt & 0x01800000) != 0x01000000) return false;
+    if ((Cnt & 0x00600000) == 0x00600000) return false;
+    if ((Cnt & countmask) != 1) return false;
+
+    return CurSrcAddr == srcaddr;
+}
+
+// runs the given amount of single-word triggers as one burst
+// the end state is the same as after that many separate runs
+void DMA::StartBulk(u32 count)
+{
+    Start();
+
+    RemCount = count;
+    IterCount = count;
+}
+
 u32 DMA::UnitTimings9_16(bool burststart)
 {
     u32 src_id = CurSrcAddr >> 14;
@@ -579,12 +612,20 @@ void DMA::Run9()
     }
     else
     {
+        // display lists sent from main RAM: feed the GXFIFO directly
+        // instead of going through the generic memory accessors
+        GPU3D& gpu3d = NDS.GPU.GPU3D;
+        bool gxfifo = IsGXFIFODMA && NDS.ConsoleType == 0 && gpu3d.GeometryEnabled;
+
         while (IterCount > 0 && !Stall)
         {
             NDS.ARM9Timestamp += (UnitTimings9_32(burststart) << NDS.ARM9ClockShift);
             burststart = false;
 
-            NDS.ARM9Write32(CurDstAddr, NDS.ARM9Read32(CurSrcAddr));
+            if (gxfifo && (CurSrcAddr >> 24) == 0x02)
+                gpu3d.WriteToGXFIFO(*(u32*)&NDS.MainRAM[CurSrcAddr & ~3 & NDS.MainRAMMask]);
+            else
+                NDS.ARM9Write32(CurDstAddr, NDS.ARM9Read32(CurSrcAddr));
 
             CurSrcAddr += SrcAddrInc<<2;
             CurDstAddr += DstAddrInc<<2;
@@ -40,6 +40,9 @@ public:
     void WriteCnt(u32 val);
     void Start();
 
+    bool CanRunBulk(u32 srcaddr) const noexcept;
+    void StartBulk(u32 count);
+
     u32 UnitTimings9_16(bool burststart);
     u32 UnitTimings9_32(bool burststart);
     u32 UnitTimings7_16(bool burststart);
@@ -1069,6 +1069,16 @@ void DSi::CheckDMAs(u32 cpu, u32 mode)
 
     CheckNDMAs(cpu, NDMAModes[mode]);
 }
+
+bool DSi::StartBulkDMA(u32 cpu, u32 mode, u32 srcaddr, u32 count)
+{
+    // NDMAs triggered by the same event need to see every word
+    if (NDMAsInMode(cpu, NDMAModes[mode]))
+        return false;
+
+    return NDS::StartBulkDMA(cpu, mode, srcaddr, count);
+}
+
 // new WRAM mapping
 // TODO: find out what happens upon overlapping slots!!
 
@@ -169,6 +169,7 @@ public:
     bool DMAsRunning(u32 cpu) const override;
     void StopDMAs(u32 cpu, u32 mode) override;
     void CheckDMAs(u32 cpu, u32 mode) override;
+    bool StartBulkDMA(u32 cpu, u32 mode, u32 srcaddr, u32 count) override;
     u16 SCFG_Clock7;
     u32 SCFG_MC;
     u16 SCFG_RST;
@@ -23,6 +23,7 @@
 
 #include "GPU2D.h"
 #include "GPU3D.h"
+#include "GPU_VRAMMemory.h"
 #include "NonStupidBitfield.h"
 
 namespace melonDS
@@ -550,15 +551,18 @@ public:
     alignas(u64) u8 Palette[2*1024] {};
     alignas(u64) u8 OAM[2*1024] {};
 
-    alignas(u64) u8 VRAM_A[128*1024] {};
-    alignas(u64) u8 VRAM_B[128*1024] {};
-    alignas(u64) u8 VRAM_C[128*1024] {};
-    alignas(u64) u8 VRAM_D[128*1024] {};
-    alignas(u64) u8 VRAM_E[ 64*1024] {};
-    alignas(u64) u8 VRAM_F[ 16*1024] {};
-    alignas(u64) u8 VRAM_G[ 16*1024] {};
-    alignas(u64) u8 VRAM_H[ 32*1024] {};
-    alignas(u64) u8 VRAM_I[ 16*1024] {};
+    // owns the bank storage and the VRAMFlat_* views, must be declared before them
+    VRAMMemory VRAMStorage;
+
+    u8* const VRAM_A = VRAMStorage.GetBank(0); // 128K
+    u8* const VRAM_B = VRAMStorage.GetBank(1); // 128K
+    u8* const VRAM_C = VRAMStorage.GetBank(2); // 128K
+    u8* const VRAM_D = VRAMStorage.GetBank(3); // 128K
+    u8* const VRAM_E = VRAMStorage.GetBank(4); //  64K
+    u8* const VRAM_F = VRAMStorage.GetBank(5); //  16K
+    u8* const VRAM_G = VRAMStorage.GetBank(6); //  16K
+    u8* const VRAM_H = VRAMStorage.GetBank(7); //  32K
+    u8* const VRAM_I = VRAMStorage.GetBank(8); //  16K
 
     u8* const VRAM[9]     = {VRAM_A,  VRAM_B,  VRAM_C,  VRAM_D,  VRAM_E, VRAM_F, VRAM_G, VRAM_H, VRAM_I};
     u32 const VRAMMask[9] = {0x1FFFF, 0x1FFFF, 0x1FFFF, 0x1FFFF, 0xFFFF, 0x3FFF, 0x3FFF, 0x7FFF, 0x3FFF};
@@ -602,19 +606,22 @@ public:
     VRAMTrackingSet<512*1024, 128*1024> VRAMDirty_Texture {};
     VRAMTrackingSet<128*1024, 16*1024> VRAMDirty_TexPal {};
 
-    u8 VRAMFlat_ABG[512*1024] {};
-    u8 VRAMFlat_BBG[128*1024] {};
-    u8 VRAMFlat_AOBJ[256*1024] {};
-    u8 VRAMFlat_BOBJ[128*1024] {};
+    // slots of these with a single bank mapped alias the bank (see VRAMMemory)
+    // so they must never be written to outside of CopyLinearVRAM
+    u8* const VRAMFlat_ABG = VRAMStorage.GetView(VRAMView_ABG);             // 512K
+    u8* const VRAMFlat_BBG = VRAMStorage.GetView(VRAMView_BBG);             // 128K
+    u8* const VRAMFlat_AOBJ = VRAMStorage.GetView(VRAMView_AOBJ);           // 256K
+    u8* const VRAMFlat_BOBJ = VRAMStorage.GetView(VRAMView_BOBJ);           // 128K
 
-    alignas(u16) u8 VRAMFlat_ABGExtPal[32*1024] {};
-    alignas(u16) u8 VRAMFlat_BBGExtPal[32*1024] {};
+    u8* const VRAMFlat_ABGExtPal = VRAMStorage.GetView(VRAMView_ABGExtPal);   // 32K
+    u8* const VRAMFlat_BBGExtPal = VRAMStorage.GetView(VRAMView_BBGExtPal);   // 32K
 
-    alignas(u16) u8 VRAMFlat_AOBJExtPal[8*1024] {};
-    alignas(u16) u8 VRAMFlat_BOBJExtPal[8*1024] {};
+    u8* const VRAMFlat_AOBJExtPal = VRAMStorage.GetView(VRAMView_AOBJExtPal); // 8K
+    u8* const VRAMFlat_BOBJExtPal = VRAMStorage.GetView(VRAMView_BOBJExtPal); // 8K
 
-    alignas(u64) u8 VRAMFlat_Texture[512*1024] {};
-    alignas(u64) u8 VRAMFlat_TexPal[128*1024] {};
+    // never aliased, these are copies made coherent at frame start
+    u8* const VRAMFlat_Texture = VRAMStorage.GetView(VRAMView_Texture);     // 512K
+    u8* const VRAMFlat_TexPal = VRAMStorage.GetView(VRAMView_TexPal);       // 128K
 private:
     void ResetVRAMCache() noexcept;
     void AssignFramebuffers() noexcept;
@@ -667,15 +674,27 @@ private:
     }
 
     template <u32 MappingGranularity, u32 Size>
-    constexpr bool CopyLinearVRAM(u8* flat, const u32* mappings, NonStupidBitField<Size>& dirty, u64 (GPU::* const slowAccess)(u32) const noexcept) noexcept
+    constexpr bool CopyLinearVRAM(u32 view, const u32* mappings, NonStupidBitField<Size>& dirty, u64 (GPU::* const slowAccess)(u32) const noexcept) noexcept
     {
         const u32 VRAMBitsPerMapping = MappingGranularity / VRAMDirtyGranularity;
 
+        u8* flat = VRAMStorage.GetView(view);
+        u32 aliased = VRAMStorage.UpdateAliases(view, mappings, MappingGranularity);
+
         bool change = false;
 
         typename NonStupidBitField<Size>::Iterator it = dirty.Begin();
         while (it != dirty.End())
         {
+            change = true;
+
+            // aliased slots already show the bank contents
+            if (aliased & (1 << (*it / VRAMBitsPerMapping)))
+            {
+                it++;
+                continue;
+            }
+
             u32 offset = *it * VRAMDirtyGranularity;
             u8* dst = flat + offset;
             u8* fastAccess = GetUniqueBankPtr(mappings[*it / VRAMBitsPerMapping], offset);
@@ -688,7 +707,6 @@ private:
                 for (u32 i = 0; i < VRAMDirtyGranularity; i += 8)
                     *(u64*)&dst[i] = (this->*slowAccess)(offset + i);
             }
-            change = true;
             it++;
         }
         return change;
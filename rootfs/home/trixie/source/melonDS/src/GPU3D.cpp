@@ -1742,8 +1742,9 @@ GPU3D::CmdFIFOEntry GPU3D::CmdFIFORead() noexcept
                 NDS.GXFIFOUnstall();
         }
 
-        CheckFIFODMA();
-        CheckFIFOIRQ();
+        // nothing can observe the FIFO while commands are being run
+        // so the FIFO DMA/IRQ checks are done once Run() is done with them
+        FIFOLevelChanged = true;
     }
 
     return ret;
@@ -2395,6 +2396,13 @@ void GPU3D::Run() noexcept
 
             ExecuteCommand();
         }
+
+        if (FIFOLevelChanged)
+        {
+            FIFOLevelChanged = false;
+            CheckFIFODMA();
+            CheckFIFOIRQ();
+        }
     }
 
     if (CycleCount <= 0 && CmdPIPE.IsEmpty())
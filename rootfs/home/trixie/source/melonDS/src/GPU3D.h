@@ -326,6 +326,7 @@ public:
 
     u32 FlushRequest = 0;
     u32 FlushAttributes = 0;
+    bool FIFOLevelChanged = false; // only used within Run(), don't serialize
     u32 ScrolledLine[256]; // not part of the hardware state, don't serialize
 };
 
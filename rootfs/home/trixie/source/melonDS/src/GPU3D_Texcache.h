@@ -113,7 +113,7 @@ public:
                         if (CheckInvalid(entry.TextureRAMStart[i], entry.TextureRAMSize[i],
                                 entry.TextureHash[i],
                                 textureDirty.Data,
-                                gpu.VRAMFlat_Texture, sizeof(gpu.VRAMFlat_Texture)))
+                                gpu.VRAMFlat_Texture, 512*1024))
                             goto invalidate;
                     }
                 }
@@ -123,7 +123,7 @@ public:
                     if (CheckInvalid(entry.TexPalStart, entry.TexPalSize,
                             entry.TexPalHash,
                             texPalDirty.Data,
-                            gpu.VRAMFlat_TexPal, sizeof(gpu.VRAMFlat_TexPal)))
+                            gpu.VRAMFlat_TexPal, 128*1024))
                         goto invalidate;
                 }
 
@@ -242,11 +242,11 @@ public:
         for (int i = 0; i < 2; i++)
         {
             if (entry.TextureRAMSize[i])
-                entry.TextureHash[i] = MaskedHash(gpu.VRAMFlat_Texture, sizeof(gpu.VRAMFlat_Texture),
+                entry.TextureHash[i] = MaskedHash(gpu.VRAMFlat_Texture, 512*1024,
                     entry.TextureRAMStart[i], entry.TextureRAMSize[i]);
         }
         if (entry.TexPalSize)
-            entry.TexPalHash = MaskedHash(gpu.VRAMFlat_TexPal, sizeof(gpu.VRAMFlat_TexPal),
+            entry.TexPalHash = MaskedHash(gpu.VRAMFlat_TexPal, 128*1024,
                 entry.TexPalStart, entry.TexPalSize);
 
         auto& texArrays = TexArrays[widthLog2][heightLog2];
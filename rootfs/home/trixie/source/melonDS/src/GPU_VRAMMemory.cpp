@@ -0,0 +1,324 @@
+/*
+    Copyright 2016-2025 melonDS team
+
+    This file is part of melonDS.
+
+    melonDS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#include "GPU_VRAMMemory.h"
+
+#ifdef VRAM_ALIASING_SUPPORTED
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Platform.h"
+
+namespace melonDS
+{
+using Platform::Log;
+using Platform::LogLevel;
+
+/*
+    Layout of the memory file (or the fallback buffer):
+
+        bank A-I | private storage for each view
+
+    Every region is aligned to StorageAlign, so that any slot of
+    either a bank or a view starts on a host page for all the page sizes
+    we care about. The file is sparse, the padding never gets touched.
+
+    The views themselves are a separate address range with the same
+    alignment, where each slot is mapped either to the matching slot of the
+    view's private storage or to the bank currently mapped there.
+*/
+
+static constexpr u32 StorageAlign = 0x10000;
+
+static constexpr u32 BankSizes[9] =
+{
+    128*1024, 128*1024, 128*1024, 128*1024, 64*1024, 16*1024, 16*1024, 32*1024, 16*1024
+};
+
+static constexpr u32 ViewSizes[VRAMView_Count] =
+{
+    512*1024, // ABG
+    128*1024, // BBG
+    256*1024, // AOBJ
+    128*1024, // BOBJ
+    32*1024,  // ABGExtPal
+    32*1024,  // BBGExtPal
+    8*1024,   // AOBJExtPal
+    8*1024,   // BOBJExtPal
+    512*1024, // Texture
+    128*1024, // TexPal
+};
+
+constexpr u32 AlignStorage(u32 size) noexcept
+{
+    return (size + StorageAlign - 1) & ~(StorageAlign - 1);
+}
+
+struct VRAMLayout
+{
+    u32 BankOffset[9];
+    u32 PrivateOffset[VRAMView_Count];
+    u32 ViewOffset[VRAMView_Count];
+    u32 StorageSize;
+    u32 ViewAreaSize;
+
+    constexpr VRAMLayout() noexcept : BankOffset(), PrivateOffset(), ViewOffset(), StorageSize(0), ViewAreaSize(0)
+    {
+        u32 offset = 0;
+        for (u32 i = 0; i < 9; i++)
+        {
+            BankOffset[i] = offset;
+            offset += AlignStorage(BankSizes[i]);
+        }
+        for (u32 i = 0; i < VRAMView_Count; i++)
+        {
+            PrivateOffset[i] = offset;
+            ViewOffset[i] = ViewAreaSize;
+            offset += AlignStorage(ViewSizes[i]);
+            ViewAreaSize += AlignStorage(ViewSizes[i]);
+        }
+        StorageSize = offset;
+    }
+};
+
+static constexpr VRAMLayout Layout {};
+
+VRAMMemory::VRAMMemory() noexcept
+{
+#ifdef VRAM_ALIASING_SUPPORTED
+    memset(SlotBank, -1, sizeof(SlotBank));
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize > 0)
+        PageSize = (u32)pageSize;
+
+    AliasingEnabled = InitAliasing();
+    if (AliasingEnabled)
+    {
+        for (u32 i = 0; i < 9; i++)
+            Banks[i] = MemoryBase + Layout.BankOffset[i];
+        for (u32 i = 0; i < VRAMView_Count; i++)
+            Views[i] = ViewBase + Layout.ViewOffset[i];
+
+        return;
+    }
+
+    Log(LogLevel::Warn, "VRAM: memory aliasing not available, using copies for all views\n");
+#endif
+
+    FallbackStorage = std::make_unique<u8[]>(Layout.StorageSize);
+    memset(FallbackStorage.get(), 0, Layout.StorageSize);
+
+    for (u32 i = 0; i < 9; i++)
+        Banks[i] = FallbackStorage.get() + Layout.BankOffset[i];
+    for (u32 i = 0; i < VRAMView_Count; i++)
+        Views[i] = FallbackStorage.get() + Layout.PrivateOffset[i];
+}
+
+VRAMMemory::~VRAMMemory() noexcept
+{
+#ifdef VRAM_ALIASING_SUPPORTED
+    if (ViewBase)
+    {
+        munmap(ViewBase, Layout.ViewAreaSize);
+        ViewBase = nullptr;
+    }
+    if (MemoryBase)
+    {
+        munmap(MemoryBase, Layout.StorageSize);
+        MemoryBase = nullptr;
+    }
+    if (MemoryFile >= 0)
+    {
+        close(MemoryFile);
+        MemoryFile = -1;
+    }
+#endif
+}
+
+void VRAMMemory::ResetViews() noexcept
+{
+#ifdef VRAM_ALIASING_SUPPORTED
+    if (AliasingEnabled)
+    {
+        for (u32 i = 0; i < VRAMView_Count; i++)
+        {
+            bool anyAliased = false;
+            for (u32 j = 0; j < 32; j++)
+            {
+                if (SlotBank[i][j] != -1)
+                {
+                    anyAliased = true;
+                    SlotBank[i][j] = -1;
+                }
+            }
+
+            if (anyAliased &&
+                mmap(Views[i], AlignStorage(ViewSizes[i]), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                    MemoryFile, Layout.PrivateOffset[i]) == MAP_FAILED)
+            {
+                Log(LogLevel::Error, "VRAM: failed to restore view %d (%s)\n", i, strerror(errno));
+            }
+        }
+    }
+#endif
+
+    for (u32 i = 0; i < VRAMView_Count; i++)
+        memset(Views[i], 0, ViewSizes[i]);
+}
+
+u32 VRAMMemory::UpdateAliases(u32 view, const u32* mappings, u32 granularity) noexcept
+{
+#ifdef VRAM_ALIASING_SUPPORTED
+    if (!AliasingEnabled || (granularity & (PageSize - 1)) != 0)
+        return 0;
+
+    // the 3D renderers read the texture views outside of the emulation thread
+    // (the threaded soft renderer until VCount 144), so they need to stay a
+    // snapshot taken at frame start instead of following bank writes live
+    if (view == VRAMView_Texture || view == VRAMView_TexPal)
+        return 0;
+
+    u32 numSlots = ViewSizes[view] / granularity;
+    u32 aliased = 0;
+    for (u32 i = 0; i < numSlots; i++)
+    {
+        u32 mask = mappings[i];
+        s8 bank = -1;
+
+        // overlapping banks are ORed together, only a single bank can be aliased
+        if (mask && (mask & (mask - 1)) == 0)
+        {
+            u32 num = __builtin_ctz(mask);
+            if (BankSizes[num] >= granularity)
+                bank = num;
+        }
+
+        if (bank != SlotBank[view][i])
+            MapSlot(view, i, granularity, bank);
+
+        if (SlotBank[view][i] != -1)
+            aliased |= 1 << i;
+    }
+
+    return aliased;
+#else
+    return 0;
+#endif
+}
+
+#ifdef VRAM_ALIASING_SUPPORTED
+bool VRAMMemory::InitAliasing() noexcept
+{
+    if (PageSize > StorageAlign)
+        return false;
+
+#if defined(__linux__)
+    MemoryFile = memfd_create("melondsvram", MFD_CLOEXEC);
+    if (MemoryFile == -1)
+    {
+        Log(LogLevel::Error, "VRAM: memfd_create failed (%s)\n", strerror(errno));
+        return false;
+    }
+#else
+    char name[snprintf(NULL, 0, "/melondsvram%d_%p", getpid(), (void*)this) + 1];
+    snprintf(name, sizeof(name), "/melondsvram%d_%p", getpid(), (void*)this);
+    MemoryFile = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (MemoryFile == -1)
+    {
+        Log(LogLevel::Error, "VRAM: shm_open failed (%s)\n", strerror(errno));
+        return false;
+    }
+    shm_unlink(name);
+#endif
+
+    if (ftruncate(MemoryFile, Layout.StorageSize) < 0)
+    {
+        Log(LogLevel::Error, "VRAM: ftruncate failed (%s)\n", strerror(errno));
+        close(MemoryFile);
+        MemoryFile = -1;
+        return false;
+    }
+
+    void* base = mmap(nullptr, Layout.StorageSize, PROT_READ | PROT_WRITE, MAP_SHARED, MemoryFile, 0);
+    void* views = mmap(nullptr, Layout.ViewAreaSize, PROT_NONE, MAP_ANON | MAP_PRIVATE, -1, 0);
+    if (base == MAP_FAILED || views == MAP_FAILED)
+    {
+        Log(LogLevel::Error, "VRAM: failed to reserve memory (%s)\n", strerror(errno));
+        if (base != MAP_FAILED) munmap(base, Layout.StorageSize);
+        if (views != MAP_FAILED) munmap(views, Layout.ViewAreaSize);
+        close(MemoryFile);
+        MemoryFile = -1;
+        return false;
+    }
+
+    MemoryBase = (u8*)base;
+    ViewBase = (u8*)views;
+
+    for (u32 i = 0; i < VRAMView_Count; i++)
+    {
+        if (mmap(ViewBase + Layout.ViewOffset[i], AlignStorage(ViewSizes[i]), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                MemoryFile, Layout.PrivateOffset[i]) == MAP_FAILED)
+        {
+            Log(LogLevel::Error, "VRAM: failed to map view %d (%s)\n", i, strerror(errno));
+            munmap(ViewBase, Layout.ViewAreaSize);
+            munmap(MemoryBase, Layout.StorageSize);
+            ViewBase = nullptr;
+            MemoryBase = nullptr;
+            close(MemoryFile);
+            MemoryFile = -1;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void VRAMMemory::MapSlot(u32 view, u32 slot, u32 granularity, s8 bank) noexcept
+{
+    u8* dst = ViewBase + Layout.ViewOffset[view] + slot * granularity;
+
+    if (bank != -1)
+    {
+        // aliased slots are read only, nothing is supposed to write through a view
+        u32 offset = Layout.BankOffset[bank] + ((slot * granularity) & (BankSizes[bank] - 1));
+        if (mmap(dst, granularity, PROT_READ, MAP_SHARED | MAP_FIXED, MemoryFile, offset) != MAP_FAILED)
+        {
+            SlotBank[view][slot] = bank;
+            return;
+        }
+
+        Log(LogLevel::Error, "VRAM: failed to alias view %d slot %d to bank %d (%s)\n", view, slot, bank, strerror(errno));
+    }
+
+    u32 offset = Layout.PrivateOffset[view] + slot * granularity;
+    if (mmap(dst, granularity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, MemoryFile, offset) == MAP_FAILED)
+        Log(LogLevel::Error, "VRAM: failed to map view %d slot %d (%s)\n", view, slot, strerror(errno));
+
+    SlotBank[view][slot] = -1;
+}
+#endif
+
+}
@@ -0,0 +1,107 @@
+/*
+    Copyright 2016-2025 melonDS team
+
+    This file is part of melonDS.
+
+    melonDS is free software: you can redistribute it and/or modify it under
+    the terms of the GNU General Public License as published by the Free
+    Software Foundation, either version 3 of the License, or (at your option)
+    any later version.
+
+    melonDS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with melonDS. If not, see http://www.gnu.org/licenses/.
+*/
+
+#ifndef GPU_VRAMMEMORY_H
+#define GPU_VRAMMEMORY_H
+
+#include <memory>
+
+#include "types.h"
+
+#if !defined(_WIN32) && !defined(__SWITCH__) && !defined(__ANDROID__)
+#define VRAM_ALIASING_SUPPORTED
+#endif
+
+namespace melonDS
+{
+
+enum
+{
+    VRAMView_ABG = 0,
+    VRAMView_BBG,
+    VRAMView_AOBJ,
+    VRAMView_BOBJ,
+    VRAMView_ABGExtPal,
+    VRAMView_BBGExtPal,
+    VRAMView_AOBJExtPal,
+    VRAMView_BOBJExtPal,
+    VRAMView_Texture,
+    VRAMView_TexPal,
+
+    VRAMView_Count
+};
+
+// Backing storage for the VRAM banks and the flat per-engine views of them
+// (VRAMFlat_*) the renderers read from.
+//
+// Where the host allows it, everything lives in one shared memory file.
+// Each view is its own reserved address range, and every mapping slot of it
+// is either mapped to the view's private storage (filled by CopyLinearVRAM,
+// like before) or, when exactly one bank is mapped there, directly to that
+// bank's storage. Aliased slots are always coherent and never need copying.
+//
+// Only the 2D engine views are ever aliased, they're read per scanline on the
+// emulation thread. The texture views are always private copies, as the 3D
+// renderers may read them from another thread while the banks change.
+//
+// When aliasing is unavailable every slot is private and all the copying
+// is done like before.
+class VRAMMemory
+{
+public:
+    VRAMMemory() noexcept;
+    ~VRAMMemory() noexcept;
+    VRAMMemory(const VRAMMemory&) = delete;
+    VRAMMemory(VRAMMemory&&) = delete;
+    VRAMMemory& operator=(const VRAMMemory&) = delete;
+    VRAMMemory& operator=(VRAMMemory&&) = delete;
+
+    [[nodiscard]] u8* GetBank(u32 num) const noexcept { return Banks[num]; }
+    [[nodiscard]] u8* GetView(u32 view) const noexcept { return Views[view]; }
+
+    [[nodiscard]] bool IsAliasingEnabled() const noexcept { return AliasingEnabled; }
+
+    // maps every slot of every view back to its private storage and clears it
+    void ResetViews() noexcept;
+
+    // updates the slots of the given view to match the current bank mappings
+    // returns a mask of the slots which are aliased to a bank
+    u32 UpdateAliases(u32 view, const u32* mappings, u32 granularity) noexcept;
+
+private:
+#ifdef VRAM_ALIASING_SUPPORTED
+    bool InitAliasing() noexcept;
+    void MapSlot(u32 view, u32 slot, u32 granularity, s8 bank) noexcept;
+
+    int MemoryFile = -1;
+    u8* MemoryBase = nullptr;
+    u8* ViewBase = nullptr;
+    s8 SlotBank[VRAMView_Count][32] {};
+#endif
+    std::unique_ptr<u8[]> FallbackStorage = nullptr;
+
+    bool AliasingEnabled = false;
+    u32 PageSize = 0x1000;
+
+    u8* Banks[9] {};
+    u8* Views[VRAMView_Count] {};
+};
+
+}
+
+#endif // GPU_VRAMMEMORY_H
@@ -24,8 +24,17 @@
 
 namespace melonDS
 {
+class ARM;
+
 typedef void (*JitBlockEntry)();
 
+// an instruction of a block run by the cached interpreter
+struct InterpretedInstr
+{
+    void (*Handler)(ARM* cpu);
+    u32 Cond;
+};
+
 class JitBlock
 {
 public:
@@ -46,6 +55,14 @@ public:
 
     JitBlockEntry EntryPoint;
 
+    // used instead of EntryPoint for blocks of the cached interpreter
+    // Pipeline holds the (already fetched) opcodes at the block's addresses
+    // plus the two following ones, as they'd be in NextInstr
+    TinyVector<InterpretedInstr> Instrs;
+    TinyVector<u32> Pipeline;
+    u32 InterpreterSlot;
+    bool Thumb;
+
     const u32* AddressRanges() const { return &Data[0]; }
     u32* AddressRanges() { return &Data[0]; }
     const u32* AddressMasks() const { return &Data[NumAddresses]; }
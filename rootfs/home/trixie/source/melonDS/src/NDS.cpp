@@ -104,6 +104,7 @@ NDS::NDS(NDSArgs&& args, int type, void* userdata) noexcept :
     NDSCartSlot(*this, nullptr),
     GBACartSlot(*this, nullptr),
     AREngine(*this),
+    ARM7Thread(*this),
     ARM9(*this, args.GDB, args.JIT.has_value()),
     ARM7(*this, args.GDB, args.JIT.has_value()),
 #ifdef GDBSTUB_ENABLED
@@ -217,6 +218,9 @@ void NDS::SetJITArgs(std::optional<JITArgs> args) noexcept
 {
     if (args)
     { // If we want to turn the JIT on...
+        if (!EnableJIT && EnableCachedInterpreter)
+            JIT.ResetBlockCache(); // the cached interpreter's blocks can't be run by the JIT
+
         JIT.SetJITArgs(*args);
     }
     else if (args.has_value() != EnableJIT)
@@ -226,6 +230,17 @@ void NDS::SetJITArgs(std::optional<JITArgs> args) noexcept
 
     EnableJIT = args.has_value();
 }
+
+void NDS::SetCachedInterpreter(bool enable) noexcept
+{
+    if (enable == EnableCachedInterpreter)
+        return;
+
+    if (!EnableJIT)
+        JIT.ResetBlockCache();
+
+    EnableCachedInterpreter = enable;
+}
 #endif
 
 #ifdef GDBSTUB_ENABLED
@@ -441,6 +456,7 @@ void NDS::Reset()
     // BIOS files are now loaded by the frontend
 
     JIT.Reset();
+    ARM7Thread.Reset();
 
     if (ConsoleType == 1)
     {
@@ -919,6 +935,36 @@ void NDS::RunSystemSleep(u64 timestamp)
     }
 }
 
+template <CPUExecuteMode cpuMode>
+void NDS::RunARM7(u64 target)
+{
+    while (ARM7Timestamp < target)
+    {
+        ARM7Target = target; // might be changed by a reschedule
+
+        if (CPUStop & CPUStop_DMA7)
+        {
+            DMAs[4].Run();
+            DMAs[5].Run();
+            DMAs[6].Run();
+            DMAs[7].Run();
+            if (ConsoleType == 1)
+            {
+                auto& dsi = dynamic_cast<melonDS::DSi&>(*this);
+                dsi.RunNDMAs(1);
+            }
+        }
+        else
+        {
+            ARM7.Execute<cpuMode>();
+        }
+
+        RunTimers(1);
+    }
+}
+
+template void NDS::RunARM7<CPUExecuteMode::Interpreter>(u64);
+
 template <CPUExecuteMode cpuMode>
 u32 NDS::RunFrame()
 {
@@ -980,6 +1026,10 @@ u32 NDS::RunFrame()
                 ARM9Target = target << ARM9ClockShift;
                 CurCPU = 0;
 
+                bool arm7detached = false;
+                if constexpr (cpuMode == CPUExecuteMode::Interpreter)
+                    arm7detached = ARM7Thread.Detach(target);
+
                 if (CPUStop & CPUStop_GXStall)
                 {
                     // GXFIFO stall
@@ -1010,29 +1060,10 @@ u32 NDS::RunFrame()
                 target = ARM9Timestamp >> ARM9ClockShift;
                 CurCPU = 1;
 
-                while (ARM7Timestamp < target)
-                {
-                    ARM7Target = target; // might be changed by a reschedule
-
-                    if (CPUStop & CPUStop_DMA7)
-                    {
-                        DMAs[4].Run();
-                        DMAs[5].Run();
-                        DMAs[6].Run();
-                        DMAs[7].Run();
-                        if (ConsoleType == 1)
-                        {
-                            auto& dsi = dynamic_cast<melonDS::DSi&>(*this);
-                            dsi.RunNDMAs(1);
-                        }
-                    }
-                    else
-                    {
-                        ARM7.Execute<cpuMode>();
-                    }
-
-                    RunTimers(1);
-                }
+                if (arm7detached)
+                    ARM7Thread.Join(target);
+                else
+                    RunARM7<cpuMode>(target);
 
                 RunSystem(target);
 
@@ -1083,6 +1114,11 @@ u32 NDS::RunFrame()
     {
         return RunFrame<CPUExecuteMode::InterpreterGDB>();
     } else
+#endif
+#ifdef JIT_ENABLED
+    if (EnableCachedInterpreter)
+        return RunFrame<CPUExecuteMode::CachedInterpreter>();
+    else
 #endif
     {
         return RunFrame<CPUExecuteMode::Interpreter>();
@@ -1353,6 +1389,8 @@ void NDS::SetGBASlotTimings()
 
 void NDS::UpdateIRQ(u32 cpu)
 {
+    if (cpu) ARM7Thread.Sync();
+
     ARM& arm = cpu ? (ARM&)ARM7 : (ARM&)ARM9;
 
     if (IME[cpu] & 0x1)
@@ -1369,6 +1407,8 @@ void NDS::UpdateIRQ(u32 cpu)
 
 void NDS::SetIRQ(u32 cpu, u32 irq)
 {
+    if (cpu) ARM7Thread.Sync();
+
     IF[cpu] |= (1 << irq);
     UpdateIRQ(cpu);
 
@@ -1385,18 +1425,24 @@ void NDS::SetIRQ(u32 cpu, u32 irq)
 
 void NDS::ClearIRQ(u32 cpu, u32 irq)
 {
+    if (cpu) ARM7Thread.Sync();
+
     IF[cpu] &= ~(1 << irq);
     UpdateIRQ(cpu);
 }
 
 void NDS::SetIRQ2(u32 irq)
 {
+    ARM7Thread.Sync();
+
     IF2 |= (1 << irq);
     UpdateIRQ(1);
 }
 
 void NDS::ClearIRQ2(u32 irq)
 {
+    ARM7Thread.Sync();
+
     IF2 &= ~(1 << irq);
     UpdateIRQ(1);
 }
@@ -1422,6 +1468,7 @@ void NDS::StopCPU(u32 cpu, u32 mask)
 {
     if (cpu)
     {
+        ARM7Thread.Sync();
         CPUStop |= (mask << 16);
         ARM7.Halt(2);
     }
@@ -1508,6 +1555,9 @@ void NDS::NocashPrint(u32 ncpu, u32 addr, bool appendNewline)
 {
     // addr: debug string
 
+    if (ncpu && ARM7.Detached)
+        ARM7Thread.Reattach();
+
     ARM* cpu = ncpu ? (ARM*)&ARM7 : (ARM*)&ARM9;
     u8 (NDS::*readfn)(u32) = ncpu ? &NDS::ARM7Read8 : &NDS::ARM9Read8;
 
@@ -1731,6 +1781,25 @@ void NDS::CheckDMAs(u32 cpu, u32 mode)
     DMAs[cpu+3].StartIfNeeded(mode);
 }
 
+bool NDS::StartBulkDMA(u32 cpu, u32 mode, u32 srcaddr, u32 count)
+{
+    // only if exactly one channel would be triggered
+    DMA* dma = nullptr;
+    cpu <<= 2;
+    for (u32 i = 0; i < 4; i++)
+    {
+        if (!DMAs[cpu+i].IsInMode(mode)) continue;
+        if (dma) return false;
+        dma = &DMAs[cpu+i];
+    }
+
+    if (!dma || !dma->CanRunBulk(srcaddr))
+        return false;
+
+    dma->StartBulk(count);
+    return true;
+}
+
 void NDS::StopDMAs(u32 cpu, u32 mode)
 {
     cpu <<= 2;
@@ -42,6 +42,7 @@
 #include "ARM.h"
 #include "CRC32.h"
 #include "DMA.h"
+#include "ARM7Thread.h"
 #include "FreeBIOS.h"
 
 // when touching the main loop/timing code, pls test a lot of shit
@@ -242,6 +243,7 @@ class NDS
 private:
 #ifdef JIT_ENABLED
     bool EnableJIT;
+    bool EnableCachedInterpreter = false;
 #endif
 #ifdef GDBSTUB_ENABLED
     bool EnableGDBStub = false;
@@ -323,6 +325,7 @@ public: // TODO: Encapsulate the rest of these members
     GBACart::GBACartSlot GBACartSlot;
     melonDS::GPU GPU;
     melonDS::AREngine AREngine;
+    melonDS::ARM7Thread ARM7Thread;
 
     const u32 ARM7WRAMSize = 0x10000;
     u8* ARM7WRAM;
@@ -446,9 +449,13 @@ public: // TODO: Encapsulate the rest of these members
     virtual bool DMAsRunning(u32 cpu) const;
     virtual void CheckDMAs(u32 cpu, u32 mode);
     virtual void StopDMAs(u32 cpu, u32 mode);
+    virtual bool StartBulkDMA(u32 cpu, u32 mode, u32 srcaddr, u32 count);
 
     void RunTimers(u32 cpu);
 
+    template <CPUExecuteMode cpuMode>
+    void RunARM7(u64 target);
+
     virtual u8 ARM9Read8(u32 addr);
     virtual u16 ARM9Read16(u32 addr);
     virtual u32 ARM9Read32(u32 addr);
@@ -484,9 +491,17 @@ public: // TODO: Encapsulate the rest of these members
 #ifdef JIT_ENABLED
     [[nodiscard]] bool IsJITEnabled() const noexcept { return EnableJIT; }
     void SetJITArgs(std::optional<JITArgs> args) noexcept;
+
+    /// Whether the interpreter keeps decoded blocks of code around
+    /// instead of fetching and decoding every instruction.
+    /// Uses the JIT's code tracking, only used while the JIT is disabled.
+    [[nodiscard]] bool IsCachedInterpreterEnabled() const noexcept { return EnableCachedInterpreter; }
+    void SetCachedInterpreter(bool enable) noexcept;
 #else
     [[nodiscard]] bool IsJITEnabled() const noexcept { return false; }
     void SetJITArgs(std::optional<JITArgs> args) noexcept {}
+    [[nodiscard]] bool IsCachedInterpreterEnabled() const noexcept { return false; }
+    void SetCachedInterpreter(bool enable) noexcept {}
 #endif
 
 #ifdef GDBSTUB_ENABLED
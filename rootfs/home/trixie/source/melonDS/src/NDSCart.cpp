@@ -1486,6 +1486,17 @@ void NDSCartSlot::DoSavestate(Savestate* file) noexcept
     file->Var32(&TransferDir);
     file->VarArray(TransferCmd.data(), sizeof(TransferCmd));
 
+    if (file->IsAtLeastVersion(13, 1))
+    {
+        file->Bool32(&BulkTransfer);
+        file->Var32(&BulkDelay);
+    }
+    else
+    {
+        BulkTransfer = false;
+        BulkDelay = 0;
+    }
+
     // cart inserted/len/ROM/etc should be already populated
     // savestate should be loaded after the right game is loaded
     // (TODO: system to verify that indeed the right ROM is loaded)
@@ -1799,6 +1810,8 @@ void NDSCartSlot::ResetCart() noexcept
     TransferDir = 0;
     memset(TransferCmd.data(), 0, sizeof(TransferCmd));
     TransferCmd[0] = 0xFF;
+    BulkTransfer = false;
+    BulkDelay = 0;
 
     if (Cart) Cart->Reset();
 }
@@ -1829,12 +1842,34 @@ void NDSCartSlot::ROMPrepareData(u32 param) noexcept
 
     ROMCnt |= (1<<23);
 
+    if (TransferPos == 4 && StartBulkTransfer())
+        return;
+
     if (NDS.ExMemCnt[0] & (1<<11))
         NDS.CheckDMAs(1, 0x12);
     else
         NDS.CheckDMAs(0, 0x05);
 }
 
+// if the first word of a read is picked up by a DMA which fetches one word
+// per trigger, let that DMA fetch the whole block in one go
+// the data is already all there, only the timing of the words is skipped
+// the accumulated delay is applied to the end of the transfer instead
+bool NDSCartSlot::StartBulkTransfer() noexcept
+{
+    if (!BulkTransferEnabled) return false;
+    if (TransferDir != 0) return false;
+    if (TransferLen <= 4) return false;
+
+    bool arm7 = NDS.ExMemCnt[0] & (1<<11);
+    if (!NDS.StartBulkDMA(arm7 ? 1 : 0, arm7 ? 0x12 : 0x05, 0x04100010, TransferLen >> 2))
+        return false;
+
+    BulkTransfer = true;
+    BulkDelay = 0;
+    return true;
+}
+
 void NDSCartSlot::WriteROMCnt(u32 val) noexcept
 {
     u32 xferstart = (val & ~ROMCnt) & (1<<31);
@@ -1876,6 +1911,8 @@ void NDSCartSlot::WriteROMCnt(u32 val) noexcept
 
     TransferPos = 0;
     TransferLen = datasize;
+    BulkTransfer = false;
+    BulkDelay = 0;
 
     *(u32*)&TransferCmd[0] = *(u32*)&ROMCommand[0];
     *(u32*)&TransferCmd[4] = *(u32*)&ROMCommand[4];
@@ -1938,8 +1975,23 @@ void NDSCartSlot::AdvanceROMTransfer() noexcept
                 delay += ((ROMCnt >> 16) & 0x3F);
         }
 
+        if (BulkTransfer)
+        {
+            // the DMA is reading all the words back to back
+            BulkDelay += xfercycle*delay;
+            ROMData = *(u32*)&TransferData[TransferPos];
+            TransferPos += 4;
+            ROMCnt |= (1<<23);
+            return;
+        }
+
         NDS.ScheduleEvent(Event_ROMTransfer, false, xfercycle*delay, ROMTransfer_PrepareData, 0);
     }
+    else if (BulkTransfer)
+    {
+        BulkTransfer = false;
+        NDS.ScheduleEvent(Event_ROMTransfer, false, BulkDelay, ROMTransfer_End, 0);
+    }
     else
         ROMEndTransfer(0);
 }
@@ -1948,12 +2000,14 @@ u32 NDSCartSlot::ReadROMData() noexcept
 {
     if (ROMCnt & (1<<30)) return 0;
 
+    u32 ret = ROMData;
+
     if (ROMCnt & (1<<23))
     {
         AdvanceROMTransfer();
     }
 
-    return ROMData;
+    return ret;
 }
 
 void NDSCartSlot::WriteROMData(u32 val) noexcept
@@ -417,6 +417,12 @@ public:
     [[nodiscard]] u32 GetROMCnt() const noexcept { return ROMCnt; }
     [[nodiscard]] u16 GetSPICnt() const noexcept { return SPICnt; }
     void SetSPICnt(u16 val) noexcept { SPICnt = val; }
+
+    /// Enables or disables running DMA-driven ROM reads as one burst per transfer,
+    /// instead of triggering the DMA once for every word.
+    /// Can be turned off for games that are sensitive to the exact timing.
+    void SetBulkROMTransfer(bool enable) noexcept { BulkTransferEnabled = enable; }
+    [[nodiscard]] bool GetBulkROMTransfer() const noexcept { return BulkTransferEnabled; }
 private:
     friend class CartCommon;
     melonDS::NDS& NDS;
@@ -435,6 +441,10 @@ private:
     u32 TransferDir = 0;
     std::array<u8, 8> TransferCmd {};
 
+    bool BulkTransferEnabled = true;
+    bool BulkTransfer = false;
+    u32 BulkDelay = 0;
+
     std::unique_ptr<CartCommon> Cart = nullptr;
 
     std::array<u32, 0x412> Key1_KeyBuf {};
@@ -450,6 +460,7 @@ private:
     void Key2_Encrypt(const u8* data, u32 len) noexcept;
     void ROMEndTransfer(u32 param) noexcept;
     void ROMPrepareData(u32 param) noexcept;
+    bool StartBulkTransfer() noexcept;
     void AdvanceROMTransfer() noexcept;
     void SPITransferDone(u32 param) noexcept;
 };
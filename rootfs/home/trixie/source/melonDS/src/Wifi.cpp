@@ -111,6 +111,10 @@ void Wifi::Reset()
     Enabled = false;
     PowerOn = false;
 
+    TimerTicks = 1;
+    TimerBase = 0;
+    TimerBaseError = 0;
+
     Random = 1;
 
     memset(BBRegs, 0, 0x100);
@@ -259,6 +263,19 @@ void Wifi::DoSavestate(Savestate* file)
 
     file->Var32((u32*)&TimerError);
 
+    if (file->IsAtLeastVersion(13, 2))
+    {
+        file->Var32(&TimerTicks);
+        file->Var64(&TimerBase);
+        file->Var32((u32*)&TimerBaseError);
+    }
+    else
+    {
+        TimerTicks = 1;
+        TimerBase = 0;
+        TimerBaseError = 0;
+    }
+
     file->VarArray(BBRegs, 0x100);
     file->VarArray(BBRegsRO, 0x100);
 
@@ -320,12 +337,116 @@ void Wifi::ScheduleTimer(bool first)
 {
     if (first) TimerError = 0;
 
-    s32 cycles = 33513982 * kTimerInterval;
+    ScheduleTicks(first ? 1 : IdleTicks(), !first);
+}
+
+void Wifi::ScheduleTicks(u32 ticks, bool periodic)
+{
+    TimerTicks = ticks;
+    TimerBaseError = TimerError;
+
+    s64 cycles = (s64)33513982 * kTimerInterval * ticks;
     cycles -= TimerError;
-    s32 delay = (cycles + 999999) / 1000000;
-    TimerError = (delay * 1000000) - cycles;
+    s32 delay = (s32)((cycles + 999999) / 1000000);
+    TimerError = (s32)(((s64)delay * 1000000) - cycles);
 
-    NDS.ScheduleEvent(Event_Wifi, !first, delay, 0, 0);
+    NDS.ScheduleEvent(Event_Wifi, periodic, delay, 0, 0);
+    TimerBase = NDS.SchedList[Event_Wifi].Timestamp - delay;
+}
+
+// returns how many ticks can go by before the next one that does
+// anything besides counting (millisecond timers, pre-beacon IRQ,
+// polling for received frames)
+// the ticks in between are only counted, see SkipTicks()
+u32 Wifi::IdleTicks() const
+{
+    if (IsMPClient || USUntilPowerOn || ComStatus || IOPORT(W_TXBusy))
+        return 1;
+
+    const u32 msmask = 0x3FF & kTimeCheckMask;
+
+    u32 ticks = (0x400 - (USTimestamp & msmask)) / kTimerInterval;
+
+    if (IOPORT(W_USCountCnt))
+    {
+        u32 mstick = (0x400 - (USCounter & msmask)) / kTimerInterval;
+        if (mstick < ticks) ticks = mstick;
+
+        if (IOPORT(W_USCompareCnt))
+        {
+            u32 target = (0x3FF - (IOPORT(W_PreBeacon) & 0x3FF)) & msmask;
+            u32 pbtick = ((target - (USCounter & msmask)) & 0x3FF) / kTimerInterval;
+            if (pbtick && pbtick < ticks) ticks = pbtick;
+        }
+    }
+
+    // same checks as CheckRX() does before polling
+    if ((!(IOPORT(W_PowerState) & (1<<9))) &&
+        (IOPORT(W_RXCnt) & 0x8000) &&
+        (IOPORT(W_RXBufBegin) != IOPORT(W_RXBufEnd)))
+    {
+        u32 rxtick = (((0x200 - (RXCounter & 0x1FF & kTimeCheckMask)) & 0x1FF) / kTimerInterval) + 1;
+        if (rxtick < ticks) ticks = rxtick;
+    }
+
+    return ticks;
+}
+
+// does what the given amount of idle ticks would have done
+void Wifi::SkipTicks(u32 num)
+{
+    u32 us = num * kTimerInterval;
+
+    USTimestamp += us;
+
+    if (IOPORT(W_USCountCnt))
+        USCounter += us;
+
+    if (IOPORT(W_CmdCountCnt) & 0x0001)
+        CmdCounter = (CmdCounter > us) ? (CmdCounter - us) : 0;
+
+    if (IOPORT(W_ContentFree) > us)
+        IOPORT(W_ContentFree) -= us;
+    else
+        IOPORT(W_ContentFree) = 0;
+
+    RXCounter += us;
+}
+
+// runs the ticks that would have happened by now within the current
+// timer event, so that the counters read back correctly
+void Wifi::SyncTimer()
+{
+    if (TimerTicks <= 1) return;
+
+    u64 now = NDS.ARM7Timestamp;
+    if (now <= TimerBase) return;
+
+    const u64 tickcycles = (u64)33513982 * kTimerInterval;
+    u64 num = (((now - TimerBase) * 1000000) + TimerBaseError) / tickcycles;
+    if (num >= TimerTicks) num = TimerTicks - 1;
+    if (num == 0) return;
+
+    SkipTicks((u32)num);
+
+    s64 cycles = (s64)(num * tickcycles) - TimerBaseError;
+    s64 delay = (cycles + 999999) / 1000000;
+    TimerBase += delay;
+    TimerBaseError = (s32)((delay * 1000000) - cycles);
+    TimerTicks -= (u32)num;
+}
+
+// goes back to running every tick, for when the state the current
+// timer event was computed from is about to change
+void Wifi::RestartTimer()
+{
+    SyncTimer();
+    if (TimerTicks <= 1) return;
+
+    NDS.CancelEvent(Event_Wifi);
+    NDS.SchedList[Event_Wifi].Timestamp = TimerBase;
+    TimerError = TimerBaseError;
+    ScheduleTicks(1, true);
 }
 
 void Wifi::UpdatePowerOn()
@@ -361,6 +482,7 @@ void Wifi::UpdatePowerOn()
         Log(LogLevel::Debug, "WIFI: OFF\n");
 
         NDS.CancelEvent(Event_Wifi);
+        TimerTicks = 1;
 
         Platform::MP_End(NDS.UserData);
     }
@@ -1752,6 +1874,9 @@ void Wifi::MSTimer()
 
 void Wifi::USTimer(u32 param)
 {
+    if (TimerTicks > 1)
+        SkipTicks(TimerTicks - 1);
+
     USTimestamp += kTimerInterval;
 
     if (IsMPClient && (!ComStatus))
@@ -2011,6 +2136,8 @@ u16 Wifi::Read(u32 addr)
     if (addr >= 0x2000 && addr < 0x4000)
         return 0xFFFF;
 
+    SyncTimer();
+
     bool activeread = (addr < 0x1000);
 
     switch (addr)
@@ -2115,6 +2242,8 @@ void Wifi::Write(u32 addr, u16 val)
     if (addr >= 0x2000 && addr < 0x4000)
         return;
 
+    RestartTimer();
+
     switch (addr)
     {
     case W_ModeReset:
@@ -190,6 +190,12 @@ private:
 
     s32 TimerError;
 
+    // when the radio is idle, one timer event can cover several ticks
+    // the skipped ones are caught up on register access (see SyncTimer())
+    u32 TimerTicks;
+    u64 TimerBase;          // timestamp of the last tick that was run
+    s32 TimerBaseError;     // TimerError at that tick
+
     u16 Random;
 
     // general, always-on microsecond counter
@@ -252,6 +258,11 @@ private:
     class WifiAP* WifiAP;
 
     void ScheduleTimer(bool first);
+    void ScheduleTicks(u32 ticks, bool periodic);
+    u32 IdleTicks() const;
+    void SkipTicks(u32 num);
+    void SyncTimer();
+    void RestartTimer();
     void UpdatePowerOn();
 
     void CheckIRQ(u16 oldflags);
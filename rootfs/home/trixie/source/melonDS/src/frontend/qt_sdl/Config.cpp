@@ -72,6 +72,7 @@ DefaultList<int> DefaultInts =
     {"Instance*.Gdb.ARM9.Port", 3333},
 #endif
     {"LAN.HostNumPlayers", 16},
+    {"Emu.ThreadedARM7MaxSkew", 2048},
 };
 
 RangeList IntRanges =
@@ -91,6 +92,7 @@ RangeList IntRanges =
     {"Instance*.Window*.ScreenAspectBot", {0, AspectRatiosNum-1}},
     {"MP.AudioMode", {0, 2}},
     {"LAN.HostNumPlayers", {2, 16}},
+    {"Emu.ThreadedARM7MaxSkew", {64, 65536}},
 };
 
 DefaultList<bool> DefaultBools =
@@ -101,6 +103,7 @@ DefaultList<bool> DefaultBools =
     {"LimitFPS", true},
     {"Instance*.Window*.ShowOSD", true},
     {"Emu.DirectBoot", true},
+    {"Emu.BulkCartTransfer", true},
     {"Instance*.DS.Battery.LevelOkay", true},
     {"Instance*.DSi.Battery.Charging", true},
 #ifdef JIT_ENABLED
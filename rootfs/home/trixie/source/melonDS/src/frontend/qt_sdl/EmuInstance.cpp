@@ -843,7 +843,7 @@ void EmuInstance::undoStateLoad()
 void EmuInstance::unloadCheats()
 {
     cheatFile = nullptr; // cleaned up by unique_ptr
-    nds->AREngine.Cheats.clear();
+    nds->AREngine.ClearCheats();
 }
 
 void EmuInstance::loadCheats()
@@ -857,11 +857,11 @@ void EmuInstance::loadCheats()
 
     if (cheatsOn)
     {
-        nds->AREngine.Cheats = cheatFile->GetCodes();
+        nds->AREngine.SetCheats(cheatFile->GetCodes());
     }
     else
     {
-        nds->AREngine.Cheats.clear();
+        nds->AREngine.ClearCheats();
     }
 }
 
@@ -1180,9 +1180,9 @@ void EmuInstance::enableCheats(bool enable)
 {
     cheatsOn = enable;
     if (cheatsOn && cheatFile)
-        nds->AREngine.Cheats = cheatFile->GetCodes();
+        nds->AREngine.SetCheats(cheatFile->GetCodes());
     else
-        nds->AREngine.Cheats.clear();
+        nds->AREngine.ClearCheats();
 }
 
 ARCodeFile* EmuInstance::getCheatFile()
@@ -1399,8 +1399,15 @@ bool EmuInstance::updateConsole() noexcept
         }
     }
 
+#ifdef JIT_ENABLED
+    nds->SetCachedInterpreter(globalCfg.GetBool("JIT.CachedInterpreter"));
+#endif
+
     // loads the carts later -- to be sure that everything else is initialized
     nds->SetNDSCart(std::move(nextndscart));
+    nds->NDSCartSlot.SetBulkROMTransfer(globalCfg.GetBool("Emu.BulkCartTransfer"));
+    nds->ARM7Thread.SetMaxSkew(globalCfg.GetInt("Emu.ThreadedARM7MaxSkew"));
+    nds->ARM7Thread.SetEnabled(globalCfg.GetBool("Emu.ThreadedARM7"));
     if (consoleType == 1)
         nds->EjectGBACart();
     else
@@ -56,6 +56,10 @@
 
 #include "EmuInstance.h"
 
+#ifdef MELONDS_PERF_TELEMETRY
+#include "perf_telemetry.h"
+#endif
+
 using namespace melonDS;
 
 
@@ -148,6 +152,15 @@ void EmuThread::run()
 
     bool fastforward = false;
     bool slowmo = false;
+
+#ifdef MELONDS_PERF_TELEMETRY
+    // frame times (emulation and presentation, without the audio sync and
+    // frame limiter waits) and the CPU usage of this thread, for perf-hud
+    PerfTelemetryBus* perfBus = perf_telemetry_open();
+    PerfTelemetryChannel* perfFrameTime = perf_telemetry_channel(perfBus, "melonds.frame", PERF_KIND_DURATION);
+    perf_telemetry_register_thread(perfBus, "melonds.emu");
+#endif
+
     emuInstance->fastForwardToggled = false;
     emuInstance->slowmoToggled = false;
 
@@ -298,6 +311,9 @@ void EmuThread::run()
 
 
             // emulate
+#ifdef MELONDS_PERF_TELEMETRY
+            u64 perfFrameStart = perf_telemetry_now_us();
+#endif
             u32 nlines;
             if (emuInstance->nds->GPU.GetRenderer3D().NeedsShaderCompile())
             {
@@ -381,6 +397,10 @@ void EmuThread::run()
                 emuInstance->audioVolume = volumeLevel * (256.0 / 31.0);
             }
 
+#ifdef MELONDS_PERF_TELEMETRY
+            perf_telemetry_record(perfFrameTime, perf_telemetry_now_us() - perfFrameStart);
+#endif
+
             if (emuInstance->doAudioSync && !(fastforward || slowmo))
                 emuInstance->audioSync();
 
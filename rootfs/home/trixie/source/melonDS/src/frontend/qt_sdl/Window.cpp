@@ -1761,6 +1761,8 @@ void MainWindow::onSetupCheats()
 
 void MainWindow::onCheatsDialogFinished(int res)
 {
+    // recompile the codes, they may have been edited
+    emuThread->enableCheats(localCfg.GetBool("EnableCheats"));
     emuThread->emuUnpause();
 }
 
@@ -0,0 +1,404 @@
+// perf-hud: shows the performance telemetry published on the shared bus
+// (see shared/perf_telemetry.h) on the bottom screen.
+//
+// Usage: perf-hud [-g WxH+X+Y] [-r refresh_hz]
+//
+// By default the HUD is a strip along the top of the bottom screen, which
+// sits below the top screen in the X screen's stacked layout.
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+#include <cairo/cairo.h>
+#include <cairo/cairo-xlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <string>
+#include "perf_telemetry.h"
+
+const int HISTORY_LEN = 60;
+const int ROW_HEIGHT = 18;
+const double FRAME_BUDGET_MS = 1000.0 / 60.0;
+
+// Per-channel view state, kept between two reads of the bus
+struct ChannelView {
+    bool active = false;
+    uint32_t kind = PERF_KIND_FREE;
+    int32_t pid = 0;
+    std::string name;
+
+    uint64_t prev_count = 0;
+    uint64_t prev_sum = 0;
+    uint64_t prev_buckets[PERF_TELEMETRY_HIST_BUCKETS] = {};
+    uint64_t prev_cpu_ticks = 0;
+    bool has_prev = false;
+
+    // Values shown for the last interval
+    double value = 0.0;      // avg ms, gauge level, events/s or CPU %
+    double p95 = 0.0;        // Duration channels: 95th percentile in ms
+    double max = 0.0;        // Duration channels: max in ms
+    double rate = 0.0;       // Duration channels: samples/s
+
+    double history[HISTORY_LEN] = {};
+    int history_pos = 0;
+};
+
+// Globals
+Display* dis;
+int screen;
+Window win;
+int win_x, win_y;
+unsigned int win_w, win_h;
+PerfTelemetryBus* bus = nullptr;
+ChannelView views[PERF_TELEMETRY_MAX_CHANNELS];
+long clock_ticks_per_sec = 100;
+
+int x_error_handler(Display* display, XErrorEvent* error) {
+    char msg[80];
+    XGetErrorText(display, error->error_code, msg, sizeof(msg));
+    fprintf(stderr, "X Error: %s\n", msg);
+    return 0;
+}
+
+void create_window(const char* geometry) {
+    dis = XOpenDisplay(NULL);
+    if (!dis) {
+        fprintf(stderr, "Cannot open display\n");
+        exit(1);
+    }
+    screen = DefaultScreen(dis);
+    int screen_width = DisplayWidth(dis, screen);
+    int screen_height = DisplayHeight(dis, screen);
+
+    // Default: full width strip at the top of the bottom screen
+    win_x = 0;
+    win_y = screen_height / 2;
+    win_w = screen_width;
+    win_h = 160;
+    if (geometry) {
+        XParseGeometry(geometry, &win_x, &win_y, &win_w, &win_h);
+    }
+
+    XSetWindowAttributes attrs;
+    attrs.override_redirect = True;
+    attrs.background_pixel = BlackPixel(dis, screen);
+
+    win = XCreateWindow(dis, RootWindow(dis, screen),
+                        win_x, win_y, win_w, win_h,
+                        0, CopyFromParent, InputOutput, CopyFromParent,
+                        CWOverrideRedirect | CWBackPixel, &attrs);
+
+    XStoreName(dis, win, "perf-hud");
+    XClassHint *ch = XAllocClassHint();
+    if (ch) {
+        ch->res_name = (char*)"perf-hud";
+        ch->res_class = (char*)"Perf-HUD";
+        XSetClassHint(dis, win, ch);
+        XFree(ch);
+    }
+
+    Atom type = XInternAtom(dis, "_NET_WM_WINDOW_TYPE", False);
+    Atom value = XInternAtom(dis, "_NET_WM_WINDOW_TYPE_DOCK", False);
+    XChangeProperty(dis, win, type, XA_ATOM, 32, PropModeReplace, (unsigned char*)&value, 1);
+
+    XSelectInput(dis, win, ExposureMask);
+
+    XMapWindow(dis, win);
+    XFlush(dis);
+}
+
+bool is_process_alive(int32_t pid) {
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+// Returns the user + system CPU time of a thread in clock ticks
+bool read_thread_cpu_ticks(int32_t pid, int32_t tid, uint64_t* ticks) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", pid, tid);
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+
+    char buf[512];
+    size_t len = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[len] = '\0';
+
+    // The thread name can contain spaces, so start after its closing paren
+    const char* p = strrchr(buf, ')');
+    if (!p) return false;
+
+    // Fields after the name: state (3) ... utime (14), stime (15)
+    unsigned long long utime = 0, stime = 0;
+    if (sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+               &utime, &stime) != 2) {
+        return false;
+    }
+    *ticks = utime + stime;
+    return true;
+}
+
+void push_history(ChannelView& view, double value) {
+    view.history[view.history_pos] = value;
+    view.history_pos = (view.history_pos + 1) % HISTORY_LEN;
+}
+
+// Upper bound in ms of the bucket holding the given percentile of the
+// samples recorded since the last read
+double percentile_ms(const uint64_t* deltas, uint64_t total, double percentile) {
+    const uint64_t target = (uint64_t)(total * percentile);
+    uint64_t seen = 0;
+    for (int i = 0; i < PERF_TELEMETRY_HIST_BUCKETS; ++i) {
+        seen += deltas[i];
+        if (seen > target) {
+            return (i == 0 ? 0.0 : (double)(1ull << i)) / 1000.0;
+        }
+    }
+    return (double)(1ull << (PERF_TELEMETRY_HIST_BUCKETS - 1)) / 1000.0;
+}
+
+void sample(double elapsed_s) {
+    for (int i = 0; i < PERF_TELEMETRY_MAX_CHANNELS; ++i) {
+        PerfTelemetryChannel* ch = &bus->channels[i];
+        ChannelView& view = views[i];
+
+        const uint32_t kind = __atomic_load_n(&ch->kind, __ATOMIC_ACQUIRE);
+        const int32_t pid = PERF_TELEMETRY_LOAD(&ch->pid);
+        if (kind < PERF_KIND_DURATION || !is_process_alive(pid)) {
+            view.active = false;
+            continue;
+        }
+
+        // Start over if the slot was taken over by another producer
+        char name[PERF_TELEMETRY_NAME_LEN];
+        memcpy(name, ch->name, sizeof(name));
+        name[PERF_TELEMETRY_NAME_LEN - 1] = '\0';
+        if (!view.active || view.kind != kind || view.pid != pid || view.name != name) {
+            view = ChannelView();
+            view.active = true;
+            view.kind = kind;
+            view.pid = pid;
+            view.name = name;
+        }
+
+        const uint64_t count = PERF_TELEMETRY_LOAD(&ch->count);
+        const uint64_t delta_count = count - view.prev_count;
+
+        switch (kind) {
+            case PERF_KIND_DURATION: {
+                const uint64_t sum = PERF_TELEMETRY_LOAD(&ch->sum);
+                uint64_t deltas[PERF_TELEMETRY_HIST_BUCKETS];
+                for (int b = 0; b < PERF_TELEMETRY_HIST_BUCKETS; ++b) {
+                    const uint64_t n = PERF_TELEMETRY_LOAD(&ch->buckets[b]);
+                    deltas[b] = n - view.prev_buckets[b];
+                    view.prev_buckets[b] = n;
+                }
+                const uint64_t max_us = __atomic_exchange_n(&ch->max, 0, __ATOMIC_RELAXED);
+
+                if (view.has_prev && delta_count > 0) {
+                    view.value = (double)(sum - view.prev_sum) / delta_count / 1000.0;
+                    view.p95 = percentile_ms(deltas, delta_count, 0.95);
+                    view.max = max_us / 1000.0;
+                    view.rate = delta_count / elapsed_s;
+                } else if (view.has_prev) {
+                    view.value = view.p95 = view.max = view.rate = 0.0;
+                }
+                view.prev_sum = sum;
+                break;
+            }
+            case PERF_KIND_GAUGE:
+                view.value = (double)PERF_TELEMETRY_LOAD(&ch->last);
+                break;
+            case PERF_KIND_COUNTER:
+                if (view.has_prev) {
+                    view.value = delta_count / elapsed_s;
+                }
+                break;
+            case PERF_KIND_THREAD: {
+                uint64_t ticks = 0;
+                if (!read_thread_cpu_ticks(pid, PERF_TELEMETRY_LOAD(&ch->tid), &ticks)) {
+                    view.active = false;
+                    continue;
+                }
+                if (view.has_prev) {
+                    view.value = 100.0 * (ticks - view.prev_cpu_ticks) /
+                                 clock_ticks_per_sec / elapsed_s;
+                }
+                view.prev_cpu_ticks = ticks;
+                break;
+            }
+        }
+
+        if (view.has_prev) {
+            push_history(view, view.value);
+        }
+        view.prev_count = count;
+        view.has_prev = true;
+    }
+}
+
+void draw_sparkline(cairo_t* cr, const ChannelView& view, double x, double y,
+                    double w, double h, double scale) {
+    cairo_set_source_rgb(cr, 0.15, 0.15, 0.15);
+    cairo_rectangle(cr, x, y, w, h);
+    cairo_fill(cr);
+
+    // Frame budget reference line
+    if (view.kind == PERF_KIND_DURATION && FRAME_BUDGET_MS < scale) {
+        const double ly = y + h - h * FRAME_BUDGET_MS / scale;
+        cairo_set_source_rgba(cr, 1, 1, 1, 0.3);
+        cairo_move_to(cr, x, ly);
+        cairo_line_to(cr, x + w, ly);
+        cairo_stroke(cr);
+    }
+
+    cairo_set_source_rgb(cr, 0.3, 0.8, 1.0);
+    for (int i = 0; i < HISTORY_LEN; ++i) {
+        const double v = view.history[(view.history_pos + i) % HISTORY_LEN];
+        const double px = x + w * i / (HISTORY_LEN - 1);
+        const double py = y + h - h * (v < scale ? v : scale) / scale;
+        if (i == 0) {
+            cairo_move_to(cr, px, py);
+        } else {
+            cairo_line_to(cr, px, py);
+        }
+    }
+    cairo_stroke(cr);
+}
+
+void render() {
+    cairo_surface_t *surface = cairo_xlib_surface_create(dis, win, DefaultVisual(dis, screen), win_w, win_h);
+    cairo_t *cr = cairo_create(surface);
+
+    // Double buffering: Push a group to draw offscreen first
+    cairo_push_group(cr);
+
+    cairo_set_source_rgb(cr, 0.05, 0.05, 0.05);
+    cairo_paint(cr);
+
+    cairo_select_font_face(cr, "Monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, 12);
+    cairo_set_line_width(cr, 1.0);
+
+    const double text_w = 360;
+    const double graph_x = text_w + 8;
+    const double graph_w = win_w > graph_x + 8 ? win_w - graph_x - 8 : 0;
+
+    int row = 0;
+    for (int i = 0; i < PERF_TELEMETRY_MAX_CHANNELS; ++i) {
+        const ChannelView& view = views[i];
+        if (!view.active) continue;
+
+        const double y = 4 + row * ROW_HEIGHT;
+        if (y + ROW_HEIGHT > win_h) break;
+
+        char text[128];
+        double scale = 100.0;
+        switch (view.kind) {
+            case PERF_KIND_DURATION: {
+                snprintf(text, sizeof(text), "%-20s %6.2f ms p95 %5.1f max %5.1f %4.0f/s",
+                         view.name.c_str(), view.value, view.p95, view.max, view.rate);
+                scale = FRAME_BUDGET_MS * 2;
+                for (int h = 0; h < HISTORY_LEN; ++h) {
+                    if (view.history[h] > scale) scale = view.history[h];
+                }
+                break;
+            }
+            case PERF_KIND_GAUGE:
+                snprintf(text, sizeof(text), "%-20s %6.0f %%", view.name.c_str(), view.value);
+                break;
+            case PERF_KIND_COUNTER:
+                snprintf(text, sizeof(text), "%-20s %6.1f /s", view.name.c_str(), view.value);
+                scale = 1.0;
+                for (int h = 0; h < HISTORY_LEN; ++h) {
+                    if (view.history[h] > scale) scale = view.history[h];
+                }
+                break;
+            case PERF_KIND_THREAD:
+                snprintf(text, sizeof(text), "%-20s %6.1f %% cpu", view.name.c_str(), view.value);
+                break;
+        }
+
+        cairo_set_source_rgb(cr, 1, 1, 1);
+        cairo_move_to(cr, 6, y + ROW_HEIGHT - 5);
+        cairo_show_text(cr, text);
+
+        if (graph_w > 0) {
+            draw_sparkline(cr, view, graph_x, y + 2, graph_w, ROW_HEIGHT - 4, scale);
+        }
+        ++row;
+    }
+
+    if (row == 0) {
+        cairo_set_source_rgb(cr, 0.6, 0.6, 0.6);
+        cairo_move_to(cr, 6, 4 + ROW_HEIGHT - 5);
+        cairo_show_text(cr, bus ? "No telemetry producers running" : "Telemetry bus unavailable");
+    }
+
+    // Flush group to surface
+    cairo_pop_group_to_source(cr);
+    cairo_paint(cr);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+}
+
+double now_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    const char* geometry = nullptr;
+    double refresh_hz = 4.0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "g:r:")) != -1) {
+        switch (opt) {
+            case 'g': geometry = optarg; break;
+            case 'r': refresh_hz = atof(optarg); break;
+            default:
+                fprintf(stderr, "Usage: %s [-g WxH+X+Y] [-r refresh_hz]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (refresh_hz <= 0.0) refresh_hz = 4.0;
+
+    XSetErrorHandler(x_error_handler);
+
+    clock_ticks_per_sec = sysconf(_SC_CLK_TCK);
+    bus = perf_telemetry_open();
+    if (!bus) {
+        fprintf(stderr, "Cannot open the telemetry bus %s\n", PERF_TELEMETRY_SHM_NAME);
+    }
+
+    create_window(geometry);
+
+    double last_sample = now_seconds();
+    XEvent event;
+    while (1) {
+        if (XPending(dis) > 0) {
+            XNextEvent(dis, &event);
+            if (event.type == Expose && event.xexpose.count == 0) {
+                render();
+            }
+            continue;
+        }
+
+        const double now = now_seconds();
+        if (now - last_sample >= 1.0 / refresh_hz) {
+            if (bus) {
+                sample(now - last_sample);
+            }
+            last_sample = now;
+            render();
+        }
+        usleep(20000);
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+#ifndef PERF_TELEMETRY_H
+#define PERF_TELEMETRY_H
+
+// Performance telemetry bus shared by all components (dosbox-staging,
+// melonDS, glide3x-native, touch-scroll) and read by perf-hud.
+//
+// The bus is a small named shared-memory segment holding a fixed table of
+// channels. Producers claim a channel once by name, then update it with
+// relaxed atomic adds and stores only - no locks, no syscalls - so leaving
+// the instrumentation enabled costs next to nothing. The HUD polls the
+// segment a few times per second and works out rates and averages from the
+// differences between two reads.
+//
+// Usage (C or C++, header-only; link with -lrt on glibc older than 2.34):
+//
+//   static PerfTelemetryChannel* frame_ch;
+//
+//   PerfTelemetryBus* bus = perf_telemetry_open();
+//   frame_ch = perf_telemetry_channel(bus, "dosbox.frame", PERF_KIND_DURATION);
+//   perf_telemetry_register_thread(bus, "dosbox.main");
+//
+//   uint64_t start = perf_telemetry_now_us();
+//   ... render a frame ...
+//   perf_telemetry_record(frame_ch, perf_telemetry_now_us() - start);
+//
+// All functions accept NULL buses and channels, so producers keep working
+// (and skip the telemetry) if the segment can't be opened or is full.
+//
+// Channel names are at most PERF_TELEMETRY_NAME_LEN - 1 characters, longer
+// ones are cut off.
+//
+// The header needs the GNU/POSIX extensions of glibc (clock_gettime,
+// ftruncate, syscall...). It defines _GNU_SOURCE itself, which only takes
+// effect if it's included before any system header; otherwise build with
+// -D_GNU_SOURCE (g++ always does).
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PERF_TELEMETRY_SHM_NAME "/trixie-perf-telemetry"
+
+#define PERF_TELEMETRY_MAGIC   0x4d4c4554 // 'TELM'
+#define PERF_TELEMETRY_VERSION 1
+
+#define PERF_TELEMETRY_MAX_CHANNELS 48
+#define PERF_TELEMETRY_NAME_LEN     24
+
+// Histogram bucket 0 counts zero values, bucket i (1..15) values in
+// [2^(i-1), 2^i); the last bucket also takes everything larger. For
+// microsecond durations that covers 1 us to 16 ms+ in powers of two.
+#define PERF_TELEMETRY_HIST_BUCKETS 16
+
+// Channel kinds
+#define PERF_KIND_FREE     0 // Unused slot
+#define PERF_KIND_CLAIMING 1 // Being set up by a producer
+#define PERF_KIND_DURATION 2 // Durations in microseconds, e.g. frame times
+#define PERF_KIND_GAUGE    3 // Current level, e.g. audio buffer fill in percent
+#define PERF_KIND_COUNTER  4 // Monotonic event count, e.g. underruns
+#define PERF_KIND_THREAD   5 // Thread whose CPU usage the HUD samples from /proc
+
+typedef struct {
+    uint32_t kind;                       // PERF_KIND_*
+    int32_t pid;                         // Owning process
+    int32_t tid;                         // Owning thread (PERF_KIND_THREAD)
+    uint32_t reserved;
+    char name[PERF_TELEMETRY_NAME_LEN];  // NUL-terminated, e.g. "melonds.frame"
+
+    uint64_t count;                      // Samples recorded / events counted
+    uint64_t sum;                        // Sum of the recorded values
+    uint64_t last;                       // Last recorded value
+    uint64_t max;                        // Largest value since the HUD last reset it
+    uint64_t buckets[PERF_TELEMETRY_HIST_BUCKETS];
+} __attribute__((aligned(64))) PerfTelemetryChannel;
+
+typedef struct {
+    uint32_t magic;                      // PERF_TELEMETRY_MAGIC once initialised
+    uint32_t version;                    // PERF_TELEMETRY_VERSION
+    uint32_t max_channels;               // PERF_TELEMETRY_MAX_CHANNELS
+    uint32_t channel_size;               // sizeof(PerfTelemetryChannel)
+    PerfTelemetryChannel channels[PERF_TELEMETRY_MAX_CHANNELS];
+} __attribute__((aligned(64))) PerfTelemetryBus;
+
+// Relaxed atomic helpers; the GCC/Clang builtins work in both C and C++
+#define PERF_TELEMETRY_LOAD(p)      __atomic_load_n((p), __ATOMIC_RELAXED)
+#define PERF_TELEMETRY_STORE(p, v)  __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define PERF_TELEMETRY_ADD(p, v)    __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+
+static inline uint64_t perf_telemetry_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// Maps the bus, creating the segment if it doesn't exist yet. Returns NULL
+// on failure or if the segment was created by an incompatible version.
+static inline PerfTelemetryBus* perf_telemetry_open(void)
+{
+    int fd = shm_open(PERF_TELEMETRY_SHM_NAME, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+    // Growing a new segment zero-fills it; on an existing one of the same
+    // size this does nothing
+    if (ftruncate(fd, sizeof(PerfTelemetryBus)) < 0) {
+        close(fd);
+        return NULL;
+    }
+    void* mem = mmap(NULL, sizeof(PerfTelemetryBus), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        return NULL;
+    }
+
+    PerfTelemetryBus* bus = (PerfTelemetryBus*)mem;
+
+    // The first process to get here fills in the header
+    uint32_t expected = 0;
+    if (__atomic_compare_exchange_n(&bus->magic, &expected, PERF_TELEMETRY_MAGIC,
+                                    0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        bus->max_channels = PERF_TELEMETRY_MAX_CHANNELS;
+        bus->channel_size = sizeof(PerfTelemetryChannel);
+        __atomic_store_n(&bus->version, PERF_TELEMETRY_VERSION, __ATOMIC_RELEASE);
+    } else if (expected == PERF_TELEMETRY_MAGIC) {
+        // Wait for the other process to finish the header
+        for (int i = 0; i < 1000 && !__atomic_load_n(&bus->version, __ATOMIC_ACQUIRE); ++i) {
+            usleep(100);
+        }
+    }
+
+    if (__atomic_load_n(&bus->version, __ATOMIC_ACQUIRE) != PERF_TELEMETRY_VERSION ||
+        bus->channel_size != sizeof(PerfTelemetryChannel)) {
+        munmap(mem, sizeof(PerfTelemetryBus));
+        return NULL;
+    }
+    return bus;
+}
+
+static inline void perf_telemetry_reset_channel(PerfTelemetryChannel* ch)
+{
+    PERF_TELEMETRY_STORE(&ch->count, 0);
+    PERF_TELEMETRY_STORE(&ch->sum, 0);
+    PERF_TELEMETRY_STORE(&ch->last, 0);
+    PERF_TELEMETRY_STORE(&ch->max, 0);
+    for (int i = 0; i < PERF_TELEMETRY_HIST_BUCKETS; ++i) {
+        PERF_TELEMETRY_STORE(&ch->buckets[i], 0);
+    }
+}
+
+// Returns the channel with the given name, claiming a free slot for it if
+// needed. A channel left behind by an earlier run of a producer is taken
+// over and reset. Returns NULL if the bus is NULL or full.
+static inline PerfTelemetryChannel* perf_telemetry_channel(PerfTelemetryBus* bus,
+                                                           const char* name,
+                                                           uint32_t kind)
+{
+    if (!bus || !name) {
+        return NULL;
+    }
+    const int32_t pid = (int32_t)getpid();
+
+    // Channels store the name cut off to fit, look them up the same way
+    char key[PERF_TELEMETRY_NAME_LEN];
+    memset(key, 0, sizeof(key));
+    strncpy(key, name, PERF_TELEMETRY_NAME_LEN - 1);
+
+    // Take over an existing channel with the same name
+    for (int i = 0; i < PERF_TELEMETRY_MAX_CHANNELS; ++i) {
+        PerfTelemetryChannel* ch = &bus->channels[i];
+        if (__atomic_load_n(&ch->kind, __ATOMIC_ACQUIRE) == kind &&
+            strncmp(ch->name, key, PERF_TELEMETRY_NAME_LEN) == 0) {
+            if (PERF_TELEMETRY_LOAD(&ch->pid) != pid) {
+                perf_telemetry_reset_channel(ch);
+                PERF_TELEMETRY_STORE(&ch->pid, pid);
+            }
+            return ch;
+        }
+    }
+
+    // Claim a free slot
+    for (int i = 0; i < PERF_TELEMETRY_MAX_CHANNELS; ++i) {
+        PerfTelemetryChannel* ch = &bus->channels[i];
+        uint32_t expected = PERF_KIND_FREE;
+        if (!__atomic_compare_exchange_n(&ch->kind, &expected, PERF_KIND_CLAIMING,
+                                         0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        perf_telemetry_reset_channel(ch);
+        memcpy(ch->name, key, sizeof(ch->name));
+        ch->pid = pid;
+        ch->tid = 0;
+
+        // Publish the channel once it's filled in
+        __atomic_store_n(&ch->kind, kind, __ATOMIC_RELEASE);
+        return ch;
+    }
+    return NULL;
+}
+
+// Registers the calling thread, so the HUD shows its CPU usage
+static inline PerfTelemetryChannel* perf_telemetry_register_thread(PerfTelemetryBus* bus,
+                                                                   const char* name)
+{
+    PerfTelemetryChannel* ch = perf_telemetry_channel(bus, name, PERF_KIND_THREAD);
+    if (ch) {
+        PERF_TELEMETRY_STORE(&ch->tid, (int32_t)syscall(SYS_gettid));
+    }
+    return ch;
+}
+
+static inline int perf_telemetry_bucket(uint64_t value)
+{
+    if (value == 0) {
+        return 0;
+    }
+    const int bucket = 64 - __builtin_clzll(value);
+    return bucket < PERF_TELEMETRY_HIST_BUCKETS ? bucket : PERF_TELEMETRY_HIST_BUCKETS - 1;
+}
+
+// Records a sample on a PERF_KIND_DURATION channel
+static inline void perf_telemetry_record(PerfTelemetryChannel* ch, uint64_t value)
+{
+    if (!ch) {
+        return;
+    }
+    PERF_TELEMETRY_ADD(&ch->count, 1);
+    PERF_TELEMETRY_ADD(&ch->sum, value);
+    PERF_TELEMETRY_STORE(&ch->last, value);
+    PERF_TELEMETRY_ADD(&ch->buckets[perf_telemetry_bucket(value)], 1);
+
+    uint64_t max = PERF_TELEMETRY_LOAD(&ch->max);
+    while (value > max &&
+           !__atomic_compare_exchange_n(&ch->max, &max, value, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Sets the current level of a PERF_KIND_GAUGE channel
+static inline void perf_telemetry_set(PerfTelemetryChannel* ch, uint64_t value)
+{
+    if (!ch) {
+        return;
+    }
+    PERF_TELEMETRY_STORE(&ch->last, value);
+    PERF_TELEMETRY_ADD(&ch->count, 1);
+}
+
+// Counts events on a PERF_KIND_COUNTER channel
+static inline void perf_telemetry_count(PerfTelemetryChannel* ch, uint64_t num_events)
+{
+    if (!ch) {
+        return;
+    }
+    PERF_TELEMETRY_ADD(&ch->count, num_events);
+}
+
+#endif